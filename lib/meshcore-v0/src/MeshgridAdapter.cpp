@@ -17,7 +17,7 @@ extern "C" {
 // ============================================================================
 
 MeshgridRadio::MeshgridRadio(MeshgridCallbacks* cb)
-    : callbacks(cb), in_recv_mode(true), last_rssi(0), last_snr(0) {
+    : callbacks(cb), in_recv_mode(true), last_rssi(0), last_snr(0), cad_backoff(0) {
 }
 
 void MeshgridRadio::begin() {
@@ -42,6 +42,11 @@ float MeshgridRadio::packetScore(float snr, int packet_len) {
     return (snr + 10.0f) / 20.0f;
 }
 
+int MeshgridRadio::packetScoreFixed(int snr_x4, int packet_len) {
+    // Same as packetScore() in Q10: (snr + 10) / 20 with snr = snr_x4 / 4
+    return ((snr_x4 + 40) * SCORE_FIXED_ONE) / 80;
+}
+
 bool MeshgridRadio::startSendRaw(const uint8_t* bytes, int len) {
     debug_printf(2, "[MeshCore] startSendRaw: len=%d", len);
     if (callbacks && callbacks->radio_transmit) {
@@ -70,6 +75,13 @@ bool MeshgridRadio::isInRecvMode() const {
     return in_recv_mode;
 }
 
+bool MeshgridRadio::isReceiving() {
+    // Dispatcher's LBT hook - share meshgrid's CAD/backoff so both TX paths
+    // see the same channel state and counters
+    cad_backoff = (callbacks && callbacks->channel_acquire) ? callbacks->channel_acquire() : 0;
+    return cad_backoff > 0;
+}
+
 float MeshgridRadio::getLastRSSI() const {
     return last_rssi;
 }
@@ -78,7 +90,12 @@ float MeshgridRadio::getLastSNR() const {
     return last_snr;
 }
 
-void MeshgridRadio::notifyPacketReceived(float rssi, float snr) {
+int MeshgridRadio::getLastSNRx4() const {
+    // Integer path for the Dispatcher's per-packet scoring
+    return last_snr * 4;
+}
+
+void MeshgridRadio::notifyPacketReceived(int16_t rssi, int8_t snr) {
     last_rssi = rssi;
     last_snr = snr;
 }
@@ -397,6 +414,11 @@ void MeshgridMesh::onPeerDataRecv(mesh::Packet* packet, uint8_t type, int sender
     uint8_t txt_flags = data[4] >> 2;
     const char* text = (const char*)&data[5];
 
+    // A flood that reached us carries a usable route back to the sender
+    if (packet->isRouteFlood()) {
+        learnReversePath(sender_hash, packet);
+    }
+
     // Store message via callback
     if (type == 2 && callbacks->store_direct_message) {  // PAYLOAD_TYPE_TXT_MSG
         callbacks->store_direct_message(sender_name, sender_hash, text, timestamp);
@@ -409,21 +431,73 @@ void MeshgridMesh::onPeerDataRecv(mesh::Packet* packet, uint8_t type, int sender
 
             debug_printf(0, "[MeshCore] Sending ACK back to 0x%02x, ack_hash=0x%08lx", sender_hash, ack_hash);
 
-            // Create and send ACK packet
-            mesh::Packet* ack = createAck(ack_hash);
-            if (ack) {
-                if (packet->isRouteFlood()) {
-                    // Flood mode: send ACK via flood with delay
-                    sendFlood(ack, 100);  // 100ms delay
-                } else {
-                    // Direct mode: send ACK back on reverse path
-                    sendDirect(ack, packet->path, packet->path_len, 100);
-                }
+            if (packet->isRouteFlood()) {
+                // Flood mode: return the path the message took, with the ACK attached,
+                // so the sender can reach us direct next time
+                mesh::Packet* rpath = createPathReturn(&sender_hash, secret, packet->path, packet->path_len,
+                                                       PAYLOAD_TYPE_ACK, (uint8_t*)&ack_hash, 4);
+                if (rpath) sendFlood(rpath, 100);  // 100ms delay
+            } else {
+                // Direct mode: path was consumed on the way in, route the ACK back
+                mesh::Packet* ack = createAck(ack_hash);
+                if (ack) sendRouted(ack, sender_hash, 100);
             }
         }
     }
 }
 
+bool MeshgridMesh::onPeerPathRecv(mesh::Packet* packet, int sender_idx, const uint8_t* secret,
+                                  uint8_t* path, uint8_t path_len, uint8_t extra_type,
+                                  uint8_t* extra, uint8_t extra_len) {
+    if (!callbacks) return false;
+
+    // path is the route our flood took to reach the sender - already in send order
+    uint8_t sender_hash = packet->payload[1];
+    if (callbacks->route_learn) {
+        callbacks->route_learn(sender_hash, path, path_len, packet->_snr);
+    }
+    debug_printf(0, "[MeshCore] Path to 0x%02x learned (%d hops)", sender_hash, path_len);
+
+    if (extra_type == PAYLOAD_TYPE_ACK && extra_len >= 4 && callbacks->route_ack) {
+        uint32_t ack_crc;
+        memcpy(&ack_crc, extra, 4);
+        callbacks->route_ack(ack_crc);
+    }
+
+    return true;  // send the reciprocal path back (Mesh does this for flood returns only)
+}
+
+void MeshgridMesh::onAckRecv(mesh::Packet* packet, uint32_t ack_crc) {
+    if (!callbacks || !callbacks->route_ack) return;
+
+    int dest = callbacks->route_ack(ack_crc);
+    if (dest >= 0 && packet->isRouteFlood()) {
+        // Flooded ACK from the destination: its path reversed leads back there
+        learnReversePath((uint8_t)dest, packet);
+    }
+}
+
+void MeshgridMesh::learnReversePath(uint8_t dest_hash, const mesh::Packet* packet) {
+    if (!callbacks || !callbacks->route_learn) return;
+
+    uint8_t path[MAX_PATH_SIZE];
+    for (int i = 0; i < packet->path_len; i++) {
+        path[i] = packet->path[packet->path_len - 1 - i];
+    }
+    callbacks->route_learn(dest_hash, path, packet->path_len, packet->_snr);
+}
+
+void MeshgridMesh::sendRouted(mesh::Packet* packet, uint8_t dest_hash, uint32_t delay_millis) {
+    uint8_t path[MAX_PATH_SIZE];
+    int path_len = (callbacks && callbacks->route_lookup) ? callbacks->route_lookup(dest_hash, path) : -1;
+
+    if (path_len >= 0) {
+        sendDirect(packet, path, (uint8_t)path_len, delay_millis);
+    } else {
+        sendFlood(packet, delay_millis);
+    }
+}
+
 void MeshgridMesh::onAdvertRecv(mesh::Packet* packet, const mesh::Identity& id,
                                 uint32_t timestamp, const uint8_t* app_data, size_t app_data_len) {
     static uint32_t advert_recv_count = 0;
@@ -455,7 +529,15 @@ void MeshgridMesh::onAdvertRecv(mesh::Packet* packet, const mesh::Identity& id,
         debug_printf(1, "[MeshCore] app_data[%d]: %s", app_data_len, hex_dump);
 
         // Skip optional fields based on flags and extract feat1 for v1 detection
-        if (flags & 0x10) i += 8;  // ADV_LATLON_MASK - lat/lon (8 bytes)
+        if (flags & 0x10) {  // ADV_LATLON_MASK - lat/lon (2 x int32 LE, degrees x 1e6)
+            if (i + 8 <= app_data_len && callbacks->update_position) {
+                int32_t lat, lon;
+                memcpy(&lat, &app_data[i], 4);
+                memcpy(&lon, &app_data[i + 4], 4);
+                callbacks->update_position(id.pub_key[0], lat, lon, packet->path_len);
+            }
+            i += 8;
+        }
 
         // Check feat1 field for v1 capability (replaces old 0x08 bit check)
         if (flags & 0x20) {  // ADV_FEAT1_MASK - feature 1 (2 bytes)
@@ -486,6 +568,10 @@ void MeshgridMesh::onAdvertRecv(mesh::Packet* packet, const mesh::Identity& id,
     // Calculate hops from path length
     uint8_t hops = packet->path_len;
 
+    if (packet->isRouteFlood()) {
+        learnReversePath(id.pub_key[0], packet);
+    }
+
     // Update neighbor table
     // Get actual RSSI/SNR from radio adapter
     int16_t rssi = radio_adapter ? (int16_t)radio_adapter->getLastRSSI() : -120;
@@ -549,9 +635,17 @@ void MeshgridMesh::onGroupDataRecv(mesh::Packet* packet, uint8_t type,
 }
 
 bool MeshgridMesh::allowPacketForward(const mesh::Packet* packet) {
-    // Only forward if device mode is REPEATER
-    // This should be configurable via callbacks
-    return false;  // Default: don't forward
+    // The firmware's forwarding engine (process_packet -> forward_packet) is the
+    // single relay path for v0 and v1 traffic - relaying here would send twice
+    return false;
+}
+
+uint32_t MeshgridMesh::getCADFailRetryDelay() const {
+    // Randomized exponential backoff computed by the LBT channel check
+    if (radio_adapter && radio_adapter->getCADBackoff() > 0) {
+        return radio_adapter->getCADBackoff();
+    }
+    return mesh::Mesh::getCADFailRetryDelay();
 }
 
 void MeshgridMesh::logTx(mesh::Packet* packet, int len) {
@@ -568,12 +662,17 @@ void MeshgridMesh::logRx(mesh::Packet* packet, int len, float score) {
     }
 }
 
-void MeshgridMesh::sendTextMessage(uint8_t dest_hash, const char* text) {
+void MeshgridMesh::logRxFixed(mesh::Packet* packet, int len, int score_q10) {
+    // The score is unused here - skip the default hook's float conversion
+    logRx(packet, len, 0);
+}
+
+int MeshgridMesh::sendTextMessage(uint8_t dest_hash, const char* text) {
     // Find neighbor to get shared secret
-    if (!callbacks || !callbacks->get_shared_secret) return;
+    if (!callbacks || !callbacks->get_shared_secret) return MESHGRID_SEND_FAILED;
 
     const uint8_t* secret = callbacks->get_shared_secret(dest_hash);
-    if (!secret) return;
+    if (!secret) return MESHGRID_SEND_FAILED;
 
     // Build identity for destination (just hash for now)
     mesh::Identity dest;
@@ -596,14 +695,34 @@ void MeshgridMesh::sendTextMessage(uint8_t dest_hash, const char* text) {
     memcpy(&data[i], text, text_len);
     i += text_len;
 
+    // ACK the destination will return (same hash MeshCore computes on receive)
+    uint32_t ack_crc;
+    mesh::Utils::sha256((uint8_t*)&ack_crc, 4, data, i, self_id.pub_key, PUB_KEY_SIZE);
+
+    // Direct on a learned route, flood otherwise (the PATH return teaches us one)
+    uint8_t path[MAX_PATH_SIZE];
+    int path_len = callbacks->route_lookup ? callbacks->route_lookup(dest_hash, path) : -1;
+    if (path_len < 0 && callbacks->dest_unreachable && callbacks->dest_unreachable(dest_hash)) {
+        // No neighbor's filter has it - a flood would cost every repeater airtime for nothing
+        return MESHGRID_SEND_UNREACHABLE;
+    }
+
     // Create packet
     mesh::Packet* pkt = createDatagram(2, dest, secret, data, i);
-    if (pkt) {
-        sendFlood(pkt, (uint32_t)0);
+    if (!pkt) return MESHGRID_SEND_FAILED;
 
-        if (callbacks->increment_tx) callbacks->increment_tx();
-        if (callbacks->led_blink) callbacks->led_blink();
+    if (path_len >= 0) {
+        sendDirect(pkt, path, (uint8_t)path_len);
+    } else {
+        sendFlood(pkt, (uint32_t)0);
+    }
+    if (callbacks->route_expect_ack) {
+        callbacks->route_expect_ack(dest_hash, ack_crc, path, path_len);
     }
+
+    if (callbacks->increment_tx) callbacks->increment_tx();
+    if (callbacks->led_blink) callbacks->led_blink();
+    return MESHGRID_SEND_OK;
 }
 
 void MeshgridMesh::sendChannelMessage(uint8_t channel_hash, const uint8_t* channel_secret,
@@ -16,7 +16,11 @@
 
 // Forward declarations for meshgrid types
 struct meshgrid_neighbor;
-struct message_entry;
+
+// MeshgridMesh::sendTextMessage() results
+#define MESHGRID_SEND_OK 0
+#define MESHGRID_SEND_FAILED (-1)      // No shared secret or no free packet
+#define MESHGRID_SEND_UNREACHABLE (-2) // No route and no neighbor's filter has the destination - not flooded
 
 /**
  * Callback structure for meshgrid integration
@@ -45,6 +49,7 @@ struct MeshgridCallbacks {
     // Radio control
     int16_t (*radio_transmit)(uint8_t* data, size_t len);
     int16_t (*radio_start_receive)(void);
+    uint32_t (*channel_acquire)(void);  // LBT: 0 = clear to send, else backoff ms
 
     // LED/UI feedback
     void (*led_blink)(void);
@@ -52,6 +57,18 @@ struct MeshgridCallbacks {
     // Stats
     void (*increment_tx)(void);
     void (*increment_rx)(void);
+
+    // Route cache: paths are in send order (first hop first)
+    void (*route_learn)(uint8_t dest_hash, const uint8_t* path, uint8_t path_len, int8_t snr_x4);
+    int (*route_lookup)(uint8_t dest_hash, uint8_t* path);  // path length, or -1 = flood
+    void (*route_expect_ack)(uint8_t dest_hash, uint32_t ack_crc, const uint8_t* path, int path_len);
+    int (*route_ack)(uint32_t ack_crc);  // confirmed destination, or -1
+
+    // Reachability: true only when no neighbor can reach dest at any distance
+    bool (*dest_unreachable)(uint8_t dest_hash);
+
+    // Advertised position (ADV_LATLON, degrees x 1e6) of a verified advert
+    void (*update_position)(uint8_t hash, int32_t lat_e6, int32_t lon_e6, uint8_t hops);
 };
 
 /**
@@ -62,8 +79,9 @@ class MeshgridRadio : public mesh::Radio {
 private:
     MeshgridCallbacks* callbacks;
     bool in_recv_mode;
-    float last_rssi;
-    float last_snr;
+    int16_t last_rssi;
+    int8_t last_snr; /* Whole dB, as reported by meshgrid's RX path */
+    uint32_t cad_backoff;
 
 public:
     MeshgridRadio(MeshgridCallbacks* cb);
@@ -72,15 +90,21 @@ public:
     int recvRaw(uint8_t* bytes, int sz) override;
     uint32_t getEstAirtimeFor(int len_bytes) override;
     float packetScore(float snr, int packet_len) override;
+    int packetScoreFixed(int snr_x4, int packet_len) override;
     bool startSendRaw(const uint8_t* bytes, int len) override;
     bool isSendComplete() override;
     void onSendFinished() override;
     bool isInRecvMode() const override;
+    bool isReceiving() override;
     float getLastRSSI() const override;
     float getLastSNR() const override;
+    int getLastSNRx4() const override;
 
     // Called by meshgrid when packet received
-    void notifyPacketReceived(float rssi, float snr);
+    void notifyPacketReceived(int16_t rssi, int8_t snr);
+
+    // Backoff chosen by the last busy channel check
+    uint32_t getCADBackoff() const { return cad_backoff; }
 };
 
 /**
@@ -184,6 +208,11 @@ private:
     MeshgridRadio* radio_adapter;  // For accessing RSSI/SNR
     uint8_t last_searched_hash;     // Track hash from searchPeersByHash for getPeerSharedSecret
 
+    // Learn the reversed path of a received flood as a route back to its source
+    void learnReversePath(uint8_t dest_hash, const mesh::Packet* packet);
+    // Send direct on a cached route, else flood
+    void sendRouted(mesh::Packet* packet, uint8_t dest_hash, uint32_t delay_millis);
+
 protected:
     // Implement virtual methods from mesh::Mesh
     int searchPeersByHash(const uint8_t* hash) override;
@@ -195,11 +224,17 @@ protected:
     int searchChannelsByHash(const uint8_t* hash, mesh::GroupChannel channels[], int max_matches) override;
     void onGroupDataRecv(mesh::Packet* packet, uint8_t type,
                         const mesh::GroupChannel& channel, uint8_t* data, size_t len) override;
+    bool onPeerPathRecv(mesh::Packet* packet, int sender_idx, const uint8_t* secret,
+                       uint8_t* path, uint8_t path_len, uint8_t extra_type,
+                       uint8_t* extra, uint8_t extra_len) override;
+    void onAckRecv(mesh::Packet* packet, uint32_t ack_crc) override;
     bool allowPacketForward(const mesh::Packet* packet) override;
+    uint32_t getCADFailRetryDelay() const override;
 
     // Override from mesh::Dispatcher to track TX/RX
     void logTx(mesh::Packet* packet, int len) override;
     void logRx(mesh::Packet* packet, int len, float score) override;
+    void logRxFixed(mesh::Packet* packet, int len, int score_q10) override;
 
 public:
     MeshgridMesh(mesh::Radio& radio, mesh::MillisecondClock& ms, mesh::RNG& rng,
@@ -207,7 +242,7 @@ public:
                  MeshgridCallbacks* cb, MeshgridRadio* radio_adpt = nullptr);
 
     // Helper methods for meshgrid firmware
-    void sendTextMessage(uint8_t dest_hash, const char* text);
+    int sendTextMessage(uint8_t dest_hash, const char* text); // MESHGRID_SEND_*
     void sendChannelMessage(uint8_t channel_hash, const uint8_t* channel_secret,
                            const char* text, const char* channel_name);
     void sendAdvert();
@@ -238,6 +238,17 @@ uint8_t meshgrid_bloom_count_level(
     return (uint8_t)n;
 }
 
+uint8_t meshgrid_bloom_fill_level(
+    const struct meshgrid_bloom_set *bloom,
+    uint8_t level
+) {
+    const uint8_t *array = get_level_ptr_const(bloom, level);
+    if (array == NULL) {
+        return 0;
+    }
+    return popcount_64(array);
+}
+
 uint16_t meshgrid_bloom_count_total(const struct meshgrid_bloom_set *bloom) {
     uint16_t total = 0;
     for (uint8_t level = 0; level < MESHGRID_BLOOM_LEVELS; level++) {
@@ -195,6 +195,23 @@ uint8_t meshgrid_bloom_count_level(
     uint8_t level
 );
 
+/**
+ * Number of set bits in a bloom filter level
+ *
+ * Cheaper than the node estimate (no logf) and the direct measure of
+ * saturation: with 2 hash functions the false-positive rate is
+ * (bits / 64)^2.
+ *
+ * @param bloom  Bloom filter set
+ * @param level  Level to count (0-3)
+ *
+ * @return Set bits (0-64), 0 for an invalid level
+ */
+uint8_t meshgrid_bloom_fill_level(
+    const struct meshgrid_bloom_set *bloom,
+    uint8_t level
+);
+
 /**
  * Count total approximate nodes across all levels
  *
@@ -91,6 +91,11 @@ void meshgrid_trickle_reset(struct meshgrid_trickle *trickle, uint32_t now) {
         return;
     }
 
+    /* Already at Imin: restarting would only push the beacon back (RFC 6206 4.2) */
+    if (trickle->interval_current == trickle->interval_min) {
+        return;
+    }
+
     /* Reset to minimum interval */
     trickle->interval_current = trickle->interval_min;
     start_interval(trickle, now);
@@ -1,9 +1,15 @@
 #include "gossip.h"
-#include <stdlib.h>
 #include <string.h>
 
-void meshgrid_ota_gossip_init(struct meshgrid_ota_gossip_state *state,
-                               uint32_t session_id, uint32_t total_chunks) {
+bool meshgrid_ota_gossip_init(struct meshgrid_ota_gossip_state *state,
+                              uint32_t session_id, uint32_t total_chunks,
+                              uint8_t *bitmap, uint32_t bitmap_size) {
+    state->active = false;
+    state->chunk_bitmap = NULL;
+    if (!bitmap || bitmap_size < MESHGRID_OTA_BITMAP_BYTES(total_chunks)) {
+        return false;
+    }
+
     state->session_id = session_id;
     state->total_chunks = total_chunks;
     state->chunks_received = 0;
@@ -11,16 +17,15 @@ void meshgrid_ota_gossip_init(struct meshgrid_ota_gossip_state *state,
     state->last_request_time = 0;
     state->active = true;
     
-    /* Allocate bitmap (1 bit per chunk) */
-    uint32_t bitmap_bytes = (total_chunks + 7) / 8;
-    state->chunk_bitmap = (uint8_t*)calloc(bitmap_bytes, 1);
+    /* Bitmap (1 bit per chunk) lives in the caller's buffer */
+    state->chunk_bitmap = bitmap;
+    memset(bitmap, 0, MESHGRID_OTA_BITMAP_BYTES(total_chunks));
+    return true;
 }
 
 void meshgrid_ota_gossip_free(struct meshgrid_ota_gossip_state *state) {
-    if (state->chunk_bitmap) {
-        free(state->chunk_bitmap);
-        state->chunk_bitmap = NULL;
-    }
+    /* The bitmap belongs to the caller */
+    state->chunk_bitmap = NULL;
     state->active = false;
 }
 
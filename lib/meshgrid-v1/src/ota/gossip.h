@@ -26,7 +26,7 @@ extern "C" {
 /* Gossip state for OTA session */
 struct meshgrid_ota_gossip_state {
     uint32_t session_id;
-    uint8_t *chunk_bitmap;         /* Bitmap of received chunks (dynamically allocated) */
+    uint8_t *chunk_bitmap;         /* Bitmap of received chunks (caller's buffer) */
     uint32_t chunks_received;
     uint32_t total_chunks;
     uint32_t last_status_broadcast;
@@ -34,8 +34,14 @@ struct meshgrid_ota_gossip_state {
     bool active;
 };
 
-void meshgrid_ota_gossip_init(struct meshgrid_ota_gossip_state *state,
-                               uint32_t session_id, uint32_t total_chunks);
+/* Bitmap bytes a session of total_chunks needs */
+#define MESHGRID_OTA_BITMAP_BYTES(total_chunks) (((total_chunks) + 7) / 8)
+
+/* Start a session tracking chunks in bitmap (no allocation - firmware
+ * passes a buffer from its boot arena); false if bitmap is too small */
+bool meshgrid_ota_gossip_init(struct meshgrid_ota_gossip_state *state,
+                              uint32_t session_id, uint32_t total_chunks,
+                              uint8_t *bitmap, uint32_t bitmap_size);
 void meshgrid_ota_gossip_free(struct meshgrid_ota_gossip_state *state);
 bool meshgrid_ota_gossip_should_broadcast_status(
     struct meshgrid_ota_gossip_state *state, uint32_t now);
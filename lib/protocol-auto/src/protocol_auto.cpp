@@ -8,7 +8,7 @@
 
 // Use C bridge to avoid namespace conflicts
 extern "C" {
-    void meshcore_bridge_send_text(uint8_t dest_hash, const char* text);
+    int meshcore_bridge_send_text(uint8_t dest_hash, const char* text);
     void meshcore_bridge_send_channel(uint8_t channel_hash, const uint8_t* channel_secret,
                                       const char* text, const char* channel_name);
 }
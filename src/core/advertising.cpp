@@ -7,27 +7,79 @@
 
 extern "C" {
 #include "network/protocol.h"
+#include "network/reachability.h"
+#include "network/mpr.h"
+#include "../../lib/meshgrid-v1/src/discovery/trickle.h"
 }
 
 #include "messaging.h"
 
 /* Advertisement intervals (from protocol.h) */
-#define MESHGRID_LOCAL_ADVERT_MS (2 * 60 * 1000)          /* 2 minutes */
 #define MESHGRID_ADVERT_INTERVAL_MS (12 * 60 * 60 * 1000) /* 12 hours */
 
+/* Longest gap between local adverts, suppressed or not - neighbors prune
+ * entries after MESHGRID_NEIGHBOR_TIMEOUT_MS without one */
+#define MESHGRID_LOCAL_ADVERT_MAX_GAP_MS (MESHGRID_NEIGHBOR_TIMEOUT_MS * 2 / 3)
+
+static struct meshgrid_trickle local_trickle;
+static struct advert_stats stats;
+static uint32_t last_local_advert = 0;
+
 void advertising_process(void) {
     static uint32_t last_advert = 0;
-    static uint32_t last_local_advert = 0;
+    uint32_t now = millis();
+
+    if (!meshgrid_trickle_is_active(&local_trickle)) {
+        meshgrid_trickle_init(&local_trickle);
+        meshgrid_trickle_start(&local_trickle, now);
+        last_local_advert = now;
+    }
+
+    /* Neighbors must learn a new relay set quickly - they stop relaying on the old one */
+    if (mpr_tick(now)) {
+        advertising_topology_changed();
+    }
+
+    /* Local advertisement - ROUTE_DIRECT for nearby discovery, paced by Trickle */
+    uint32_t interval_start = local_trickle.interval_start;
+    bool suppressed = meshgrid_trickle_is_suppressed(&local_trickle);
+    meshgrid_trickle_update(&local_trickle, now);
+
+    if (local_trickle.interval_start != interval_start && suppressed) {
+        /* Interval ended with our advert covered by k consistent neighbors */
+        stats.local_suppressed++;
+    }
 
-    /* Local advertisement (every 2 minutes) - ROUTE_DIRECT for nearby discovery */
-    if (millis() - last_local_advert > MESHGRID_LOCAL_ADVERT_MS) {
+    if (meshgrid_trickle_should_beacon(&local_trickle, now) ||
+        now - last_local_advert >= MESHGRID_LOCAL_ADVERT_MAX_GAP_MS) {
         send_advertisement(ROUTE_DIRECT); /* Zero-hop, neighbors only */
-        last_local_advert = millis();
+        meshgrid_trickle_beacon_sent(&local_trickle);
+        last_local_advert = now;
+        stats.local_sent++;
     }
 
     /* Flood advertisement (every 12 hours) - ROUTE_FLOOD for network-wide presence */
-    if (millis() - last_advert > MESHGRID_ADVERT_INTERVAL_MS) {
+    if (now - last_advert > MESHGRID_ADVERT_INTERVAL_MS) {
         send_advertisement(ROUTE_FLOOD); /* Network-wide */
-        last_advert = millis();
+        last_advert = now;
     }
+
+    /* Age departed nodes out of the reachability filter */
+    reach_tick(now);
+}
+
+void advertising_topology_changed(void) {
+    if (meshgrid_trickle_get_interval(&local_trickle) != local_trickle.interval_min) {
+        stats.resets++;
+    }
+    meshgrid_trickle_reset(&local_trickle, millis());
+}
+
+void advertising_heard_consistent(void) {
+    meshgrid_trickle_heard_beacon(&local_trickle, true);
+}
+
+const struct advert_stats* advertising_get_stats(void) {
+    stats.interval_ms = meshgrid_trickle_get_interval(&local_trickle);
+    return &stats;
 }
@@ -5,14 +5,33 @@
 #ifndef MESHGRID_ADVERTISING_H
 #define MESHGRID_ADVERTISING_H
 
+#include <stdint.h>
+
+/* Local advert scheduling counters */
+struct advert_stats {
+    uint32_t local_sent;
+    uint32_t local_suppressed; /* Trickle intervals skipped (k consistent adverts heard) */
+    uint32_t resets;           /* Topology changes that restarted fast advertising */
+    uint32_t interval_ms;      /* Current Trickle interval */
+};
+
 /**
  * Process periodic advertisement sending
  * Should be called every loop iteration
  *
  * Sends two types of advertisements:
- * - Local (ROUTE_DIRECT): Every 2 minutes, neighbors only
+ * - Local (ROUTE_DIRECT): Trickle-paced, 30 s after a topology change
+ *   doubling up to 10 min while the neighborhood is stable
  * - Flood (ROUTE_FLOOD): Every 12 hours, network-wide
  */
 void advertising_process(void);
 
+/* A direct neighbor appeared or was lost - advertise fast again */
+void advertising_topology_changed(void);
+
+/* Heard a local advert consistent with our view (known direct neighbor) */
+void advertising_heard_consistent(void);
+
+const struct advert_stats* advertising_get_stats(void);
+
 #endif // MESHGRID_ADVERTISING_H
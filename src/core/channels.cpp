@@ -10,6 +10,8 @@
 #endif
 #include "utils/memory.h"
 #include "utils/types.h"
+#include "config_store.h"
+#include <stddef.h>
 
 extern "C" {
 #include "hardware/crypto/crypto.h"
@@ -19,77 +21,108 @@ extern "C" {
 extern struct channel_entry custom_channels[MAX_CUSTOM_CHANNELS];
 extern int custom_channel_count;
 
-void channels_save_to_nvs(void) {
-#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
-    Preferences prefs;
-    prefs.begin("channels", false); // Read-write
+/* Serialized channels on their way to or from the config store (too big for the stack) */
+static struct config_channels image;
 
-    /* Count valid channels */
-    uint8_t saved_count = 0;
+void channels_save_to_nvs(void) {
+    /* Valid channels only, packed - the store keeps count entries */
+    memset(&image, 0, sizeof(image));
     for (int i = 0; i < custom_channel_count && i < MAX_CUSTOM_CHANNELS; i++) {
         if (custom_channels[i].valid) {
-            char key[16];
-            snprintf(key, sizeof(key), "c%d_hash", saved_count);
-            prefs.putUChar(key, custom_channels[i].hash);
-
-            snprintf(key, sizeof(key), "c%d_name", saved_count);
-            prefs.putString(key, custom_channels[i].name);
-
-            snprintf(key, sizeof(key), "c%d_secret", saved_count);
-            prefs.putBytes(key, custom_channels[i].secret, 32);
-
-            saved_count++;
+            struct config_channel* e = &image.entries[image.count++];
+            e->hash = custom_channels[i].hash;
+            strncpy(e->name, custom_channels[i].name, 16);
+            memcpy(e->secret, custom_channels[i].secret, 32);
         }
     }
 
-    prefs.putUChar("count", saved_count);
-    prefs.end();
-
-    DEBUG_INFOF("Saved %d channels to NVS", saved_count);
-#else
-    DEBUG_INFO("NVS not available on this platform");
-#endif
+    config_store_put(CONFIG_SECTION_CHANNELS, &image,
+                     offsetof(struct config_channels, entries) + image.count * sizeof(struct config_channel));
 }
 
-void channels_load_from_nvs(void) {
+/* Channels from the per-key layout (namespace "channels"); false if it holds none */
+static bool legacy_load(void) {
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
     Preferences prefs;
-    prefs.begin("channels", true); // Read-only
+    if (!prefs.begin("channels", true)) { // Read-only
+        return false;
+    }
 
     uint8_t saved_count = prefs.getUChar("count", 0);
     if (saved_count > MAX_CUSTOM_CHANNELS)
         saved_count = MAX_CUSTOM_CHANNELS;
 
-    custom_channel_count = 0;
     for (uint8_t i = 0; i < saved_count; i++) {
-        if (custom_channel_count >= MAX_CUSTOM_CHANNELS)
-            break;
-
-        struct channel_entry* ch = &custom_channels[custom_channel_count];
+        struct config_channel* e = &image.entries[image.count];
 
         char key[16];
         snprintf(key, sizeof(key), "c%d_hash", i);
-        ch->hash = prefs.getUChar(key, 0);
-        if (ch->hash == 0)
+        e->hash = prefs.getUChar(key, 0);
+        if (e->hash == 0)
             continue;
 
         snprintf(key, sizeof(key), "c%d_name", i);
         String name = prefs.getString(key, "");
         if (name.length() == 0)
             continue;
-        strncpy(ch->name, name.c_str(), 16);
-        ch->name[16] = '\0';
+        strncpy(e->name, name.c_str(), 16);
+        e->name[16] = '\0';
 
         snprintf(key, sizeof(key), "c%d_secret", i);
-        if (prefs.getBytes(key, ch->secret, 32) != 32)
+        if (prefs.getBytes(key, e->secret, 32) != 32)
             continue;
 
+        image.count++;
+    }
+
+    bool found = prefs.isKey("count");
+    prefs.end();
+    return found;
+#else
+    return false;
+#endif
+}
+
+/* Move the per-key channels into the config store, then drop the namespace */
+static void legacy_migrate(void) {
+    config_store_put(CONFIG_SECTION_CHANNELS, &image,
+                     offsetof(struct config_channels, entries) + image.count * sizeof(struct config_channel));
+    if (!config_store_commit(CONFIG_SECTION_CHANNELS)) {
+        return; /* Keys stay - tried again next boot */
+    }
+#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
+    Preferences prefs;
+    prefs.begin("channels", false); // Read-write
+    prefs.clear();
+    prefs.end();
+#endif
+    config_store_note_migrated(CONFIG_SECTION_CHANNELS);
+}
+
+void channels_load_from_nvs(void) {
+    memset(&image, 0, sizeof(image));
+    uint16_t len = config_store_get(CONFIG_SECTION_CHANNELS, &image, sizeof(image));
+    if (len == 0) {
+        if (!legacy_load()) {
+            return;
+        }
+        legacy_migrate();
+    } else if (len != offsetof(struct config_channels, entries) + image.count * sizeof(struct config_channel)) {
+        DEBUG_WARN("Stored channels truncated, ignoring");
+        return;
+    }
+
+    custom_channel_count = 0;
+    for (uint8_t i = 0; i < image.count && custom_channel_count < MAX_CUSTOM_CHANNELS; i++) {
+        const struct config_channel* e = &image.entries[i];
+        struct channel_entry* ch = &custom_channels[custom_channel_count];
+        ch->hash = e->hash;
+        memcpy(ch->name, e->name, 16);
+        ch->name[16] = '\0';
+        memcpy(ch->secret, e->secret, 32);
         ch->valid = true;
         custom_channel_count++;
 
         DEBUG_INFOF("Restored channel: %s (0x%02x)", ch->name, ch->hash);
     }
-
-    prefs.end();
-#endif
 }
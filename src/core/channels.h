@@ -5,10 +5,10 @@
 #ifndef MESHGRID_CHANNELS_H
 #define MESHGRID_CHANNELS_H
 
-/* Save custom channels to NVS */
+/* Save custom channels - committed to NVS by config_store_loop() */
 void channels_save_to_nvs(void);
 
-/* Load custom channels from NVS on boot */
+/* Load custom channels on boot (migrating the per-key layout) */
 void channels_load_from_nvs(void);
 
 #endif /* MESHGRID_CHANNELS_H */
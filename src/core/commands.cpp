@@ -21,6 +21,7 @@
 static uint8_t cobs_rx_buf[512];
 static size_t cobs_rx_len = 0;
 static uint8_t cobs_decode_buf[256];
+static String cmd_line; /* Reserved once - assigning a command reuses its buffer */
 
 /* Forward declarations */
 static void process_command(const String& cmd);
@@ -28,6 +29,7 @@ static void process_command(const String& cmd);
 void serial_commands_init(void) {
     /* Clear any garbage from serial buffer on boot */
     cobs_rx_len = 0;
+    cmd_line.reserve(sizeof(cobs_decode_buf));
     while (serial_bridge_available()) {
         serial_bridge_read();
     }
@@ -48,10 +50,10 @@ void handle_serial(void) {
 
                 if (decoded_len > 0 && decoded_len < sizeof(cobs_decode_buf)) {
                     cobs_decode_buf[decoded_len] = '\0';
-                    String cmd((char*)cobs_decode_buf);
-                    cmd.trim();
-                    if (cmd.length() > 0) {
-                        process_command(cmd);
+                    cmd_line = (char*)cobs_decode_buf;
+                    cmd_line.trim();
+                    if (cmd_line.length() > 0) {
+                        process_command(cmd_line);
                     }
                 }
             }
@@ -136,6 +138,8 @@ static void process_command(const String& cmd) {
         cmd_messages();
     } else if (cmd == "MESSAGES CLEAR") {
         cmd_messages_clear();
+    } else if (cmd.startsWith("MESSAGES PAGE ")) {
+        cmd_messages_page(cmd.substring(14));
 
         /* === CHANNEL COMMANDS === */
     } else if (cmd == "CHANNELS") {
@@ -172,6 +176,18 @@ static void process_command(const String& cmd) {
     } else if (cmd.startsWith("SET PREAMBLE ")) {
         int preamble = cmd.substring(13).toInt();
         cmd_set_preamble(preamble);
+    } else if (cmd.startsWith("SET REGION ")) {
+        String region = cmd.substring(11);
+        region.trim();
+        cmd_set_region(region);
+    } else if (cmd.startsWith("SET FORWARD ")) {
+        String policy = cmd.substring(12);
+        policy.trim();
+        cmd_set_forward(policy);
+    } else if (cmd.startsWith("SET POSITION ")) {
+        String position = cmd.substring(13);
+        position.trim();
+        cmd_set_position(position);
     } else if (cmd == "SET PRESET EU_NARROW" || cmd == "SET PRESET EU") {
         cmd_set_preset("EU");
     } else if (cmd == "SET PRESET US_STANDARD" || cmd == "SET PRESET US") {
@@ -5,14 +5,17 @@
 #include "config_commands.h"
 #include "common.h"
 #include "radio/radio_hal.h"
+#include "radio/radio_task.h"
 #include "utils/types.h"
+#include "core/config_store.h"
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
-#    include <Preferences.h>
 #    include <Esp.h>
 #endif
 
 extern "C" {
 #include "network/protocol.h"
+#include "radio/duty_cycle.h"
+#include "network/geo.h"
 }
 
 extern struct meshgrid_state mesh;
@@ -26,21 +29,19 @@ extern struct radio_config_t {
     bool config_saved;
 } radio_config;
 
-#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
-extern Preferences prefs;
-#endif
 extern void config_save(void);
 
 void cmd_config_save() {
     config_save();
+    config_store_commit(CONFIG_SECTION_SETTINGS);
     response_println("OK Config saved to flash");
 }
 
 void cmd_config_reset() {
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
-    prefs.begin("meshgrid", false);
-    prefs.clear();
-    prefs.end();
+    config_store_erase(CONFIG_SECTION_SETTINGS);
+    config_store_erase(CONFIG_SECTION_IDENTITY);
+    config_store_flush(); /* Channels joined in the last few seconds */
     response_println("OK Config cleared, rebooting...");
     delay(100);
     ESP.restart();
@@ -192,3 +193,79 @@ void cmd_set_preset(const String& preset) {
         response_println("ERR Unknown preset");
     }
 }
+
+void cmd_set_region(const String& region) {
+    int parsed = duty_cycle_region_parse(region.c_str());
+    if (parsed < 0) {
+        response_println("ERR Region must be EU868, EU433, US915, NONE or AUTO");
+        return;
+    }
+    radio_lock();
+    duty_cycle_set_region((enum duty_region)parsed);
+    enum duty_region effective = duty_cycle_effective_region(radio_config.frequency);
+    radio_unlock();
+    config_save();
+    response_print("OK Region ");
+    response_print(duty_cycle_region_name((enum duty_region)parsed));
+    response_print(" (");
+    response_print(duty_cycle_region_name(effective));
+    response_println(" at current frequency)");
+}
+
+void cmd_set_forward(const String& policy) {
+    int parsed = meshgrid_forward_policy_parse(policy.c_str());
+    if (parsed < 0) {
+        response_println("ERR Forward policy must be FLOOD, BLOOM, STRICT, MPR or GEO");
+        return;
+    }
+    meshgrid_set_forward_policy((enum meshgrid_forward_policy)parsed);
+    config_save();
+    response_print("OK Forward ");
+    response_println(meshgrid_forward_policy_name((enum meshgrid_forward_policy)parsed));
+}
+
+/* Decimal degrees; false unless the whole token is a number */
+static bool parse_degrees(const String& token, double* out) {
+    const char* s = token.c_str();
+    char* end;
+    *out = strtod(s, &end);
+    while (*end == ' ') {
+        end++;
+    }
+    return end != s && *end == '\0';
+}
+
+void cmd_set_position(const String& position) {
+    struct meshgrid_position pos = {0, 0, false};
+
+    if (position != "NONE") {
+        int space = position.indexOf(' ');
+        if (space < 0) {
+            response_println("ERR Usage: SET POSITION <lat> <lon> | NONE");
+            return;
+        }
+        double lat, lon;
+        if (!parse_degrees(position.substring(0, space), &lat) || !parse_degrees(position.substring(space + 1), &lon)) {
+            response_println("ERR Usage: SET POSITION <lat> <lon> | NONE");
+            return;
+        }
+        /* Negated so NaN fails too */
+        if (!(lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0) || (lat == 0.0 && lon == 0.0)) {
+            response_println("ERR Position must be <lat -90..90> <lon -180..180>");
+            return;
+        }
+        pos.lat_e6 = (int32_t)(lat * 1e6 + (lat < 0 ? -0.5 : 0.5));
+        pos.lon_e6 = (int32_t)(lon * 1e6 + (lon < 0 ? -0.5 : 0.5));
+        pos.valid = true;
+    }
+
+    geo_set_self(&pos);
+    config_save();
+    if (!pos.valid) {
+        response_println("OK Position cleared");
+        return;
+    }
+    char reply[48];
+    snprintf(reply, sizeof(reply), "OK Position %.6f %.6f", pos.lat_e6 / 1e6, pos.lon_e6 / 1e6);
+    response_println(reply);
+}
@@ -22,6 +22,9 @@ void cmd_set_cr(int cr);
 void cmd_set_power(int power);
 void cmd_set_preamble(int preamble);
 void cmd_set_preset(const String& preset);
+void cmd_set_region(const String& region);
+void cmd_set_forward(const String& policy);
+void cmd_set_position(const String& position);
 
 #ifdef __cplusplus
 }
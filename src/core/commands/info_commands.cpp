@@ -5,8 +5,18 @@
 #include "info_commands.h"
 #include "common.h"
 #include "core/neighbors.h"
+#include "core/node_dir.h"
+#include "core/config_store.h"
+#include "core/messaging.h"
+#include "core/messaging/forward.h"
+#include "core/messaging/inbox.h"
+#include "core/messaging/msg_log.h"
+#include "utils/arena.h"
+#include "utils/boot_profile.h"
+#include "core/advertising.h"
 #include "hardware/board.h"
 #include "utils/constants.h"
+#include "utils/role.h"
 #include "version.h"
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
 #    include <Preferences.h>
@@ -14,6 +24,15 @@
 
 extern "C" {
 #include "hardware/telemetry/telemetry.h"
+#include "radio/radio_lbt.h"
+#include "radio/duty_cycle.h"
+#include "radio/rx_fifo.h"
+#include "radio/radio_task.h"
+#include "radio/radio_health.h"
+#include "network/route_cache.h"
+#include "network/reachability.h"
+#include "network/mpr.h"
+#include "network/geo.h"
 }
 
 extern struct meshgrid_state mesh;
@@ -31,10 +50,38 @@ extern struct radio_config_t {
 extern const struct board_config* board;
 extern struct telemetry_data telemetry; /* Defined in hardware/telemetry/telemetry.h */
 extern volatile uint32_t isr_trigger_count;
+extern volatile uint32_t radio_irq_overruns;
 extern uint32_t stat_duplicates;
 extern uint32_t stat_clients, stat_repeaters, stat_rooms;
 extern uint32_t get_uptime_secs(void);
 
+/*
+ * Duty-cycle budget fields shared by STATS and TELEMETRY
+ * Budget/remaining are null when the region has no duty-cycle limit
+ */
+static void print_duty_cycle_fields() {
+    /* Read the ledger under the radio lock, print after releasing it */
+    radio_lock();
+    uint32_t budget = duty_cycle_budget_ms(radio_config.frequency);
+    uint32_t remaining = duty_cycle_remaining_ms(radio_config.frequency, millis());
+    enum duty_region region = duty_cycle_effective_region(radio_config.frequency);
+    uint16_t permille = duty_cycle_limit_permille(radio_config.frequency);
+    radio_unlock();
+
+    response_print("\"region\":\"");
+    response_print(duty_cycle_region_name(region));
+    response_print("\",\"limit_pct\":");
+    response_print(permille / 10.0f, 1);
+    if (budget == DUTY_UNLIMITED) {
+        response_print(",\"budget_ms\":null,\"remaining_ms\":null");
+    } else {
+        response_print(",\"budget_ms\":");
+        response_print(budget);
+        response_print(",\"remaining_ms\":");
+        response_print(remaining);
+    }
+}
+
 void cmd_info() {
     response_print("{\"name\":\"");
     response_print(mesh.name);
@@ -50,11 +97,25 @@ void cmd_info() {
     response_print(MESHGRID_VERSION);
     response_print("\",\"mode\":\"");
     response_print(device_mode == MODE_REPEATER ? "REPEATER" : "CLIENT");
+    response_print("\",\"role\":\"");
+    response_print(MESHGRID_ROLE_NAME);
     response_print("\",\"freq_mhz\":");
     response_print(radio_config.frequency, 2);
     response_print(",\"tx_power_dbm\":");
     response_print(radio_config.tx_power);
-    response_println("}");
+    response_print(",\"boot\":[");
+    uint8_t phase_count;
+    const struct boot_phase* phases = boot_profile_get(&phase_count);
+    for (uint8_t i = 0; i < phase_count; i++) {
+        if (i > 0)
+            response_print(",");
+        response_print("{\"phase\":\"");
+        response_print(phases[i].name);
+        response_print("\",\"ms\":");
+        response_print(phases[i].end_ms);
+        response_print("}");
+    }
+    response_println("]}");
 }
 
 void cmd_telemetry() {
@@ -74,6 +135,8 @@ void cmd_telemetry() {
         response_print(",\"cpu_temp\":");
         response_print(telemetry.temp_deci_c / 10.0, 1);
     }
+    response_print("},\"duty_cycle\":{");
+    print_duty_cycle_fields();
     response_println("}}");
 }
 
@@ -97,7 +160,24 @@ void cmd_stats() {
     response_print(telemetry.free_heap / 1024);
     response_print(",");
     response_print("\"flash_total_kb\":3264,");
-    response_print("\"flash_used_kb\":481");
+    response_print("\"flash_used_kb\":481,");
+    const struct arena_stats* arena = arena_get_stats();
+    response_print("\"arena\":{");
+    response_print("\"sram_used\":");
+    response_print(arena->sram_used);
+    response_print(",\"sram_size\":");
+    response_print(arena->sram_size);
+    response_print(",\"psram_used\":");
+    response_print(arena->psram_used);
+    response_print(",\"psram_size\":");
+    response_print(arena->psram_size);
+    response_print(",\"spilled\":");
+    response_print(arena->spilled);
+    response_print(",\"late\":");
+    response_print(arena->late);
+    response_print(",\"heap_free_boot_kb\":");
+    response_print(arena->heap_free_boot / 1024);
+    response_print("}");
     response_print("},");
     response_print("\"packets\":{");
     response_print("\"rx\":");
@@ -115,6 +195,135 @@ void cmd_stats() {
     response_print("\"duplicates\":");
     response_print(stat_duplicates);
     response_print("},");
+    const struct forward_stats* fwd = tx_queue_forward_stats();
+    response_print("\"forwarding\":{");
+    response_print("\"queued\":");
+    response_print(fwd->queued);
+    response_print(",\"sent\":");
+    response_print(fwd->sent);
+    response_print(",\"suppressed\":");
+    response_print(fwd->suppressed);
+    response_print(",\"suppress_k\":");
+    response_print((int)meshgrid_suppress_threshold(neighbors_direct_count()));
+    response_print(",\"policy\":\"");
+    response_print(meshgrid_forward_policy_name(meshgrid_get_forward_policy()));
+    const struct forward_drops* drops = forward_get_drops();
+    response_print("\",\"drops\":{\"duplicate\":");
+    response_print(drops->duplicate);
+    response_print(",\"ttl\":");
+    response_print(drops->ttl);
+    response_print(",\"rate\":");
+    response_print(drops->rate);
+    response_print(",\"policy\":");
+    response_print(drops->policy);
+    response_print(",\"suppressed\":");
+    response_print(fwd->suppressed);
+    response_print(",\"queue_full\":");
+    response_print(drops->queue_full);
+    const struct forward_classes* classes = forward_get_classes();
+    response_print("},\"classes\":{\"drop\":");
+    response_print(classes->drop);
+    response_print(",\"forward_only\":");
+    response_print(classes->forward_only);
+    response_print(",\"consume\":");
+    response_print(classes->consume);
+    response_print(",\"consume_and_forward\":");
+    response_print(classes->consume_and_forward);
+    response_print("}},");
+    const struct route_cache_stats* routes = route_cache_get_stats();
+    uint32_t route_lookups = routes->hits + routes->misses + routes->fallbacks;
+    response_print("\"routes\":{");
+    response_print("\"destinations\":");
+    response_print((int)route_cache_count());
+    response_print(",\"hits\":");
+    response_print(routes->hits);
+    response_print(",\"misses\":");
+    response_print(routes->misses);
+    response_print(",\"fallbacks\":");
+    response_print(routes->fallbacks);
+    response_print(",\"hit_rate_pct\":");
+    response_print(route_lookups ? (int)(routes->hits * 100 / route_lookups) : 0);
+    response_print(",\"learned\":");
+    response_print(routes->learned);
+    response_print(",\"acked\":");
+    response_print(routes->acked);
+    response_print(",\"failed\":");
+    response_print(routes->failed);
+    response_print("},");
+    const struct advert_stats* adverts = advertising_get_stats();
+    response_print("\"adverts\":{");
+    response_print("\"local_sent\":");
+    response_print(adverts->local_sent);
+    response_print(",\"local_suppressed\":");
+    response_print(adverts->local_suppressed);
+    response_print(",\"resets\":");
+    response_print(adverts->resets);
+    response_print(",\"interval_ms\":");
+    response_print(adverts->interval_ms);
+    response_print("},");
+    const struct reach_stats* reach = reach_get_stats(millis());
+    response_print("\"reach\":{");
+    response_print("\"neighbors\":");
+    response_print((int)reach->neighbors);
+    response_print(",\"filters\":");
+    response_print((int)reach->filters);
+    response_print(",\"merges\":");
+    response_print(reach->merges);
+    response_print(",\"rotations\":");
+    response_print(reach->rotations);
+    response_print(",\"early\":");
+    response_print(reach->early);
+    response_print(",\"unreachable\":");
+    response_print(reach->unreachable);
+    response_print(",\"pruned\":");
+    response_print(reach->pruned);
+    response_print(",\"suppressed\":");
+    response_print(reach->suppressed);
+    response_print(",\"saturated\":");
+    response_print((int)reach->saturated);
+    response_print(",\"fill\":[");
+    for (int level = 0; level < MESHGRID_BLOOM_LEVELS; level++) {
+        if (level > 0)
+            response_print(",");
+        response_print((int)reach->fill[level]);
+    }
+    response_print("]},");
+    const struct mpr_stats* mpr = mpr_get_stats(millis());
+    response_print("\"mpr\":{");
+    response_print("\"neighbors\":");
+    response_print((int)mpr->neighbors);
+    response_print(",\"symmetric\":");
+    response_print((int)mpr->symmetric);
+    response_print(",\"two_hop\":");
+    response_print((int)mpr->two_hop);
+    response_print(",\"selected\":");
+    response_print((int)mpr->selected);
+    response_print(",\"selectors\":");
+    response_print((int)mpr->selectors);
+    response_print(",\"selections\":");
+    response_print(mpr->selections);
+    response_print(",\"relayed\":");
+    response_print(mpr->relayed);
+    response_print(",\"skipped\":");
+    response_print(mpr->skipped);
+    response_print(",\"fallbacks\":");
+    response_print(mpr->fallbacks);
+    response_print("},");
+    const struct geo_stats* geo = geo_get_stats(millis());
+    response_print("\"geo\":{");
+    response_print("\"known\":");
+    response_print((int)geo->known);
+    response_print(",\"direct\":");
+    response_print((int)geo->direct);
+    response_print(",\"closer\":");
+    response_print(geo->closer);
+    response_print(",\"farther\":");
+    response_print(geo->farther);
+    response_print(",\"perimeter\":");
+    response_print(geo->perimeter);
+    response_print(",\"unknown\":");
+    response_print(geo->unknown);
+    response_print("},");
     response_print("\"neighbors\":{");
     response_print("\"total\":");
     response_print(neighbor_count);
@@ -128,6 +337,82 @@ void cmd_stats() {
     response_print("\"rooms\":");
     response_print(stat_rooms);
     response_print("},");
+    const struct node_dir_stats* dir = node_dir_get_stats();
+    response_print("\"nodedir\":{");
+    response_print("\"mounted\":");
+    response_print(dir->mounted ? "true" : "false");
+    response_print(",\"nodes\":");
+    response_print((int)dir->nodes);
+    response_print(",\"capacity\":");
+    response_print(NODE_DIR_CAPACITY);
+    response_print(",\"pending\":");
+    response_print((int)dir->pending);
+    response_print(",\"lookups\":");
+    response_print(dir->lookups);
+    response_print(",\"writes\":");
+    response_print(dir->writes);
+    response_print(",\"replaced\":");
+    response_print(dir->replaced);
+    response_print(",\"corrupt\":");
+    response_print(dir->corrupt);
+    response_print(",\"write_errors\":");
+    response_print(dir->write_errors);
+    response_print("},");
+    const struct config_store_stats* cfg = config_store_get_stats();
+    response_print("\"config\":{");
+    response_print("\"commits\":");
+    response_print(cfg->commits);
+    response_print(",\"bytes\":");
+    response_print(cfg->bytes);
+    response_print(",\"coalesced\":");
+    response_print(cfg->coalesced);
+    response_print(",\"unchanged\":");
+    response_print(cfg->unchanged);
+    response_print(",\"migrated\":");
+    response_print(cfg->migrated);
+    response_print(",\"rejected\":");
+    response_print(cfg->rejected);
+    response_print(",\"errors\":");
+    response_print(cfg->errors);
+    response_print(",\"dirty\":");
+    response_print((int)cfg->dirty);
+    response_print("},");
+    const struct inbox_stats* inbox = inbox_get_stats();
+    response_print("\"inbox\":{");
+    response_print("\"messages\":");
+    response_print((int)inbox->records);
+    response_print(",\"arena_used\":");
+    response_print((int)inbox->used);
+    response_print(",\"arena_size\":");
+    response_print(MESSAGE_ARENA_SIZE);
+    response_print(",\"stored\":");
+    response_print(inbox->stored);
+    response_print(",\"evicted\":");
+    response_print(inbox->evicted);
+    response_print("},");
+    const struct msg_log_stats* log = msg_log_get_stats();
+    response_print("\"msglog\":{");
+    response_print("\"mounted\":");
+    response_print(log->mounted ? "true" : "false");
+    response_print(",\"messages\":");
+    response_print((int)log->messages);
+    response_print(",\"segments\":");
+    response_print((int)log->segments);
+    response_print(",\"pending\":");
+    response_print((int)log->pending);
+    response_print(",\"appended\":");
+    response_print(log->appended);
+    response_print(",\"flushes\":");
+    response_print(log->flushes);
+    response_print(",\"dropped\":");
+    response_print(log->dropped);
+    response_print(",\"corrupt\":");
+    response_print(log->corrupt);
+    response_print(",\"retired\":");
+    response_print(log->retired);
+    response_print(",\"write_errors\":");
+    response_print(log->write_errors);
+    response_print("},");
     response_print("\"radio\":{");
     response_print("\"freq_mhz\":");
     response_print(radio_config.frequency, 2);
@@ -153,6 +438,82 @@ void cmd_stats() {
     response_print("\"isr_count\":");
     response_print(isr_trigger_count);
     response_print("},");
+    const struct rx_fifo_stats* fifo = rx_fifo_get_stats();
+    response_print("\"rx_fifo\":{");
+    response_print("\"frames\":");
+    response_print(fifo->frames);
+    response_print(",\"depth\":");
+    response_print(rx_fifo_count());
+    response_print(",\"high_water\":");
+    response_print(fifo->high_water);
+    response_print(",\"overruns\":");
+    response_print(fifo->overruns);
+    response_print(",\"irq_overruns\":");
+    response_print(radio_irq_overruns);
+    response_print("},");
+    const struct radio_health_stats* health = radio_health_get_stats();
+    response_print("\"radio_health\":{");
+    response_print("\"recoveries\":");
+    response_print(health->recoveries);
+    response_print(",\"recovery_failures\":");
+    response_print(health->recovery_failures);
+    response_print(",\"last_reason\":\"");
+    response_print(radio_health_reason_name(health->last_reason));
+    response_print("\",\"probes\":");
+    response_print(health->probes);
+    response_print(",\"probe_failures\":");
+    response_print(health->probe_failures);
+    response_print(",\"silence_s\":");
+    response_print(radio_health_silence_ms(millis()) / 1000);
+    response_print(",\"silence_limit_s\":");
+    response_print(radio_health_silence_limit_ms() / 1000);
+    response_print("},");
+#ifdef ENABLE_RADIO_TASK
+    const struct radio_task_stats* task = radio_task_get_stats();
+    response_print("\"radio_task\":{");
+    response_print("\"tx_submitted\":");
+    response_print(task->tx_submitted);
+    response_print(",\"tx_ring_full\":");
+    response_print(task->tx_ring_full);
+    response_print(",\"tx_done\":");
+    response_print(task->tx_done);
+    response_print(",\"tx_refused\":");
+    response_print(task->tx_refused);
+    response_print(",\"tx_failed\":");
+    response_print(task->tx_failed);
+    response_print(",\"wakeups\":");
+    response_print(task->wakeups);
+    response_print(",\"max_turnaround_us\":");
+    response_print(task->max_turnaround_us);
+    response_print("},");
+#endif
+    const struct lbt_stats* lbt = lbt_get_stats();
+    response_print("\"lbt\":{");
+    response_print("\"cad_free\":");
+    response_print(lbt->cad_free);
+    response_print(",");
+    response_print("\"cad_busy\":");
+    response_print(lbt->cad_busy);
+    response_print(",");
+    response_print("\"cad_error\":");
+    response_print(lbt->cad_error);
+    response_print(",");
+    response_print("\"forced\":");
+    response_print(lbt->forced);
+    response_print(",");
+    response_print("\"mean_access_ms\":");
+    response_print(lbt_mean_access_delay_ms());
+    response_print("},");
+    const struct duty_cycle_stats* duty = duty_cycle_get_stats();
+    response_print("\"duty_cycle\":{");
+    print_duty_cycle_fields();
+    response_print(",\"admitted\":");
+    response_print(duty->admitted);
+    response_print(",\"deferred\":");
+    response_print(duty->deferred);
+    response_print(",\"refused\":");
+    response_print(duty->refused);
+    response_print("},");
     response_print("\"power\":{");
     response_print("\"battery_mv\":");
     response_print(telemetry.battery_mv);
@@ -197,6 +558,8 @@ void cmd_stats() {
     response_print(",");
     response_print("\"mode\":\"");
     response_print(device_mode == MODE_REPEATER ? "REPEATER" : "CLIENT");
+    response_print("\",\"role\":\"");
+    response_print(MESHGRID_ROLE_NAME);
     response_print("\"");
     response_print("},");
     response_print("\"temperature\":{");
@@ -225,5 +588,18 @@ void cmd_config() {
     response_print(radio_config.coding_rate);
     response_print(",\"preamble_len\":");
     response_print(radio_config.preamble_len);
-    response_println("}");
+    response_print(",\"region\":\"");
+    response_print(duty_cycle_region_name(duty_cycle_get_region()));
+    response_print("\",\"forward_policy\":\"");
+    response_print(meshgrid_forward_policy_name(meshgrid_get_forward_policy()));
+    const struct meshgrid_position* pos = geo_get_self();
+    if (pos->valid) {
+        char position[40];
+        snprintf(position, sizeof(position), "[%.6f,%.6f]", pos->lat_e6 / 1e6, pos->lon_e6 / 1e6);
+        response_print("\",\"position\":");
+        response_print(position);
+        response_println("}");
+    } else {
+        response_println("\",\"position\":null}");
+    }
 }
@@ -7,137 +7,75 @@
 #include "utils/constants.h"
 #include "utils/types.h"
 #include "utils/memory.h"
+#include "core/messaging/inbox.h"
+#include "core/messaging/msg_log.h"
 
-extern struct message_entry public_messages[PUBLIC_MESSAGE_BUFFER_SIZE];
-extern int public_msg_index, public_msg_count;
-extern struct message_entry direct_messages[DIRECT_MESSAGE_BUFFER_SIZE];
-extern int direct_msg_index, direct_msg_count;
-extern struct message_entry channel_messages[MAX_CUSTOM_CHANNELS][CHANNEL_MESSAGE_BUFFER_SIZE];
-extern int channel_msg_index[MAX_CUSTOM_CHANNELS];
-extern int channel_msg_count[MAX_CUSTOM_CHANNELS];
-extern uint8_t public_channel_hash;
 extern struct channel_entry custom_channels[MAX_CUSTOM_CHANNELS];
 extern int custom_channel_count;
 
-void cmd_messages() {
-    response_print("{\"messages\":[");
-
-    int total_shown = 0;
-
-    /* Show public channel messages */
-    int start = (public_msg_count < PUBLIC_MESSAGE_BUFFER_SIZE) ? 0 : public_msg_index;
-    for (int i = 0; i < public_msg_count; i++) {
-        int idx = (start + i) % PUBLIC_MESSAGE_BUFFER_SIZE;
-        struct message_entry* msg = &public_messages[idx];
-        if (!msg->valid)
-            continue;
+#define MESSAGES_PAGE_SIZE 10
 
-        if (total_shown > 0)
-            response_print(",");
-        response_print("{");
-        response_print("\"from_hash\":\"0x");
-        response_print(String(msg->sender_hash, HEX));
-        response_print("\",");
-        response_print("\"from_name\":\"");
-        print_json_string(msg->sender_name);
-        response_print("\",");
-        response_print("\"channel\":\"");
-        if (msg->channel_hash == public_channel_hash) {
-            response_print("public");
-        } else {
-            response_print("0x");
-            response_print(String(msg->channel_hash, HEX));
-        }
-        response_print("\",");
-        response_print("\"protocol\":\"v");
-        response_print(msg->protocol_version);
-        response_print("\",");
-        response_print("\"decrypted\":");
-        response_print(msg->decrypted ? "true" : "false");
-        response_print(",");
-        response_print("\"timestamp\":");
-        response_print(msg->timestamp);
+/* One message as JSON; seq < 0 leaves it out */
+static void print_message_json(int32_t seq, uint8_t sender_hash, const char* sender, const char* channel,
+                               uint8_t protocol_version, uint32_t timestamp, const char* text) {
+    response_print("{");
+    if (seq >= 0) {
+        response_print("\"seq\":");
+        response_print(seq);
         response_print(",");
-        response_print("\"text\":\"");
-        print_json_string(msg->text);
-        response_print("\"");
-        response_print("}");
-        total_shown++;
     }
+    response_print("\"from_hash\":\"0x");
+    response_print(String(sender_hash, HEX));
+    response_print("\",");
+    response_print("\"from_name\":\"");
+    print_json_string(sender);
+    response_print("\",");
+    response_print("\"channel\":\"");
+    print_json_string(channel);
+    response_print("\",");
+    response_print("\"protocol\":\"v");
+    response_print(protocol_version);
+    response_print("\",");
+    response_print("\"decrypted\":true,"); /* Only decrypted messages are stored */
+    response_print("\"timestamp\":");
+    response_print(timestamp);
+    response_print(",");
+    response_print("\"text\":\"");
+    print_json_string(text);
+    response_print("\"");
+    response_print("}");
+}
 
-    /* Show direct messages */
-    start = (direct_msg_count < DIRECT_MESSAGE_BUFFER_SIZE) ? 0 : direct_msg_index;
-    for (int i = 0; i < direct_msg_count; i++) {
-        int idx = (start + i) % DIRECT_MESSAGE_BUFFER_SIZE;
-        struct message_entry* msg = &direct_messages[idx];
-        if (!msg->valid)
-            continue;
+/* One message read in place from the inbox arena */
+static void print_message(const struct inbox_msg* msg, const char* channel) {
+    print_message_json(-1, msg->sender_hash, inbox_sender(msg), channel, msg->protocol_version, msg->timestamp,
+                       inbox_text(msg));
+}
 
+/* Every message of one conversation, oldest first */
+static int print_conversation(uint8_t conv, const char* channel, int total_shown) {
+    uint16_t count = inbox_count(conv);
+    for (uint16_t i = 0; i < count; i++) {
         if (total_shown > 0)
             response_print(",");
-        response_print("{");
-        response_print("\"from_hash\":\"0x");
-        response_print(String(msg->sender_hash, HEX));
-        response_print("\",");
-        response_print("\"from_name\":\"");
-        print_json_string(msg->sender_name);
-        response_print("\",");
-        response_print("\"channel\":\"direct\",");
-        response_print("\"protocol\":\"v");
-        response_print(msg->protocol_version);
-        response_print("\",");
-        response_print("\"decrypted\":");
-        response_print(msg->decrypted ? "true" : "false");
-        response_print(",");
-        response_print("\"timestamp\":");
-        response_print(msg->timestamp);
-        response_print(",");
-        response_print("\"text\":\"");
-        print_json_string(msg->text);
-        response_print("\"");
-        response_print("}");
+        print_message(inbox_get(conv, i), channel);
         total_shown++;
     }
+    return total_shown;
+}
 
-    /* Show custom channel messages */
+void cmd_messages() {
+    response_print("{\"messages\":[");
+
+    int total_shown = 0;
+
+    /* Public channel, direct messages, then custom channels */
+    total_shown = print_conversation(INBOX_PUBLIC, "public", total_shown);
+    total_shown = print_conversation(INBOX_DIRECT, "direct", total_shown);
     for (int ch = 0; ch < custom_channel_count; ch++) {
         if (!custom_channels[ch].valid)
             continue;
-
-        start = (channel_msg_count[ch] < CHANNEL_MESSAGE_BUFFER_SIZE) ? 0 : channel_msg_index[ch];
-        for (int i = 0; i < channel_msg_count[ch]; i++) {
-            int idx = (start + i) % CHANNEL_MESSAGE_BUFFER_SIZE;
-            struct message_entry* msg = &channel_messages[ch][idx];
-            if (!msg->valid)
-                continue;
-
-            if (total_shown > 0)
-                response_print(",");
-            response_print("{");
-            response_print("\"from_hash\":\"0x");
-            response_print(String(msg->sender_hash, HEX));
-            response_print("\",");
-            response_print("\"from_name\":\"");
-            print_json_string(msg->sender_name);
-            response_print("\",");
-            response_print("\"channel\":\"");
-            print_json_string(custom_channels[ch].name);
-            response_print("\",");
-            response_print("\"protocol\":\"v");
-            response_print(msg->protocol_version);
-            response_print("\",");
-            response_print("\"decrypted\":");
-            response_print(msg->decrypted ? "true" : "false");
-            response_print(",");
-            response_print("\"timestamp\":");
-            response_print(msg->timestamp);
-            response_print(",");
-            response_print("\"text\":\"");
-            print_json_string(msg->text);
-            response_print("\"");
-            response_print("}");
-            total_shown++;
-        }
+        total_shown = print_conversation(INBOX_CHANNEL(ch), custom_channels[ch].name, total_shown);
     }
 
     response_print("],\"total\":");
@@ -145,14 +83,84 @@ void cmd_messages() {
     response_println("}");
 }
 
-void cmd_messages_clear() {
-    public_msg_count = 0;
-    public_msg_index = 0;
-    direct_msg_count = 0;
-    direct_msg_index = 0;
-    for (int i = 0; i < MAX_CUSTOM_CHANNELS; i++) {
-        channel_msg_count[i] = 0;
-        channel_msg_index[i] = 0;
+/* Conversation name as MESSAGES prints it */
+static const char* conv_name(uint8_t conv) {
+    if (conv == INBOX_PUBLIC)
+        return "public";
+    if (conv == INBOX_DIRECT)
+        return "direct";
+    if (conv != MSG_LOG_ORPHAN && conv - INBOX_CHANNEL(0) < custom_channel_count)
+        return custom_channels[conv - INBOX_CHANNEL(0)].name;
+    return "unknown";
+}
+
+static void print_log_entry(const struct msg_log_entry* entry, void* ctx) {
+    int* shown = (int*)ctx;
+    if (*shown > 0)
+        response_print(",");
+    print_message_json((int32_t)entry->seq, entry->sender_hash, entry->sender_name, conv_name(entry->conv),
+                       entry->protocol_version, entry->timestamp, entry->text);
+    (*shown)++;
+}
+
+void cmd_messages_page(const String& args) {
+    if (!msg_log_get_stats()->mounted) {
+        response_println("ERR Message log not available");
+        return;
     }
+
+    /* PAGE <n> [public|direct|<channel>] - page 0 is the newest */
+    String rest = args;
+    rest.trim();
+    int space = rest.indexOf(' ');
+    long page = (space < 0 ? rest : rest.substring(0, space)).toInt();
+    String name = space < 0 ? String("") : rest.substring(space + 1);
+    name.trim();
+    if (page < 0) {
+        response_println("ERR Invalid page");
+        return;
+    }
+
+    uint8_t conv = MSG_LOG_ALL;
+    if (name.length() > 0) {
+        if (name.equalsIgnoreCase("public")) {
+            conv = INBOX_PUBLIC;
+        } else if (name.equalsIgnoreCase("direct")) {
+            conv = INBOX_DIRECT;
+        } else {
+            conv = MSG_LOG_ORPHAN;
+            for (int ch = 0; ch < custom_channel_count; ch++) {
+                if (custom_channels[ch].valid && name.equalsIgnoreCase(custom_channels[ch].name)) {
+                    conv = INBOX_CHANNEL(ch);
+                    break;
+                }
+            }
+            if (conv == MSG_LOG_ORPHAN) {
+                response_println("ERR Unknown conversation");
+                return;
+            }
+        }
+    }
+
+    uint16_t total = msg_log_count(conv);
+    uint16_t pages = (total + MESSAGES_PAGE_SIZE - 1) / MESSAGES_PAGE_SIZE;
+
+    response_print("{\"messages\":[");
+    int shown = 0;
+    if (page < pages) {
+        msg_log_page(conv, (uint16_t)(page * MESSAGES_PAGE_SIZE), MESSAGES_PAGE_SIZE, print_log_entry, &shown);
+    }
+    response_print("],\"page\":");
+    response_print(page);
+    response_print(",\"pages\":");
+    response_print(pages);
+    response_print(",\"total\":");
+    response_print(total);
+    response_println("}");
+}
+
+void cmd_messages_clear() {
+    inbox_clear_all();
+    msg_log_clear();
     response_println("OK Messages cleared");
 }
@@ -1,6 +1,6 @@
 /**
  * Message command handlers
- * MESSAGES, INBOX, MESSAGES CLEAR
+ * MESSAGES, INBOX, MESSAGES PAGE, MESSAGES CLEAR
  */
 
 #ifndef MESHGRID_COMMANDS_MESSAGE_H
@@ -13,6 +13,7 @@ extern "C" {
 #endif
 
 void cmd_messages();
+void cmd_messages_page(const String& args);
 void cmd_messages_clear();
 
 #ifdef __cplusplus
@@ -5,6 +5,7 @@
 #include "network_commands.h"
 #include "common.h"
 #include "core/neighbors.h"
+#include "core/messaging/utils.h"
 #include "utils/constants.h"
 #include "utils/debug.h"
 #include "radio/radio_hal.h"
@@ -12,6 +13,7 @@
 
 extern "C" {
 #include "network/protocol.h"
+#include "network/reachability.h"
 }
 
 // Use C bridge to avoid namespace conflict
@@ -31,8 +33,8 @@ extern uint32_t get_uptime_secs(void);
 static bool last_send_used_v1 = false;
 static int last_v1_result = -999;
 
-/* Auto-select v0 or v1 protocol based on peer capability */
-static inline void send_text_message(uint8_t dest_hash, const char* text) {
+/* Auto-select v0 or v1 protocol based on peer capability; returns MESHCORE_SEND_* */
+static inline int send_text_message(uint8_t dest_hash, const char* text) {
     /* Check if peer supports v1 */
     bool supports_v1 = meshgrid_v1_peer_supports_v1(dest_hash);
     DEBUG_INFOF("[SEND] Checking peer 0x%02x supports_v1=%d", dest_hash, supports_v1);
@@ -56,7 +58,7 @@ static inline void send_text_message(uint8_t dest_hash, const char* text) {
             if (last_v1_result == 0) {
                 DEBUG_INFO("[SEND] v1 send succeeded");
                 last_send_used_v1 = true;
-                return; /* v1 succeeded */
+                return MESHCORE_SEND_OK; /* v1 succeeded */
             }
         }
         DEBUG_WARN("[SEND] v1 send failed, falling back to v0");
@@ -64,7 +66,7 @@ static inline void send_text_message(uint8_t dest_hash, const char* text) {
 
     /* Fall back to v0 */
     DEBUG_INFOF("[SEND] Using v0 protocol for dest=0x%02x", dest_hash);
-    meshcore_bridge_send_text(dest_hash, text);
+    return meshcore_bridge_send_text(dest_hash, text);
 }
 
 void cmd_neighbors() {
@@ -101,6 +103,20 @@ void cmd_neighbors() {
         response_print(neighbors[i].rssi);
         response_print(",\"snr\":");
         response_print(neighbors[i].snr);
+        const struct link_quality* link = &neighbors[i].link;
+        response_print(",\"link\":{\"snr_avg\":");
+        response_print((int)link_quality_snr(link));
+        response_print(",\"rssi_avg\":");
+        response_print((int)link_quality_rssi(link));
+        response_print(",\"pdr_pct\":");
+        response_print(link->pdr / 10);
+        response_print(",\"score\":");
+        response_print((int)link->score);
+        response_print(",\"frames\":");
+        response_print(link->frames);
+        response_print(",\"lost\":");
+        response_print(link->lost);
+        response_print("}");
         response_print(",\"last_seen_secs\":");
         response_print((millis() - neighbors[i].last_seen) / 1000);
         response_print(",\"firmware\":\"");
@@ -178,11 +194,26 @@ void cmd_send(const String& args) {
         if (message.length() > 0 && message.length() <= 150) {
             DEBUG_INFOF("[CMD] Calling send_text_message(0x%02x, '%s')", dest_hash, message.c_str());
 
+            /* Every neighbor's filter says no - don't flood the mesh for nothing */
+            if (reach_within(dest_hash, REACH_ANY_HOPS, millis()) == REACH_NO) {
+                reach_note_suppressed();
+                response_println("ERR Unreachable, not flooded");
+                return;
+            }
+
             /* Check protocol support before sending */
             struct meshgrid_neighbor* n = neighbor_find(dest_hash);
             bool supports_v1 = meshgrid_v1_peer_supports_v1(dest_hash);
 
-            send_text_message(dest_hash, message.c_str());
+            int result = send_text_message(dest_hash, message.c_str());
+            if (result == MESHCORE_SEND_UNREACHABLE) {
+                response_println("ERR Unreachable, not flooded");
+                return;
+            }
+            if (result != MESHCORE_SEND_OK) {
+                response_println("ERR Send failed");
+                return;
+            }
 
             /* Show detailed protocol info */
             char resp[100];
@@ -270,17 +301,11 @@ void cmd_trace(const String& target) {
     pkt.payload_len = 10;
     pkt.path_len = 0;
 
-    /* Encode and transmit */
+    /* Encode and queue (listen-before-talk and duty cycle run there) */
     uint8_t tx_buf[MESHGRID_MAX_PACKET_SIZE];
     int tx_len = meshgrid_packet_encode(&pkt, tx_buf, sizeof(tx_buf));
     if (tx_len > 0) {
-        int16_t radio_result = get_radio()->transmit(tx_buf, tx_len);
-        radio_in_rx_mode = false;
-        get_radio()->startReceive();
-
-        if (radio_result == RADIOLIB_ERR_NONE) {
-            mesh.packets_tx++;
-
+        if (tx_queue_add(tx_buf, tx_len, 0, 5)) {
             response_print("{\"status\":\"sent\",\"target\":\"0x");
             response_print(dest_hash, HEX);
             response_print("\",\"trace_id\":");
@@ -289,8 +314,7 @@ void cmd_trace(const String& target) {
             response_print(pkt.path_len);
             response_println("}");
         } else {
-            response_print("ERR Radio TX failed: ");
-            response_println(radio_result);
+            response_println("ERR TX queue full");
         }
     } else {
         response_println("ERR Packet encode failed");
@@ -8,8 +8,14 @@
 #include "utils/constants.h"
 #include "utils/types.h"
 #include "utils/memory.h"
+#include "utils/role.h"
 #include "utils/debug.h"
 #include "ui/screens.h"
+#include "core/messaging/inbox.h"
+#include "core/messaging/msg_log.h"
+#include "core/node_dir.h"
+#include "core/config.h"
+#include "core/config_store.h"
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
 #    include <Preferences.h>
 #    include <Esp.h>
@@ -33,16 +39,7 @@ extern Preferences prefs;
 extern struct rtc_time_t rtc_time;
 extern struct display_state display_state; /* Defined in utils/types.h */
 
-extern struct message_entry public_messages[PUBLIC_MESSAGE_BUFFER_SIZE];
-extern int public_msg_index, public_msg_count;
-extern struct message_entry direct_messages[DIRECT_MESSAGE_BUFFER_SIZE];
-extern int direct_msg_index, direct_msg_count;
-extern struct message_entry channel_messages[MAX_CUSTOM_CHANNELS][CHANNEL_MESSAGE_BUFFER_SIZE];
-extern int channel_msg_index[MAX_CUSTOM_CHANNELS];
-extern int channel_msg_count[MAX_CUSTOM_CHANNELS];
-
-extern void config_save(void);
-extern void neighbors_save_to_nvs(void);
+extern bool neighbors_save_to_nvs(void);
 extern void channels_save_to_nvs(void);
 
 void cmd_reboot() {
@@ -50,32 +47,27 @@ void cmd_reboot() {
     config_save();
     neighbors_save_to_nvs();
     channels_save_to_nvs();
+    config_store_flush();
+    msg_log_flush();
+    node_dir_flush();
     delay(100);
     ESP.restart();
 }
 
 void cmd_identity_rotate() {
-    /* Clear messages */
-    public_msg_count = 0;
-    public_msg_index = 0;
-    direct_msg_count = 0;
-    direct_msg_index = 0;
-    for (int i = 0; i < MAX_CUSTOM_CHANNELS; i++) {
-        channel_msg_count[i] = 0;
-        channel_msg_index[i] = 0;
-    }
+    /* Clear messages, in RAM and on flash */
+    inbox_clear_all();
+    msg_log_clear();
 
-    /* Clear saved neighbors */
+    /* Clear saved neighbors and the node directory */
     prefs.begin("neighbors", false);
     prefs.clear();
     prefs.end();
+    node_dir_clear();
 
-    /* Clear identity from NVS */
-    prefs.begin("meshgrid", false);
-    prefs.putBool("has_identity", false);
-    prefs.remove("pubkey");
-    prefs.remove("privkey");
-    prefs.end();
+    /* Clear identity from NVS - a new keypair is generated at boot */
+    config_store_erase(CONFIG_SECTION_IDENTITY);
+    config_store_flush();
 
     response_println("OK Identity rotated - all encrypted data cleared, rebooting...");
     delay(100);
@@ -104,6 +96,10 @@ void cmd_mode(const String& mode) {
         config_save();
         response_println("Mode: REPEATER");
     } else if (mode == "client" || mode == "cli") {
+#ifdef ROLE_REPEATER
+        response_println("ERR Repeater build");
+        return;
+#endif
         device_mode = MODE_CLIENT;
         config_save();
         response_println("Mode: CLIENT");
@@ -237,11 +233,8 @@ void cmd_time(const String& timestr) {
         rtc_time.epoch_at_boot = epoch - (millis() / 1000);
         rtc_time.valid = true;
 
-        /* Save RTC time to NVS */
-        prefs.begin("meshgrid", false);
-        prefs.putBool("rtc_valid", true);
-        prefs.putUInt("rtc_epoch", rtc_time.epoch_at_boot);
-        prefs.end();
+        /* Save RTC time */
+        config_save_rtc();
 
         response_println("OK Time set");
     } else {
@@ -3,7 +3,9 @@
  */
 
 #include "config.h"
+#include "config_store.h"
 #include "utils/debug.h"
+#include "utils/role.h"
 #include <Arduino.h>
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
 #    include <Preferences.h>
@@ -11,10 +13,13 @@
 #endif
 
 #include "hardware/board.h"
+#include "radio/radio_task.h"
 
 extern "C" {
 #include "network/protocol.h"
 #include "hardware/crypto/crypto.h"
+#include "radio/duty_cycle.h"
+#include "network/geo.h"
 }
 
 /* Public channel (MeshCore compatible) */
@@ -72,17 +77,116 @@ void init_public_channel(void) {
     }
 }
 
-void config_load(void) {
+/* Settings keys of the per-key layout (namespace "meshgrid"), read once to migrate */
+static const char* const legacy_keys[] = {
+    "saved",  "freq",       "bw",        "sf",     "cr",     "preamble", "power",     "mode",
+    "region", "fwd_policy", "pos_valid", "lat_e6", "lon_e6", "name",     "rtc_valid", "rtc_epoch",
+};
+
+static void settings_defaults(struct config_settings* s) {
+    memset(s, 0, sizeof(*s));
+    s->frequency = board->lora_defaults.frequency;
+    s->bandwidth = board->lora_defaults.bandwidth;
+    s->spreading_factor = board->lora_defaults.spreading_factor;
+    s->coding_rate = board->lora_defaults.coding_rate;
+    s->preamble_len = board->lora_defaults.preamble_len;
+    s->tx_power = board->lora_defaults.tx_power;
+    s->device_mode = MESHGRID_ROLE_MODE;
+    s->duty_region = DUTY_REGION_AUTO;
+    s->forward_policy = FWD_POLICY_FLOOD;
+}
+
+/* Settings from the per-key layout; false if it holds none */
+static bool legacy_load(struct config_settings* s) {
+    settings_defaults(s);
     prefs.begin("meshgrid", true); // Read-only
-    radio_config.config_saved = prefs.getBool("saved", false);
+    if (!prefs.isKey("saved") && !prefs.isKey("rtc_valid")) {
+        prefs.end();
+        return false;
+    }
+
+    s->radio_saved = prefs.getBool("saved", false);
+    if (s->radio_saved) {
+        s->frequency = prefs.getFloat("freq", s->frequency);
+        s->bandwidth = prefs.getFloat("bw", s->bandwidth);
+        s->spreading_factor = prefs.getUChar("sf", s->spreading_factor);
+        s->coding_rate = prefs.getUChar("cr", s->coding_rate);
+        s->preamble_len = prefs.getUShort("preamble", s->preamble_len);
+        s->tx_power = prefs.getChar("power", s->tx_power);
+    }
+    s->device_mode = prefs.getUChar("mode", s->device_mode);
+    s->duty_region = prefs.getUChar("region", s->duty_region);
+    s->forward_policy = prefs.getUChar("fwd_policy", s->forward_policy);
+    s->pos_valid = prefs.getBool("pos_valid", false);
+    s->lat_e6 = prefs.getInt("lat_e6", 0);
+    s->lon_e6 = prefs.getInt("lon_e6", 0);
+    String saved_name = prefs.getString("name", "");
+    strncpy(s->name, saved_name.c_str(), MESHGRID_NODE_NAME_MAX);
+    s->rtc_valid = prefs.getBool("rtc_valid", false);
+    s->rtc_epoch = prefs.getUInt("rtc_epoch", 0);
+    prefs.end();
+    return true;
+}
+
+/* Move the per-key settings into the config store, then drop the keys */
+static void legacy_migrate(const struct config_settings* s) {
+    config_store_put(CONFIG_SECTION_SETTINGS, s, sizeof(*s));
+    if (!config_store_commit(CONFIG_SECTION_SETTINGS)) {
+        return; /* Keys stay - tried again next boot */
+    }
+    prefs.begin("meshgrid", false); // Read-write
+    for (size_t i = 0; i < sizeof(legacy_keys) / sizeof(legacy_keys[0]); i++) {
+        prefs.remove(legacy_keys[i]);
+    }
+    prefs.end();
+    config_store_note_migrated(CONFIG_SECTION_SETTINGS);
+}
+
+/* Serialize the live settings into the config store image */
+static void settings_put(void) {
+    struct config_settings s;
+    memset(&s, 0, sizeof(s));
+    s.frequency = radio_config.frequency;
+    s.bandwidth = radio_config.bandwidth;
+    s.spreading_factor = radio_config.spreading_factor;
+    s.coding_rate = radio_config.coding_rate;
+    s.preamble_len = radio_config.preamble_len;
+    s.tx_power = radio_config.tx_power;
+    s.radio_saved = radio_config.config_saved;
+    s.device_mode = (uint8_t)device_mode;
+    s.duty_region = (uint8_t)duty_cycle_get_region();
+    s.forward_policy = (uint8_t)meshgrid_get_forward_policy();
+
+    const struct meshgrid_position* pos = geo_get_self();
+    s.pos_valid = pos->valid;
+    s.lat_e6 = pos->lat_e6;
+    s.lon_e6 = pos->lon_e6;
+
+    strncpy(s.name, mesh.name, MESHGRID_NODE_NAME_MAX);
+    s.rtc_valid = rtc_time.valid;
+    s.rtc_epoch = rtc_time.epoch_at_boot;
+
+    config_store_put(CONFIG_SECTION_SETTINGS, &s, sizeof(s));
+}
 
+void config_load(void) {
+    struct config_settings s;
+    if (config_store_get(CONFIG_SECTION_SETTINGS, &s, sizeof(s)) != sizeof(s)) {
+        if (legacy_load(&s)) {
+            legacy_migrate(&s);
+        } else {
+            settings_defaults(&s);
+        }
+    }
+
+    radio_config.config_saved = s.radio_saved;
     if (radio_config.config_saved) {
-        radio_config.frequency = prefs.getFloat("freq", board->lora_defaults.frequency);
-        radio_config.bandwidth = prefs.getFloat("bw", board->lora_defaults.bandwidth);
-        radio_config.spreading_factor = prefs.getUChar("sf", board->lora_defaults.spreading_factor);
-        radio_config.coding_rate = prefs.getUChar("cr", board->lora_defaults.coding_rate);
-        radio_config.preamble_len = prefs.getUShort("preamble", board->lora_defaults.preamble_len);
-        radio_config.tx_power = prefs.getChar("power", board->lora_defaults.tx_power);
+        radio_config.frequency = s.frequency;
+        radio_config.bandwidth = s.bandwidth;
+        radio_config.spreading_factor = s.spreading_factor;
+        radio_config.coding_rate = s.coding_rate;
+        radio_config.preamble_len = s.preamble_len;
+        radio_config.tx_power = s.tx_power;
         DEBUG_INFO("Loaded radio config from flash");
     } else {
         // Use board defaults
@@ -95,44 +199,47 @@ void config_load(void) {
         DEBUG_INFO("Using board default radio config");
     }
 
-    /* Load device mode */
-    device_mode = (enum meshgrid_device_mode)prefs.getUChar("mode", MODE_CLIENT);
+    /* Device mode */
+    device_mode = (enum meshgrid_device_mode)s.device_mode;
+#ifdef ROLE_REPEATER
+    device_mode = MODE_REPEATER;
+#endif
 
-    /* Load node name if saved */
-    String saved_name = prefs.getString("name", "");
-    if (saved_name.length() > 0) {
-        strncpy(mesh.name, saved_name.c_str(), MESHGRID_NODE_NAME_MAX);
+    /* Duty-cycle region (AUTO picks it from the frequency) - the radio task is already running */
+    radio_lock();
+    duty_cycle_set_region((enum duty_region)s.duty_region);
+    radio_unlock();
+
+    /* Flood forwarding policy */
+    meshgrid_set_forward_policy((enum meshgrid_forward_policy)s.forward_policy);
+
+    /* Fixed position (advertised, used by geographic forwarding) */
+    struct meshgrid_position pos;
+    pos.valid = s.pos_valid;
+    pos.lat_e6 = s.lat_e6;
+    pos.lon_e6 = s.lon_e6;
+    geo_set_self(&pos);
+
+    /* Node name if saved */
+    if (s.name[0] != '\0') {
+        memcpy(mesh.name, s.name, MESHGRID_NODE_NAME_MAX);
         mesh.name[MESHGRID_NODE_NAME_MAX] = '\0';
         DEBUG_INFO("Loaded node name from flash");
     }
 
-    /* Load RTC time if saved */
-    if (prefs.getBool("rtc_valid", false)) {
-        rtc_time.epoch_at_boot = prefs.getUInt("rtc_epoch", 0);
+    /* RTC time if saved */
+    if (s.rtc_valid) {
+        rtc_time.epoch_at_boot = s.rtc_epoch;
         rtc_time.valid = true;
         DEBUG_INFO("Loaded RTC time from flash");
     }
-
-    prefs.end();
 }
 
 void config_save(void) {
-    prefs.begin("meshgrid", false); // Read-write
-    prefs.putBool("saved", true);
-    prefs.putFloat("freq", radio_config.frequency);
-    prefs.putFloat("bw", radio_config.bandwidth);
-    prefs.putUChar("sf", radio_config.spreading_factor);
-    prefs.putUChar("cr", radio_config.coding_rate);
-    prefs.putUShort("preamble", radio_config.preamble_len);
-    prefs.putChar("power", radio_config.tx_power);
-
-    /* Save device mode */
-    prefs.putUChar("mode", (uint8_t)device_mode);
-
-    /* Save node name */
-    prefs.putString("name", mesh.name);
-
-    prefs.end();
     radio_config.config_saved = true;
-    DEBUG_INFO("Saved config to flash");
+    settings_put();
+}
+
+void config_save_rtc(void) {
+    settings_put();
 }
@@ -11,13 +11,18 @@
 void init_public_channel(void);
 
 /**
- * Load configuration from NVS
+ * Load configuration from the config store (migrating the per-key layout)
  */
 void config_load(void);
 
 /**
- * Save configuration to NVS
+ * Save configuration - committed to NVS by config_store_loop() once changes settle
  */
 void config_save(void);
 
+/**
+ * Save the RTC time without marking the radio config as saved
+ */
+void config_save_rtc(void);
+
 #endif /* MESHGRID_CONFIG_H */
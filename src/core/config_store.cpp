@@ -0,0 +1,215 @@
+/**
+ * Config store - write-behind NVS cache for settings, channels and identity
+ */
+
+#include "config_store.h"
+#include "utils/constants.h"
+#include "utils/crc16.h"
+#include "utils/debug.h"
+#include <Arduino.h>
+#include <stddef.h>
+#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
+#    include <Preferences.h>
+#endif
+
+#define NAMESPACE "config"
+
+/* Every blob starts with this; the section struct follows */
+struct blob_header {
+    uint8_t version; /* CONFIG_*_VERSION */
+    uint8_t reserved;
+    uint16_t len; /* Payload bytes */
+    uint16_t crc; /* CRC16 of the payload */
+    uint16_t reserved2;
+};
+
+struct settings_blob {
+    struct blob_header header;
+    struct config_settings body;
+};
+
+struct channels_blob {
+    struct blob_header header;
+    struct config_channels body;
+};
+
+struct identity_blob {
+    struct blob_header header;
+    struct config_identity body;
+};
+
+static_assert(sizeof(struct blob_header) == 8, "blob header layout");
+static_assert(sizeof(struct config_settings) == 52, "settings blob layout is stored in NVS");
+static_assert(sizeof(struct config_channel) == 50, "channel blob layout is stored in NVS");
+static_assert(sizeof(struct config_identity) == 96, "identity blob layout is stored in NVS");
+static_assert(offsetof(struct settings_blob, body) == sizeof(struct blob_header), "payload follows header");
+static_assert(offsetof(struct channels_blob, body) == sizeof(struct blob_header), "payload follows header");
+static_assert(offsetof(struct identity_blob, body) == sizeof(struct blob_header), "payload follows header");
+
+/* The RAM image: what NVS holds, plus puts not yet committed */
+static struct settings_blob settings_image;
+static struct channels_blob channels_image;
+static struct identity_blob identity_image;
+
+struct section {
+    const char* key;
+    uint8_t version;
+    uint16_t max;               /* Largest payload */
+    struct blob_header* header; /* Payload follows */
+};
+
+static const struct section sections[CONFIG_SECTIONS] = {
+    {"settings", CONFIG_SETTINGS_VERSION, sizeof(struct config_settings), &settings_image.header},
+    {"channels", CONFIG_CHANNELS_VERSION, sizeof(struct config_channels), &channels_image.header},
+    {"identity", CONFIG_IDENTITY_VERSION, sizeof(struct config_identity), &identity_image.header},
+};
+
+static uint8_t present;                       /* Bit per section held in the image */
+static uint32_t dirty_since[CONFIG_SECTIONS]; /* First put since the last commit */
+static uint32_t last_put[CONFIG_SECTIONS];
+static struct config_store_stats stats;
+
+static uint8_t* payload(const struct section* s) {
+    return (uint8_t*)(s->header + 1);
+}
+
+static bool blob_valid(const struct section* s, size_t len) {
+    const struct blob_header* h = s->header;
+    return len >= sizeof(*h) && h->version == s->version && h->len == len - sizeof(*h) && h->len <= s->max &&
+           crc16_ccitt(payload(s), h->len) == h->crc;
+}
+
+void config_store_init(void) {
+#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
+    Preferences prefs;
+    if (!prefs.begin(NAMESPACE, true)) {
+        return; /* Nothing stored yet - owners migrate or use defaults */
+    }
+    for (int i = 0; i < CONFIG_SECTIONS; i++) {
+        const struct section* s = &sections[i];
+        size_t len = prefs.getBytesLength(s->key);
+        if (len == 0) {
+            continue;
+        }
+        if (len > sizeof(struct blob_header) + s->max || prefs.getBytes(s->key, s->header, len) != len ||
+            !blob_valid(s, len)) {
+            memset(s->header, 0, sizeof(struct blob_header) + s->max);
+            stats.rejected++;
+            DEBUG_WARNF("[Config] Stored %s invalid, ignoring", s->key);
+            continue;
+        }
+        present |= 1 << i;
+    }
+    prefs.end();
+#endif
+}
+
+uint16_t config_store_get(enum config_section section, void* out, uint16_t size) {
+    const struct section* s = &sections[section];
+    if (!(present & (1 << section))) {
+        return 0;
+    }
+    uint16_t len = s->header->len < size ? s->header->len : size;
+    memcpy(out, payload(s), len);
+    return len;
+}
+
+void config_store_put(enum config_section section, const void* data, uint16_t len) {
+    const struct section* s = &sections[section];
+    uint8_t bit = 1 << section;
+    if (len > s->max) {
+        DEBUG_ERRORF("[Config] %s image too large (%d bytes)", s->key, len);
+        return;
+    }
+    if ((present & bit) && s->header->len == len && memcmp(payload(s), data, len) == 0) {
+        stats.unchanged++;
+        return;
+    }
+
+    memcpy(payload(s), data, len);
+    s->header->version = s->version;
+    s->header->len = len;
+    s->header->crc = crc16_ccitt(payload(s), len);
+    present |= bit;
+
+    uint32_t now = millis();
+    if (stats.dirty & bit) {
+        stats.coalesced++;
+    } else {
+        stats.dirty |= bit;
+        dirty_since[section] = now;
+    }
+    last_put[section] = now;
+}
+
+bool config_store_commit(enum config_section section) {
+    uint8_t bit = 1 << section;
+    if (!(stats.dirty & bit)) {
+        return true;
+    }
+#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
+    const struct section* s = &sections[section];
+    size_t len = sizeof(struct blob_header) + s->header->len;
+    Preferences prefs;
+    bool ok = prefs.begin(NAMESPACE, false) && prefs.putBytes(s->key, s->header, len) == len;
+    prefs.end();
+    if (!ok) {
+        stats.errors++;
+        last_put[section] = millis(); /* Retry after another quiet period */
+        DEBUG_WARNF("[Config] Writing %s failed", s->key);
+        return false;
+    }
+    stats.commits++;
+    stats.bytes += len;
+#endif
+    stats.dirty &= ~bit;
+    return true;
+}
+
+bool config_store_loop(void) {
+    if (!stats.dirty) {
+        return false;
+    }
+    /* One section per pass - each commit is a flash write */
+    uint32_t now = millis();
+    for (int i = 0; i < CONFIG_SECTIONS; i++) {
+        if (!(stats.dirty & (1 << i))) {
+            continue;
+        }
+        if (now - last_put[i] >= CONFIG_COMMIT_DELAY_MS || now - dirty_since[i] >= CONFIG_COMMIT_MAX_DELAY_MS) {
+            config_store_commit((enum config_section)i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void config_store_flush(void) {
+    for (int i = 0; i < CONFIG_SECTIONS; i++) {
+        config_store_commit((enum config_section)i);
+    }
+}
+
+void config_store_erase(enum config_section section) {
+    const struct section* s = &sections[section];
+    uint8_t bit = 1 << section;
+    memset(s->header, 0, sizeof(struct blob_header) + s->max);
+    present &= ~bit;
+    stats.dirty &= ~bit;
+#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
+    Preferences prefs;
+    if (prefs.begin(NAMESPACE, false)) {
+        prefs.remove(s->key);
+    }
+    prefs.end();
+#endif
+}
+
+void config_store_note_migrated(enum config_section section) {
+    DEBUG_INFOF("[Config] Migrated %s to the config store", sections[section].key);
+    stats.migrated++;
+}
+
+const struct config_store_stats* config_store_get_stats(void) {
+    return &stats;
+}
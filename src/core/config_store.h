@@ -0,0 +1,116 @@
+/**
+ * Config store - write-behind NVS cache for settings, channels and identity
+ *
+ * Each section lives as one CRC-checked, versioned blob in the "config"
+ * NVS namespace, mirrored by an image in RAM. A put that changes nothing
+ * is dropped; one that does marks its section dirty, and
+ * config_store_loop() commits dirty sections once no put has arrived for
+ * CONFIG_COMMIT_DELAY_MS - a burst of SET commands costs one NVS write
+ * per section instead of one per key. CONFIG_COMMIT_MAX_DELAY_MS bounds
+ * how long a steady trickle of changes can stay in RAM.
+ *
+ * Owners serialize their state into the structs below and pick
+ * config_store_commit() when a change must not wait (a new keypair).
+ * The per-key layout from earlier firmware is read once by the owners
+ * and migrated at boot. ESP32 family only; elsewhere the image is kept
+ * in RAM and nothing survives a reboot.
+ */
+
+#ifndef MESHGRID_CONFIG_STORE_H
+#define MESHGRID_CONFIG_STORE_H
+
+#include <stdint.h>
+#include "utils/memory.h"
+
+extern "C" {
+#include "network/protocol.h"
+}
+
+enum config_section {
+    CONFIG_SECTION_SETTINGS, /* Radio, mode, region, policy, position, name, clock */
+    CONFIG_SECTION_CHANNELS, /* Custom channels */
+    CONFIG_SECTION_IDENTITY, /* Ed25519 keypair */
+    CONFIG_SECTIONS
+};
+
+/* Bump a section's version when its struct changes - older blobs are then ignored */
+#define CONFIG_SETTINGS_VERSION 1
+#define CONFIG_CHANNELS_VERSION 1
+#define CONFIG_IDENTITY_VERSION 1
+
+struct config_settings {
+    float frequency;
+    float bandwidth;
+    uint8_t spreading_factor;
+    uint8_t coding_rate;
+    uint16_t preamble_len;
+    int8_t tx_power;
+    uint8_t radio_saved; /* 0: radio fields unset, boot with board defaults */
+    uint8_t device_mode;
+    uint8_t duty_region;
+    uint8_t forward_policy;
+    uint8_t pos_valid;
+    uint8_t rtc_valid;
+    uint8_t reserved;
+    int32_t lat_e6;
+    int32_t lon_e6;
+    uint32_t rtc_epoch;                   /* Epoch at boot, see rtc_time */
+    char name[MESHGRID_NODE_NAME_MAX + 1]; /* Empty: keep the generated name */
+    uint8_t reserved2[3];
+};
+
+struct config_channel {
+    uint8_t hash;
+    char name[17];
+    uint8_t secret[32];
+};
+
+struct config_channels {
+    uint8_t count;
+    uint8_t reserved;
+    struct config_channel entries[MAX_CUSTOM_CHANNELS]; /* Only count entries are stored */
+};
+
+struct config_identity {
+    uint8_t pubkey[MESHGRID_PUBKEY_SIZE];
+    uint8_t privkey[MESHGRID_PRIVKEY_SIZE];
+};
+
+struct config_store_stats {
+    uint32_t commits;   /* Section blobs written */
+    uint32_t bytes;     /* Bytes handed to NVS, headers included */
+    uint32_t coalesced; /* Puts folded into a commit already pending */
+    uint32_t unchanged; /* Puts that matched the image - no write */
+    uint32_t migrated;  /* Sections moved over from the per-key layout */
+    uint32_t rejected;  /* Blobs ignored at boot (version, length or CRC) */
+    uint32_t errors;    /* Failed writes */
+    uint8_t dirty;      /* Bit per section awaiting commit */
+};
+
+/* Read every section blob into the image - before identity_init() */
+void config_store_init(void);
+
+/* Copy a section out of the image; bytes copied, 0 if it was never stored */
+uint16_t config_store_get(enum config_section section, void* out, uint16_t size);
+
+/* Replace a section in the image; committed by config_store_loop() if it changed */
+void config_store_put(enum config_section section, const void* data, uint16_t len);
+
+/* Write a dirty section now; false if NVS refused it */
+bool config_store_commit(enum config_section section);
+
+/* Background work from the main loop: commits settled sections. true if it touched flash */
+bool config_store_loop(void);
+
+/* Commit every dirty section now (before reboot) */
+void config_store_flush(void);
+
+/* Drop a section from the image and from NVS */
+void config_store_erase(enum config_section section);
+
+/* Count a section moved over from the per-key layout */
+void config_store_note_migrated(enum config_section section);
+
+const struct config_store_stats* config_store_get_stats(void);
+
+#endif /* MESHGRID_CONFIG_STORE_H */
@@ -3,6 +3,7 @@
  */
 
 #include "identity.h"
+#include "config_store.h"
 #include "utils/serial_output.h"
 #include <Arduino.h>
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
@@ -17,37 +18,61 @@ extern "C" {
 /* External state from main.cpp */
 extern struct meshgrid_state mesh;
 
+/* Keypair from the per-key layout (namespace "meshgrid"); false if it holds none */
+static bool legacy_load(struct config_identity* id) {
+#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
+    Preferences prefs;
+    prefs.begin("meshgrid", true); // Read-only
+    bool found = prefs.getBool("has_identity", false) &&
+                 prefs.getBytes("pubkey", id->pubkey, MESHGRID_PUBKEY_SIZE) == MESHGRID_PUBKEY_SIZE &&
+                 prefs.getBytes("privkey", id->privkey, MESHGRID_PRIVKEY_SIZE) == MESHGRID_PRIVKEY_SIZE;
+    prefs.end();
+    return found;
+#else
+    return false;
+#endif
+}
+
+/* Drop the per-key keypair once the config store holds it */
+static void legacy_remove(void) {
+#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
+    Preferences prefs;
+    prefs.begin("meshgrid", false); // Read-write
+    prefs.remove("has_identity");
+    prefs.remove("pubkey");
+    prefs.remove("privkey");
+    prefs.end();
+#endif
+}
+
 void identity_init(void) {
     /* Initialize crypto subsystem */
     crypto_init();
 
-    /* Try to load identity from NVS first */
-    Preferences prefs;
-    prefs.begin("meshgrid", true); // Read-only
-    bool has_identity = prefs.getBool("has_identity", false);
-
-    if (has_identity) {
-        /* Load saved keypair */
-        if (prefs.getBytes("pubkey", mesh.pubkey, MESHGRID_PUBKEY_SIZE) == MESHGRID_PUBKEY_SIZE &&
-            prefs.getBytes("privkey", mesh.privkey, MESHGRID_PRIVKEY_SIZE) == MESHGRID_PRIVKEY_SIZE) {
-            /* Loaded successfully */
-        } else {
-            has_identity = false; // Load failed, regenerate
-        }
-    }
-    prefs.end();
+    /* Try to load identity from the config store first, then the old layout */
+    struct config_identity id;
+    bool has_identity = config_store_get(CONFIG_SECTION_IDENTITY, &id, sizeof(id)) == sizeof(id);
+    bool migrate = !has_identity && legacy_load(&id);
 
-    if (!has_identity) {
+    if (has_identity || migrate) {
+        memcpy(mesh.pubkey, id.pubkey, MESHGRID_PUBKEY_SIZE);
+        memcpy(mesh.privkey, id.privkey, MESHGRID_PRIVKEY_SIZE);
+    } else {
         /* Generate new Ed25519 keypair */
         crypto_generate_keypair(mesh.pubkey, mesh.privkey);
+        memcpy(id.pubkey, mesh.pubkey, MESHGRID_PUBKEY_SIZE);
+        memcpy(id.privkey, mesh.privkey, MESHGRID_PRIVKEY_SIZE);
+    }
 
-        /* Save to NVS for persistence */
-        prefs.begin("meshgrid", false); // Read-write
-        prefs.putBool("has_identity", true);
-        prefs.putBytes("pubkey", mesh.pubkey, MESHGRID_PUBKEY_SIZE);
-        prefs.putBytes("privkey", mesh.privkey, MESHGRID_PRIVKEY_SIZE);
-        prefs.end();
+    if (!has_identity) {
+        /* A new or migrated keypair is committed now - losing it changes who we are */
+        config_store_put(CONFIG_SECTION_IDENTITY, &id, sizeof(id));
+        if (config_store_commit(CONFIG_SECTION_IDENTITY) && migrate) {
+            legacy_remove();
+            config_store_note_migrated(CONFIG_SECTION_IDENTITY);
+        }
     }
+    memset(&id, 0, sizeof(id));
 
     /* Compute hash (MeshCore uses first byte of pubkey) */
     mesh.our_hash = crypto_hash_pubkey(mesh.pubkey);
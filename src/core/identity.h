@@ -8,7 +8,7 @@
 
 /**
  * Initialize identity subsystem
- * - Loads existing keypair from NVS if available
+ * - Loads existing keypair from the config store if available
  * - Generates new keypair if none exists
  * - Computes hash and generates node name
  */
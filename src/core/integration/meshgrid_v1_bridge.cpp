@@ -10,6 +10,7 @@
 #include "../messaging.h"
 #include "utils/debug.h"
 #include "utils/types.h"
+#include "core/messaging/msg_log.h"
 #include <Arduino.h>
 #include <string.h>
 
@@ -19,9 +20,6 @@ extern "C" {
 #include "../../../lib/meshgrid-v1/src/protocol/packet.h"
 #include "../../../lib/meshgrid-v1/src/discovery/bloom.h"
 #include "../../../lib/meshgrid-v1/src/discovery/trickle.h"
-
-/* Radio function */
-int16_t radio_transmit(uint8_t* data, size_t len);
 }
 
 /* External from main.cpp */
@@ -36,12 +34,6 @@ static inline uint32_t get_current_timestamp(void) {
     return millis() / 1000; /* Fallback to uptime */
 }
 
-/* External message storage */
-extern struct message_entry direct_messages[];
-extern int direct_msg_index;
-extern int direct_msg_count;
-#define DIRECT_MESSAGE_BUFFER_SIZE 10
-
 /* v1 protocol state */
 static bool v1_initialized = false;
 
@@ -91,7 +83,7 @@ int meshgrid_v1_send_text(uint16_t dest_hash_v1, const char* text, size_t len) {
         DEBUG_WARNF("[v1] Neighbor with v1_hash=0x%04x not found", dest_hash_v1);
         return -1;
     }
-    if (!neighbor->secret_valid) {
+    if (!neighbor_ensure_secret(neighbor)) {
         DEBUG_WARNF("[v1] No shared secret for hash 0x%04x (secret_valid=false)", dest_hash_v1);
         return -1;
     }
@@ -102,6 +94,7 @@ int meshgrid_v1_send_text(uint16_t dest_hash_v1, const char* text, size_t len) {
     uint32_t sequence = neighbor->next_seq_tx++;
     if (neighbor->next_seq_tx == 0)
         neighbor->next_seq_tx = 1; /* Skip 0 */
+    neighbors_mark_dirty();
 
     /* Generate nonce */
     uint8_t nonce[12];
@@ -161,16 +154,9 @@ int meshgrid_v1_send_text(uint16_t dest_hash_v1, const char* text, size_t len) {
     memcpy(&packet[pkt_pos], tag, 16);
     pkt_pos += 16;
 
-    /* Transmit */
+    /* Queue for transmit (listen-before-talk and duty cycle run there) */
     DEBUG_INFOF("[v1] Sending text to 0x%04x, seq=%lu, len=%d", dest_hash_v1, sequence, pkt_pos);
-    int result = radio_transmit(packet, pkt_pos);
-
-    if (result == 0) {
-        mesh.packets_tx++;
-        return 0;
-    }
-
-    return -1;
+    return tx_queue_add(packet, pkt_pos, 0, 5) ? 0 : -1;
 }
 
 /**
@@ -252,35 +238,23 @@ int meshgrid_v1_send_channel(uint8_t channel_hash, const char* text, size_t len)
     memcpy(&packet[pkt_pos], tag, 16);
     pkt_pos += 16;
 
-    /* Transmit */
+    /* Queue for transmit (listen-before-talk and duty cycle run there) */
     DEBUG_INFOF("[v1] Sending channel msg to 0x%02x, len=%d", channel_hash, pkt_pos);
-    int result = radio_transmit(packet, pkt_pos);
-
-    if (result == 0) {
-        mesh.packets_tx++;
-        return 0;
-    }
-
-    return -1;
+    return tx_queue_add(packet, pkt_pos, 0, 5) ? 0 : -1;
 }
 
 /**
  * Process received v1 packet
  */
-int meshgrid_v1_process_packet(const uint8_t* packet, size_t len, int16_t rssi, int8_t snr) {
+int meshgrid_v1_process_packet(const struct meshgrid_packet_view* pkt) {
     if (!v1_initialized) {
         meshgrid_v1_bridge_init(); /* Auto-initialize on first use */
     }
 
-    if (len < 1) {
-        return -1;
-    }
-
-    /* Parse header */
-    uint8_t header = packet[0];
-    uint8_t version = MESHGRID_GET_VERSION(header);
-    uint8_t payload_type = MESHGRID_GET_TYPE(header);
-    uint8_t route_type = MESHGRID_GET_ROUTE(header);
+    /* Header fields were parsed once by the caller */
+    uint8_t version = pkt->version;
+    uint8_t payload_type = pkt->payload_type;
+    uint8_t route_type = pkt->route_type;
 
     /* Check if this is a v1 packet */
     if (version != 1) {
@@ -293,17 +267,18 @@ int meshgrid_v1_process_packet(const uint8_t* packet, size_t len, int16_t rssi,
         return -1;
     }
 
-    /* Parse v1 packet: [header][nonce(12)][ciphertext][tag(16)] */
-    if (len < 1 + 12 + 8 + 16) { /* header + nonce + min_payload + tag */
+    /* Parse v1 packet: [header][nonce(12)][ciphertext][tag(16)] - the view's payload starts at the nonce */
+    if (pkt->payload_len < 12 + 8 + 16) { /* nonce + min_payload + tag */
         DEBUG_WARN("[v1] Packet too short");
         return -1;
     }
 
-    int pos = 1;
+    const uint8_t* packet = pkt->payload;
+    int pos = 0;
     const uint8_t* nonce = &packet[pos];
     pos += 12;
 
-    int ciphertext_len = len - pos - 16;
+    int ciphertext_len = pkt->payload_len - pos - 16;
     if (ciphertext_len <= 0) {
         return -1;
     }
@@ -324,15 +299,17 @@ int meshgrid_v1_process_packet(const uint8_t* packet, size_t len, int16_t rssi,
         DEBUG_INFOF("[v1] RX: Direct message, trying to decrypt with %d neighbors", neighbor_count);
         int tried = 0;
         for (int i = 0; i < neighbor_count && !decrypted; i++) {
-            if (!neighbors[i].secret_valid) {
-                DEBUG_INFOF("[v1] RX: Skip neighbor %d (hash=0x%02x) - secret_valid=false", i, neighbors[i].hash);
-                continue;
-            }
             if (neighbors[i].protocol_version < 1) {
                 DEBUG_INFOF("[v1] RX: Skip neighbor %d (hash=0x%02x) - protocol_version=%d", i, neighbors[i].hash,
                             neighbors[i].protocol_version);
                 continue;
             }
+            /* Deriving here would run every pending ECDH on the RX path for frames
+             * that may not even be ours - neighbors_derive_step() catches up instead */
+            if (!neighbors[i].secret_valid) {
+                DEBUG_INFOF("[v1] RX: Skip neighbor %d (hash=0x%02x) - secret_valid=false", i, neighbors[i].hash);
+                continue;
+            }
 
             DEBUG_INFOF("[v1] RX: Trying neighbor %d (hash=0x%02x, name=%s)", i, neighbors[i].hash, neighbors[i].name);
             tried++;
@@ -403,7 +380,10 @@ int meshgrid_v1_process_packet(const uint8_t* packet, size_t len, int16_t rssi,
             DEBUG_WARNF("[v1] Replay detected: seq=%lu <= last=%lu", sequence, sender->last_seq_rx);
             return -1;
         }
+        /* Skipped sequence numbers are messages that never reached us */
+        link_quality_note_seq(&sender->link, sender->last_seq_rx, sequence);
         sender->last_seq_rx = sequence;
+        neighbors_mark_dirty();
 
         /* Extract text */
         int text_len = ciphertext_len - pos;
@@ -415,22 +395,8 @@ int meshgrid_v1_process_packet(const uint8_t* packet, size_t len, int16_t rssi,
         strncpy(sender_name, sender->name, 16);
         sender_name[16] = '\0';
 
-        /* Store in direct messages */
-        int idx = direct_msg_index;
-        direct_messages[idx].valid = true;
-        direct_messages[idx].decrypted = true;
-        direct_messages[idx].timestamp = timestamp; /* Use sender's timestamp */
-        direct_messages[idx].sender_hash = sender->hash;
-        direct_messages[idx].channel_hash = 0;     /* 0 = direct message */
-        direct_messages[idx].protocol_version = 1; /* v1 protocol */
-        strncpy(direct_messages[idx].sender_name, sender_name, 16);
-        direct_messages[idx].sender_name[16] = '\0';
-        strncpy(direct_messages[idx].text, text_buf, 127);
-        direct_messages[idx].text[127] = '\0';
-
-        direct_msg_index = (direct_msg_index + 1) % DIRECT_MESSAGE_BUFFER_SIZE;
-        if (direct_msg_count < DIRECT_MESSAGE_BUFFER_SIZE)
-            direct_msg_count++;
+        /* Store in direct messages (sender's timestamp, v1 protocol) */
+        msg_log_store(INBOX_DIRECT, sender->hash, 0, 1, timestamp, sender_name, text_buf);
 
     } else if (payload_type == PAYLOAD_GRP_TXT) {
         /* Channel message: [channel_hash(1)][src_hash(2)][timestamp(4)][text] */
@@ -463,12 +429,7 @@ int meshgrid_v1_process_packet(const uint8_t* packet, size_t len, int16_t rssi,
         memcpy(text_buf, &plaintext[pos], text_len);
         text_buf[text_len] = '\0';
 
-        /* Store in channel messages */
-        extern struct message_entry channel_messages[][CHANNEL_MESSAGE_BUFFER_SIZE];
-        extern int channel_msg_count[];
-        extern int channel_msg_index[];
-
-        /* Find channel index */
+        /* Store in channel messages - find channel index */
         extern struct channel_entry custom_channels[];
         extern int custom_channel_count;
         int ch_idx = -1;
@@ -480,21 +441,8 @@ int meshgrid_v1_process_packet(const uint8_t* packet, size_t len, int16_t rssi,
         }
 
         if (ch_idx >= 0) {
-            int idx = channel_msg_index[ch_idx];
-            channel_messages[ch_idx][idx].valid = true;
-            channel_messages[ch_idx][idx].decrypted = true;
-            channel_messages[ch_idx][idx].timestamp = timestamp; /* Use sender's timestamp */
-            channel_messages[ch_idx][idx].sender_hash = sender ? sender->hash : (src_hash & 0xFF);
-            channel_messages[ch_idx][idx].channel_hash = channel_hash;
-            channel_messages[ch_idx][idx].protocol_version = 1; /* v1 protocol */
-            strncpy(channel_messages[ch_idx][idx].sender_name, sender_name, 16);
-            channel_messages[ch_idx][idx].sender_name[16] = '\0';
-            strncpy(channel_messages[ch_idx][idx].text, text_buf, 127);
-            channel_messages[ch_idx][idx].text[127] = '\0';
-
-            channel_msg_index[ch_idx] = (channel_msg_index[ch_idx] + 1) % CHANNEL_MESSAGE_BUFFER_SIZE;
-            if (channel_msg_count[ch_idx] < CHANNEL_MESSAGE_BUFFER_SIZE)
-                channel_msg_count[ch_idx]++;
+            msg_log_store(INBOX_CHANNEL(ch_idx), sender ? sender->hash : (src_hash & 0xFF), channel_hash, 1,
+                          timestamp, sender_name, text_buf);
         }
     }
 
@@ -18,6 +18,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "network/packet_view.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -58,14 +60,11 @@ int meshgrid_v1_send_channel(uint8_t channel_hash, const char* text, size_t len)
  *
  * Called by radio RX handler when v1 packet detected.
  *
- * @param packet  Raw packet data
- * @param len     Packet length
- * @param rssi    Signal strength
- * @param snr     Signal-to-noise ratio
+ * @param pkt  Frame parsed in place, with RSSI/SNR (payload = nonce, ciphertext, tag)
  *
  * @return 0 if handled, -1 if not a v1 packet
  */
-int meshgrid_v1_process_packet(const uint8_t* packet, size_t len, int16_t rssi, int8_t snr);
+int meshgrid_v1_process_packet(const struct meshgrid_packet_view* pkt);
 
 /**
  * Check if neighbor supports v1 protocol
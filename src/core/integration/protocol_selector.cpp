@@ -13,6 +13,10 @@
 #include "meshgrid_v1_bridge.h"
 #include "../meshcore_integration.h"
 
+extern "C" {
+#include "network/protocol.h"
+}
+
 /**
  * Initialize protocol selector
  */
@@ -61,8 +65,15 @@ int protocol_selector_send_channel(uint8_t channel_hash, const char* text, size_
  * Process received packet (try v1 first, fall back to v0)
  */
 int protocol_selector_process_packet(const uint8_t* packet, size_t len, int16_t rssi, int8_t snr) {
+    struct meshgrid_packet_view view;
+    if (meshgrid_view_parse(packet, len, &view) != 0) {
+        return -1;
+    }
+    view.rssi = rssi;
+    view.snr = snr;
+
     /* Try v1 first */
-    int result = meshgrid_v1_process_packet(packet, len, rssi, snr);
+    int result = meshgrid_v1_process_packet(&view);
     if (result == 0) {
         return 0; /* v1 handled it */
     }
@@ -22,8 +22,8 @@ void meshcore_bridge_handle_packet(uint8_t* buf, int len, int16_t rssi, int8_t s
     MeshCoreIntegration::handle_received_packet(buf, len, rssi, snr);
 }
 
-void meshcore_bridge_send_text(uint8_t dest_hash, const char* text) {
-    MeshCoreIntegration::send_text_message(dest_hash, text);
+int meshcore_bridge_send_text(uint8_t dest_hash, const char* text) {
+    return MeshCoreIntegration::send_text_message(dest_hash, text);
 }
 
 void meshcore_bridge_send_channel(uint8_t channel_hash, const uint8_t* channel_secret, const char* text,
@@ -30,10 +30,16 @@ void meshcore_bridge_loop(void);
  */
 void meshcore_bridge_handle_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr);
 
+/* meshcore_bridge_send_text() results (MESHGRID_SEND_* in MeshgridAdapter.h) */
+#define MESHCORE_SEND_OK 0
+#define MESHCORE_SEND_FAILED (-1)
+#define MESHCORE_SEND_UNREACHABLE (-2) /* Not flooded: no route and no neighbor's filter has it */
+
 /**
  * Send direct text message
+ * Returns MESHCORE_SEND_*
  */
-void meshcore_bridge_send_text(uint8_t dest_hash, const char* text);
+int meshcore_bridge_send_text(uint8_t dest_hash, const char* text);
 
 /**
  * Send channel message
@@ -7,12 +7,20 @@ extern "C" {
 #include "network/protocol.h"
 #include "hardware/crypto/crypto.h"
 #include "core/mesh_accessor.h"
+#include "radio/radio_lbt.h"
+#include "network/route_cache.h"
+#include "network/reachability.h"
+#include "network/geo.h"
+#include "core/messaging/inbox.h"
 
 // Radio functions from radio_api.cpp
 int16_t radio_transmit(uint8_t* data, size_t len);
 int16_t radio_start_receive(void);
 }
 
+#include "core/messaging/msg_log.h"
+#include "utils/arena.h"
+
 // External globals from main.cpp
 extern bool radio_in_rx_mode;
 extern void led_blink(void);
@@ -24,16 +32,9 @@ extern void led_blink(void);
 #include "utils/debug.h"
 #include "utils/types.h"
 #include "utils/memory.h"
+#include "utils/role.h"
 #include "../radio/radio_hal.h"
 
-// Message storage (from main.cpp) - declare after includes so constants are defined
-extern struct message_entry direct_messages[];
-extern int direct_msg_index, direct_msg_count;
-extern struct message_entry public_messages[];
-extern int public_msg_index, public_msg_count;
-extern struct message_entry channel_messages[][CHANNEL_MESSAGE_BUFFER_SIZE];
-extern int channel_msg_index[];
-extern int channel_msg_count[];
 extern uint8_t public_channel_hash;
 extern uint8_t public_channel_secret[32];
 extern struct channel_entry custom_channels[];
@@ -67,9 +68,16 @@ MeshgridCallbacks callbacks = {.get_shared_secret = callback_get_shared_secret,
                                .find_channel_by_hash = callback_find_channel_by_hash,
                                .radio_transmit = callback_radio_transmit,
                                .radio_start_receive = callback_radio_start_receive,
+                               .channel_acquire = callback_channel_acquire,
                                .led_blink = callback_led_blink,
-                               .increment_tx = callback_increment_tx,
-                               .increment_rx = callback_increment_rx};
+                               .increment_tx = nullptr, /* radio_transmit_now() counts frames on air */
+                               .increment_rx = callback_increment_rx,
+                               .route_learn = callback_route_learn,
+                               .route_lookup = callback_route_lookup,
+                               .route_expect_ack = callback_route_expect_ack,
+                               .route_ack = callback_route_ack,
+                               .dest_unreachable = callback_dest_unreachable,
+                               .update_position = callback_update_position};
 
 // ========================================================================
 // Callback Implementations
@@ -90,49 +98,23 @@ void callback_update_neighbor(const uint8_t* pubkey, const char* name, uint32_t
 }
 
 void callback_store_direct_message(const char* sender_name, uint8_t sender_hash, const char* text, uint32_t timestamp) {
-    int idx = direct_msg_index;
-    direct_messages[idx].valid = true;
-    direct_messages[idx].decrypted = true;
-    direct_messages[idx].sender_hash = sender_hash;
-    direct_messages[idx].channel_hash = 0;
-    direct_messages[idx].protocol_version = 0;
-    direct_messages[idx].timestamp = timestamp;
-
-    strncpy(direct_messages[idx].sender_name, sender_name, 16);
-    direct_messages[idx].sender_name[16] = '\0';
-
-    strncpy(direct_messages[idx].text, text, 127);
-    direct_messages[idx].text[127] = '\0';
-
-    direct_msg_index = (direct_msg_index + 1) % DIRECT_MESSAGE_BUFFER_SIZE;
-    if (direct_msg_count < DIRECT_MESSAGE_BUFFER_SIZE)
-        direct_msg_count++;
+    msg_log_store(INBOX_DIRECT, sender_hash, 0, 0, timestamp, sender_name, text);
 
     DEBUG_INFOF("RX MSG v0 from %s: %s", sender_name, text);
 }
 
 void callback_store_channel_message(uint8_t channel_hash, const char* sender_name, const char* text,
                                     uint32_t timestamp) {
+#if !MESHGRID_ROLE_CHAT
+    /* No channel inbox in this role */
+    (void)channel_hash;
+    (void)sender_name;
+    (void)text;
+    (void)timestamp;
+#else
     // Check if this is the public channel
     if (channel_hash == public_channel_hash) {
-        // Store in public messages buffer
-        int idx = public_msg_index;
-        public_messages[idx].valid = true;
-        public_messages[idx].decrypted = true;
-        public_messages[idx].sender_hash = 0;
-        public_messages[idx].channel_hash = channel_hash;
-        public_messages[idx].protocol_version = 0;
-        public_messages[idx].timestamp = timestamp;
-
-        strncpy(public_messages[idx].sender_name, sender_name, 16);
-        public_messages[idx].sender_name[16] = '\0';
-
-        strncpy(public_messages[idx].text, text, 127);
-        public_messages[idx].text[127] = '\0';
-
-        public_msg_index = (public_msg_index + 1) % PUBLIC_MESSAGE_BUFFER_SIZE;
-        if (public_msg_count < PUBLIC_MESSAGE_BUFFER_SIZE)
-            public_msg_count++;
+        msg_log_store(INBOX_PUBLIC, 0, channel_hash, 0, timestamp, sender_name, text);
 
         DEBUG_INFOF("RX GRP v0 [Public] %s: %s", sender_name, text);
     } else {
@@ -146,30 +128,14 @@ void callback_store_channel_message(uint8_t channel_hash, const char* sender_nam
         }
 
         if (channel_idx >= 0) {
-            // Store in custom channel messages buffer
-            int idx = channel_msg_index[channel_idx];
-            channel_messages[channel_idx][idx].valid = true;
-            channel_messages[channel_idx][idx].decrypted = true;
-            channel_messages[channel_idx][idx].sender_hash = 0;
-            channel_messages[channel_idx][idx].channel_hash = channel_hash;
-            channel_messages[channel_idx][idx].protocol_version = 0;
-            channel_messages[channel_idx][idx].timestamp = timestamp;
-
-            strncpy(channel_messages[channel_idx][idx].sender_name, sender_name, 16);
-            channel_messages[channel_idx][idx].sender_name[16] = '\0';
-
-            strncpy(channel_messages[channel_idx][idx].text, text, 127);
-            channel_messages[channel_idx][idx].text[127] = '\0';
-
-            channel_msg_index[channel_idx] = (channel_msg_index[channel_idx] + 1) % CHANNEL_MESSAGE_BUFFER_SIZE;
-            if (channel_msg_count[channel_idx] < CHANNEL_MESSAGE_BUFFER_SIZE)
-                channel_msg_count[channel_idx]++;
+            msg_log_store(INBOX_CHANNEL(channel_idx), 0, channel_hash, 0, timestamp, sender_name, text);
 
             DEBUG_INFOF("RX GRP v0 [%s] %s: %s", custom_channels[channel_idx].name, sender_name, text);
         } else {
             DEBUG_WARNF("RX GRP v0: Unknown channel 0x%02x, message dropped", channel_hash);
         }
     }
+#endif
 }
 
 int16_t callback_radio_transmit(uint8_t* data, size_t len) {
@@ -181,18 +147,50 @@ int16_t callback_radio_start_receive() {
     return radio_start_receive();
 }
 
-void callback_led_blink() {
-    ::led_blink();
+uint32_t callback_channel_acquire() {
+#ifdef ENABLE_RADIO_TASK
+    // The radio task runs LBT for every frame it transmits
+    return 0;
+#else
+    // Dispatcher sends one packet at a time, so one access session suffices
+    static struct lbt_session session = {0, 0, false};
+    return lbt_acquire(&session, millis());
+#endif
 }
 
-void callback_increment_tx() {
-    mesh_increment_tx();
+void callback_led_blink() {
+    ::led_blink();
 }
 
 void callback_increment_rx() {
     mesh_increment_rx();
 }
 
+void callback_route_learn(uint8_t dest_hash, const uint8_t* path, uint8_t path_len, int8_t snr_x4) {
+    route_cache_learn(dest_hash, path, path_len, snr_x4, millis());
+}
+
+int callback_route_lookup(uint8_t dest_hash, uint8_t* path) {
+    return route_cache_lookup(dest_hash, path, millis());
+}
+
+void callback_route_expect_ack(uint8_t dest_hash, uint32_t ack_crc, const uint8_t* path, int path_len) {
+    route_cache_expect_ack(dest_hash, ack_crc, path, path_len, millis());
+}
+
+int callback_route_ack(uint32_t ack_crc) {
+    return route_cache_ack(ack_crc, millis());
+}
+
+bool callback_dest_unreachable(uint8_t dest_hash) {
+    return reach_within(dest_hash, REACH_ANY_HOPS, millis()) == REACH_NO;
+}
+
+void callback_update_position(uint8_t hash, int32_t lat_e6, int32_t lon_e6, uint8_t hops) {
+    struct meshgrid_position pos = {.lat_e6 = lat_e6, .lon_e6 = lon_e6, .valid = true};
+    geo_note(hash, &pos, hops, millis());
+}
+
 int callback_find_channel_by_hash(uint8_t hash, mesh::GroupChannel channels[], int max_matches) {
     int found = 0;
 
@@ -224,17 +222,18 @@ int callback_find_channel_by_hash(uint8_t hash, mesh::GroupChannel channels[], i
 void initialize() {
     DEBUG_INFO("Initializing MeshCore v0...");
 
-    // Create adapter instances
-    radio_adapter = new MeshgridRadio(&callbacks);
-    clock_adapter = new MeshgridClock();
-    rng_adapter = new MeshgridRNG();
-    rtc_adapter = new MeshgridRTC();
-    packet_manager = new MeshgridPacketManager();
-    tables_adapter = new MeshgridTables();
+    // Create adapter instances (boot arena - they live as long as the node)
+    radio_adapter = arena_new<MeshgridRadio>(ARENA_HOT, "mc_radio", &callbacks);
+    clock_adapter = arena_new<MeshgridClock>(ARENA_HOT, "mc_clock");
+    rng_adapter = arena_new<MeshgridRNG>(ARENA_HOT, "mc_rng");
+    rtc_adapter = arena_new<MeshgridRTC>(ARENA_HOT, "mc_rtc");
+    packet_manager = arena_new<MeshgridPacketManager>(ARENA_HOT, "mc_packets");
+    tables_adapter = arena_new<MeshgridTables>(ARENA_HOT, "mc_tables");
+    route_cache_init();
 
     // Create mesh instance
-    mesh_v0 = new MeshgridMesh(*radio_adapter, *clock_adapter, *rng_adapter, *rtc_adapter, *packet_manager,
-                               *tables_adapter, &callbacks, radio_adapter);
+    mesh_v0 = arena_new<MeshgridMesh>(ARENA_HOT, "mc_mesh", *radio_adapter, *clock_adapter, *rng_adapter,
+                                      *rtc_adapter, *packet_manager, *tables_adapter, &callbacks, radio_adapter);
 
     // Initialize mesh
     mesh_v0->begin();
@@ -249,6 +248,7 @@ void initialize() {
 void loop() {
     if (mesh_v0) {
         mesh_v0->loop();
+        route_cache_tick(millis());
     }
 }
 
@@ -257,7 +257,7 @@ void handle_received_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr) {
         return;
 
     // Notify radio adapter of reception
-    radio_adapter->notifyPacketReceived((float)rssi, (float)snr);
+    radio_adapter->notifyPacketReceived(rssi, snr);
 
     // Parse packet
     mesh::Packet* pkt = packet_manager->allocNew();
@@ -286,10 +286,15 @@ void handle_received_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr) {
 // Public API
 // ========================================================================
 
-void send_text_message(uint8_t dest_hash, const char* text) {
-    if (mesh_v0) {
-        mesh_v0->sendTextMessage(dest_hash, text);
+int send_text_message(uint8_t dest_hash, const char* text) {
+    if (!mesh_v0) {
+        return MESHGRID_SEND_FAILED;
     }
+    int result = mesh_v0->sendTextMessage(dest_hash, text);
+    if (result == MESHGRID_SEND_UNREACHABLE) {
+        reach_note_suppressed();
+    }
+    return result;
 }
 
 void send_channel_message(uint8_t channel_hash, const uint8_t* channel_secret, const char* text,
@@ -306,12 +311,21 @@ void send_advert() {
         uint8_t app_data[32];
         int i = 0;
 
+        // Fixed installs advertise their position (0x10 = lat/lon, before feat1)
+        const struct meshgrid_position* pos = geo_get_self();
+        uint8_t latlon = pos->valid ? 0x10 : 0x00;
+
         // Flags byte: 0x80 (name) | 0x20 (feat1) | 0x01 (chat/client)
         // Use feat1 field to signal v1 capability instead of bit 0x08
         // This fixes MeshCore app compatibility (type must be 0-4, not 9)
 #if PROTOCOL_V1_ENABLED
-        uint8_t flags = 0x80 | 0x20 | 0x01; // 0xA1 = name + feat1 + chat
+        uint8_t flags = 0x80 | 0x20 | 0x01 | latlon; // 0xA1 = name + feat1 + chat
         app_data[i++] = flags;
+        if (pos->valid) {
+            memcpy(&app_data[i], &pos->lat_e6, 4);
+            memcpy(&app_data[i + 4], &pos->lon_e6, 4);
+            i += 8;
+        }
 
         // feat1 field (2 bytes): bit 0 = v1 capable
         app_data[i++] = 0x01; // v1 capability bit
@@ -320,8 +334,13 @@ void send_advert() {
         DEBUG_INFOF("[MeshCore] Creating advert with name: %s (flags=0x%02x, feat1=0x0001, v1=yes, len=%d)",
                     mesh_get_name(), flags, i);
 #else
-        uint8_t flags = 0x80 | 0x01; // 0x81 = name + chat (no v1)
+        uint8_t flags = 0x80 | 0x01 | latlon; // 0x81 = name + chat (no v1)
         app_data[i++] = flags;
+        if (pos->valid) {
+            memcpy(&app_data[i], &pos->lat_e6, 4);
+            memcpy(&app_data[i + 4], &pos->lon_e6, 4);
+            i += 8;
+        }
 
         DEBUG_INFOF("[MeshCore] Creating advert with name: %s (flags=0x%02x, v1=no, len=%d)", mesh_get_name(), flags,
                     i);
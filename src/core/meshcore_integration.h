@@ -14,7 +14,6 @@
 // Forward declarations of meshgrid types
 struct meshgrid_state;
 struct meshgrid_neighbor;
-struct message_entry;
 
 // Callback implementations for MeshCore integration
 namespace MeshCoreIntegration {
@@ -68,16 +67,17 @@ int16_t callback_radio_transmit(uint8_t* data, size_t len);
 int16_t callback_radio_start_receive();
 
 /**
-     * Blink LED for feedback
-     * Called by MeshCore on successful transmission
+     * Listen-before-talk channel check
+     * Called by MeshCore's Dispatcher before each send
+     * Returns 0 when clear to send, otherwise the backoff in ms
      */
-void callback_led_blink();
+uint32_t callback_channel_acquire();
 
 /**
-     * Increment TX counter
-     * Called by MeshCore after successful transmission
+     * Blink LED for feedback
+     * Called by MeshCore on successful transmission
      */
-void callback_increment_tx();
+void callback_led_blink();
 
 /**
      * Increment RX counter
@@ -85,6 +85,17 @@ void callback_increment_tx();
      */
 void callback_increment_rx();
 
+/**
+     * Route cache hooks
+     * Called by MeshCore to learn, look up and confirm direct routes
+     */
+void callback_route_learn(uint8_t dest_hash, const uint8_t* path, uint8_t path_len, int8_t snr_x4);
+int callback_route_lookup(uint8_t dest_hash, uint8_t* path);
+void callback_route_expect_ack(uint8_t dest_hash, uint32_t ack_crc, const uint8_t* path, int path_len);
+int callback_route_ack(uint32_t ack_crc);
+bool callback_dest_unreachable(uint8_t dest_hash);
+void callback_update_position(uint8_t hash, int32_t lat_e6, int32_t lon_e6, uint8_t hops);
+
 // ========================================================================
 // Adapter Instances (Global)
 // ========================================================================
@@ -130,8 +141,9 @@ void handle_received_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr);
      *
      * @param dest_hash Destination node hash (1 byte)
      * @param text Message text (null-terminated)
+     * @return MESHGRID_SEND_* result
      */
-void send_text_message(uint8_t dest_hash, const char* text);
+int send_text_message(uint8_t dest_hash, const char* text);
 
 /**
      * Send channel text message via MeshCore
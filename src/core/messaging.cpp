@@ -6,6 +6,7 @@
 #include "messaging/utils.h"
 #include "messaging/receive.h"
 #include "messaging/send.h"
+#include "messaging/forward.h"
 #include "neighbors.h"
 #include "utils/memory.h"
 #include "utils/types.h"
@@ -26,6 +27,9 @@ extern "C" {
 #include "hardware/crypto/crypto.h"
 #include "utils/cobs.h"
 #include "core/meshcore_bridge.h"
+#include "network/reachability.h"
+#include "network/mpr.h"
+#include "network/geo.h"
 }
 
 /* Externs from main.cpp - structs defined in lib/types.h */
@@ -36,25 +40,11 @@ extern uint32_t boot_time;
 extern struct rtc_time_t rtc_time;
 extern struct display_state display_state;
 extern uint32_t last_activity_time;
-extern enum meshgrid_device_mode device_mode;
 
 extern struct channel_entry custom_channels[MAX_CUSTOM_CHANNELS];
 extern int custom_channel_count;
 
-extern struct message_entry public_messages[PUBLIC_MESSAGE_BUFFER_SIZE];
-extern int public_msg_index, public_msg_count;
-
-extern struct message_entry direct_messages[DIRECT_MESSAGE_BUFFER_SIZE];
-extern int direct_msg_index, direct_msg_count;
-
-extern struct message_entry channel_messages[MAX_CUSTOM_CHANNELS][CHANNEL_MESSAGE_BUFFER_SIZE];
-extern int channel_msg_index[MAX_CUSTOM_CHANNELS];
-extern int channel_msg_count[MAX_CUSTOM_CHANNELS];
-
-extern struct seen_entry seen_table[];
-extern uint8_t seen_idx;
-
-extern uint32_t stat_duplicates, stat_flood_fwd, stat_flood_rx;
+extern uint32_t stat_flood_rx;
 
 extern uint8_t public_channel_secret[32];
 extern uint8_t public_channel_hash;
@@ -65,14 +55,100 @@ extern void led_blink(void);
 /* Radio RX state tracking (from main.cpp) */
 extern bool radio_in_rx_mode;
 
+/*
+ * TRACE reached us as the last hop - answer with the hops' SNRs
+ * Out of line, like trace_report(): their buffers stay off the stack of
+ * every other frame process_packet() handles.
+ */
+static __attribute__((noinline)) void trace_reply(const struct meshgrid_packet_view* pkt, uint32_t trace_id,
+                                                  int8_t snr) {
+    struct meshgrid_packet response;
+    memset(&response, 0, sizeof(response));
+
+    /* Use ROUTE_FLOOD for response since path contains SNRs, not hashes */
+    response.route_type = ROUTE_FLOOD;
+    response.payload_type = PAYLOAD_PATH;
+    response.version = PAYLOAD_VER_MESHCORE;
+    response.header = MESHGRID_MAKE_HEADER(response.route_type, response.payload_type, response.version);
+
+    /* SECURITY FIX: Bounds check to prevent buffer overflow */
+    if (6 + pkt->path_len > MESHGRID_MAX_PAYLOAD_SIZE) {
+        /* Path too long for response packet - reject */
+        return;
+    }
+
+    /* Copy trace ID */
+    memcpy(&response.payload[0], &trace_id, 4);
+
+    /* Copy path (hop count and SNRs) */
+    response.payload[4] = pkt->path_len;
+    for (int j = 0; j < pkt->path_len && j < 32; j++) {
+        response.payload[5 + j] = pkt->path[j];
+    }
+
+    /* Add our SNR at the end (MeshCore format: SNR * 4) */
+    int8_t snr_value = (int8_t)(snr * 4);
+    response.payload[5 + pkt->path_len] = (uint8_t)snr_value;
+    response.payload_len = 6 + pkt->path_len;
+
+    /* ROUTE_FLOOD will build its own path as it propagates back */
+    response.path_len = 0;
+
+    /* Encode and send response */
+    uint8_t tx_buf[MESHGRID_MAX_PACKET_SIZE];
+    int tx_len = meshgrid_packet_encode(&response, tx_buf, sizeof(tx_buf));
+    if (tx_len > 0) {
+        tx_queue_add(tx_buf, tx_len, 0, 5);
+
+        DEBUG_INFOF("TRACE dest reached (hops: %d)", pkt->path_len);
+    }
+}
+
+/* Trace response for us - report it to the host */
+static __attribute__((noinline)) void trace_report(const struct meshgrid_packet_view* pkt, int16_t rssi, int8_t snr) {
+    uint32_t trace_id;
+    memcpy(&trace_id, &pkt->payload[0], 4);
+    uint8_t hop_count = pkt->payload[4];
+
+    /* Build JSON response (fixed buffer - this runs on the RX path) */
+    char json[384]; /* Worst case, 32 hops: ~340 bytes */
+    int len = snprintf(json, sizeof(json), "{\"type\":\"trace_response\",\"trace_id\":%lu,\"hops\":%u,\"path\":[",
+                       (unsigned long)trace_id, hop_count);
+
+    for (int i = 0; i < hop_count && i < 32; i++) {
+        len += snprintf(json + len, sizeof(json) - len, "%s\"0x%x\"", i > 0 ? "," : "", pkt->payload[5 + i]);
+    }
+
+    len += snprintf(json + len, sizeof(json) - len, "],\"rssi\":%d,\"snr\":%d", rssi, snr);
+
+    /* Calculate RTT if we can */
+    uint32_t now = millis();
+    uint32_t rtt = now - trace_id;
+    if (rtt < 60000) { /* Only show if < 60 seconds */
+        len += snprintf(json + len, sizeof(json) - len, ",\"rtt_ms\":%lu", (unsigned long)rtt);
+    }
+
+    len += snprintf(json + len, sizeof(json) - len, "}");
+
+    /* Send as COBS frame */
+    uint8_t encoded[512];
+    size_t encoded_len = cobs_encode(encoded, (const uint8_t*)json, len);
+    Serial.write(encoded, encoded_len);
+    Serial.write((uint8_t)0); /* COBS frame delimiter */
+    Serial.flush();
+
+    DEBUG_INFOF("TRACE response: %d hops", hop_count);
+}
+
 /* ========================================================================= */
 /* Main Packet Dispatcher                                                   */
 /* ========================================================================= */
 
-void process_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr) {
-    struct meshgrid_packet pkt;
+void process_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr, uint32_t rx_time_us) {
+    /* Parsed once, in place - every consumer below reads the RX buffer through this view */
+    struct meshgrid_packet_view pkt;
 
-    if (meshgrid_packet_parse(buf, len, &pkt) != 0) {
+    if (meshgrid_view_parse(buf, len, &pkt) != 0) {
         DEBUG_INFO("[ERR] Bad packet");
         mesh.packets_dropped++;
         return;
@@ -80,49 +156,63 @@ void process_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr) {
 
     pkt.rssi = rssi;
     pkt.snr = snr;
-    pkt.rx_time = millis();
+    /* Arrival time, not processing time - the frame may have waited in the RX FIFO */
+    pkt.rx_time = millis() - (micros() - rx_time_us) / 1000;
     mesh.packets_rx++;
     stat_flood_rx++;
 
-    /* Check for duplicates */
-    if (seen_check_and_add(&pkt)) {
-        return; /* Already processed */
+    /* Every copy measures the link to whoever sent it - duplicates included */
+    int tx_hash = meshgrid_transmitter_hash(&pkt);
+    if (tx_hash >= 0) {
+        neighbor_note_frame((uint8_t)tx_hash, rssi, snr);
+        reach_note_neighbor((uint8_t)tx_hash, pkt.rx_time);
+        mpr_note_neighbor((uint8_t)tx_hash, pkt.rx_time);
+        geo_note_neighbor((uint8_t)tx_hash, pkt.rx_time);
     }
 
-    /* SECURITY: Rate limiting - extract source hash */
-    uint8_t source_hash = 0;
-    if (pkt.route_type == ROUTE_FLOOD && pkt.path_len > 0) {
-        /* For flood packets, source is last hop in path */
-        source_hash = pkt.path[pkt.path_len - 1];
-    } else if (pkt.payload_type == PAYLOAD_ADVERT && pkt.payload_len >= 32) {
-        /* For adverts, hash the public key */
-        source_hash = crypto_hash_pubkey(&pkt.payload[0]);
-    } else if ((pkt.payload_type == PAYLOAD_TXT_MSG || pkt.payload_type == PAYLOAD_GRP_TXT) && pkt.payload_len >= 2) {
-        /* For messages, source hash is in payload[1] */
-        source_hash = pkt.payload[1];
+    /* Header-only triage: frames neither for us nor ours to relay stop here */
+    enum meshgrid_rx_class rx = forward_classify(&pkt);
+    if (rx == RX_DROP) {
+        return;
     }
 
-    /* Check rate limit (skip for ACKs to prevent legitimate traffic blocking) */
-    if (pkt.payload_type != PAYLOAD_ACK && source_hash != 0) {
-        if (rate_limit_check(source_hash)) {
-            /* SECURITY: Rate limit exceeded - drop packet */
-            DEBUG_WARNF("RATE LIMIT: Dropped packet from 0x%02X (DoS protection)", source_hash);
-            mesh.packets_dropped++;
-            return;
+    /* Duplicates and sources over their rate are dropped here, whatever their version */
+    if (!forward_admit(&pkt)) {
+        return;
+    }
+
+    /* Relay traffic: nothing for us inside, skip MeshCore and the v1 decrypt */
+    if (rx == RX_FORWARD_ONLY) {
+        forward_packet(&pkt);
+        return;
+    }
+
+    /* v1 neighborhood advert: a direct neighbor's Bloom filter and MPR tail, never relayed */
+    if (pkt.version == PAYLOAD_VER_MESHGRID && pkt.payload_type == PAYLOAD_ADVERT) {
+        if (pkt.route_type == ROUTE_DIRECT && pkt.path_len == 0) {
+            reach_merge(pkt.payload, pkt.payload_len, pkt.rx_time);
+            if (pkt.payload_len > REACH_ADVERT_LEN) {
+                mpr_merge(pkt.payload[0], &pkt.payload[REACH_ADVERT_LEN], pkt.payload_len - REACH_ADVERT_LEN,
+                          pkt.rx_time);
+            }
         }
+        return;
     }
 
-    /* Try v1 protocol first (if packet version=1) */
-    int v1_result = meshgrid_v1_process_packet(buf, len, rssi, snr);
-    if (v1_result == 0) {
-        /* v1 handled it successfully */
+    /* v1 frames go to the v1 stack first. Its messages are pathless (no hop
+     * limit), so meshgrid_classify() never relays them - decrypted ends here */
+    if (pkt.version == PAYLOAD_VER_MESHGRID && meshgrid_v1_process_packet(&pkt) == 0) {
         return;
     }
 
-    /* Fall back to v0 (MeshCore) - handles version=0 packets */
-    if (pkt.payload_type == PAYLOAD_ADVERT || pkt.payload_type == PAYLOAD_TXT_MSG ||
-        pkt.payload_type == PAYLOAD_GRP_TXT || pkt.payload_type == PAYLOAD_GRP_DATA) {
-        /* Pass raw packet to MeshCore for signature verification and neighbor discovery */
+    /* Fall back to v0 (MeshCore) - handles version=0 packets
+     * (a v1 message we could not decrypt is only left to relay) */
+    if (!MESHGRID_IS_PATHLESS(pkt.header) &&
+        (pkt.payload_type == PAYLOAD_ADVERT || pkt.payload_type == PAYLOAD_TXT_MSG ||
+         pkt.payload_type == PAYLOAD_GRP_TXT || pkt.payload_type == PAYLOAD_GRP_DATA ||
+         pkt.payload_type == PAYLOAD_PATH || pkt.payload_type == PAYLOAD_ACK)) {
+        /* Pass raw packet to MeshCore for signature verification and neighbor discovery
+         * (PATH returns and ACKs feed the route cache) */
         meshcore_bridge_handle_packet(buf, len, rssi, snr);
     }
 
@@ -146,7 +236,7 @@ void process_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr) {
             return;
         case PAYLOAD_TRACE:
             /* Handle trace packet - MeshCore compatible format */
-            if (pkt.route_type == ROUTE_DIRECT && pkt.path_len < MESHGRID_MAX_PATH_SIZE) {
+            if (pkt.route_type == ROUTE_DIRECT) {
                 /* Extract trace request info (MeshCore format) */
                 uint8_t i = 0;
                 uint32_t trace_id;
@@ -163,166 +253,31 @@ void process_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr) {
 
                 if (offset >= len) {
                     /* TRACE has reached end of given path - we're the destination */
-                    struct meshgrid_packet response;
-                    memset(&response, 0, sizeof(response));
-
-                    /* Use ROUTE_FLOOD for response since path contains SNRs, not hashes */
-                    response.route_type = ROUTE_FLOOD;
-                    response.payload_type = PAYLOAD_PATH;
-                    response.version = PAYLOAD_VER_MESHCORE;
-                    response.header =
-                        MESHGRID_MAKE_HEADER(response.route_type, response.payload_type, response.version);
-
-                    /* SECURITY FIX: Bounds check to prevent buffer overflow */
-                    if (6 + pkt.path_len > MESHGRID_MAX_PAYLOAD_SIZE) {
-                        /* Path too long for response packet - reject */
-                        return;
-                    }
-
-                    /* Copy trace ID */
-                    memcpy(&response.payload[0], &trace_id, 4);
-
-                    /* Copy path (hop count and SNRs) */
-                    response.payload[4] = pkt.path_len;
-                    for (int j = 0; j < pkt.path_len && j < 32; j++) {
-                        response.payload[5 + j] = pkt.path[j];
-                    }
-
-                    /* Add our SNR at the end (MeshCore format: SNR * 4) */
-                    int8_t snr_value = (int8_t)(snr * 4);
-                    response.payload[5 + pkt.path_len] = (uint8_t)snr_value;
-                    response.payload_len = 6 + pkt.path_len;
-
-                    /* ROUTE_FLOOD will build its own path as it propagates back */
-                    response.path_len = 0;
-
-                    /* Encode and send response */
-                    uint8_t tx_buf[MESHGRID_MAX_PACKET_SIZE];
-                    int tx_len = meshgrid_packet_encode(&response, tx_buf, sizeof(tx_buf));
-                    if (tx_len > 0) {
-                        get_radio()->transmit(tx_buf, tx_len);
-                        radio_in_rx_mode = false;
-                        get_radio()->startReceive();
-                        mesh.packets_tx++;
-
-                        DEBUG_INFOF("TRACE dest reached (hops: %d)", pkt.path_len);
-                    }
+                    trace_reply(&pkt, trace_id, snr);
                     return;
                 } else {
-                    /* Check if we're the next hop in the path */
-                    uint8_t hash_at_offset = pkt.payload[i + offset];
-                    if (hash_at_offset == mesh.our_hash) {
-                        /* We're on the path - append SNR and forward */
-                        int8_t snr_value = (int8_t)(snr * 4);
-                        pkt.path[pkt.path_len] = (uint8_t)snr_value;
-                        pkt.path_len++;
-
-                        DEBUG_INFOF("TRACE fwd (hop %d)", pkt.path_len);
-
-                        /* Re-encode and immediately retransmit */
-                        uint8_t tx_buf[MESHGRID_MAX_PACKET_SIZE];
-                        int tx_len = meshgrid_packet_encode(&pkt, tx_buf, sizeof(tx_buf));
-                        if (tx_len > 0 && tx_queue_add(tx_buf, tx_len, 0, 5)) {
-                            mesh.packets_fwd++;
-                        }
-                    }
+                    /* Relayed if we're the next hop in the path - with our SNR appended */
+                    forward_packet(&pkt);
                 }
             }
             return;
         case PAYLOAD_PATH:
+            /* Encrypted path return from a peer - MeshCore consumed it for the route cache */
+            if (pkt.payload_len >= 2 && pkt.payload[0] == mesh.our_hash && neighbor_find(pkt.payload[1])) {
+                return;
+            }
             /* Trace response received */
             if (pkt.payload_len >= 5) {
-                uint32_t trace_id;
-                memcpy(&trace_id, &pkt.payload[0], 4);
-                uint8_t hop_count = pkt.payload[4];
-
-                /* Build JSON response */
-                String json = "{\"type\":\"trace_response\",\"trace_id\":";
-                json += String(trace_id);
-                json += ",\"hops\":";
-                json += String(hop_count);
-                json += ",\"path\":[";
-
-                for (int i = 0; i < hop_count && i < 32; i++) {
-                    if (i > 0)
-                        json += ",";
-                    json += "\"0x";
-                    json += String(pkt.payload[5 + i], HEX);
-                    json += "\"";
-                }
-
-                json += "],\"rssi\":";
-                json += String(rssi);
-                json += ",\"snr\":";
-                json += String(snr);
-
-                /* Calculate RTT if we can */
-                uint32_t now = millis();
-                uint32_t rtt = now - trace_id;
-                if (rtt < 60000) { /* Only show if < 60 seconds */
-                    json += ",\"rtt_ms\":";
-                    json += String(rtt);
-                }
-
-                json += "}";
-
-                /* Send as COBS frame */
-                uint8_t encoded[512];
-                size_t encoded_len = cobs_encode(encoded, (const uint8_t*)json.c_str(), json.length());
-                Serial.write(encoded, encoded_len);
-                Serial.write((uint8_t)0); /* COBS frame delimiter */
-                Serial.flush();
-
-                DEBUG_INFOF("TRACE response: %d hops", hop_count);
+                trace_report(&pkt, rssi, snr);
             }
-            return;
+            /* Flooded returns for other nodes still need relaying */
+            break;
         default:
             break;
     }
 
     /* Forward if appropriate (only REPEATER forwards, CLIENT does not) */
-    if (meshgrid_should_forward(&pkt, mesh.our_hash, device_mode)) {
-        /* Add ourselves to path */
-        meshgrid_path_append(&pkt, mesh.our_hash);
-
-        /* Calculate delay based on path length */
-        uint32_t delay_ms = meshgrid_retransmit_delay(&pkt, random_byte());
-
-        /* Priority: longer paths get HIGHER priority (lower number) */
-        uint8_t priority = (pkt.path_len > 0) ? (10 - pkt.path_len) : 10;
-        if (priority < 1)
-            priority = 1; /* Clamp to minimum */
-
-        /* Re-encode packet */
-        uint8_t tx_buf[MESHGRID_MAX_PACKET_SIZE];
-        int tx_len = meshgrid_packet_encode(&pkt, tx_buf, sizeof(tx_buf));
-
-        if (tx_len > 0) {
-            /* Add to transmission queue (non-blocking) */
-            if (tx_queue_add(tx_buf, tx_len, delay_ms, priority)) {
-                /* Successfully queued */
-                mesh.packets_fwd++;
-                stat_flood_fwd++;
-
-                const char* type_name = "PKT";
-                switch (pkt.payload_type) {
-                    case PAYLOAD_ADVERT:
-                        type_name = "ADV";
-                        break;
-                    case PAYLOAD_TXT_MSG:
-                        type_name = "MSG";
-                        break;
-                    case PAYLOAD_GRP_TXT:
-                        type_name = "GRP";
-                        break;
-                    case PAYLOAD_GRP_DATA:
-                        type_name = "DAT";
-                        break;
-                }
-                DEBUG_INFOF("QUEUE %s len=%d payload=%d hops:%d delay:%dms prio:%d", type_name, tx_len, pkt.payload_len,
-                            pkt.path_len, delay_ms, priority);
-            }
-            /* If queue full, tx_queue_add() logs error */
-        }
+    if (rx == RX_CONSUME_AND_FORWARD) {
+        forward_packet(&pkt);
     }
 }
@@ -10,6 +10,7 @@
 
 extern "C" {
 #include "network/protocol.h"
+#include "radio/radio_lbt.h"
 }
 
 /* Packet queue configuration */
@@ -23,9 +24,20 @@ struct queued_packet {
     int len;
     uint32_t scheduled_time; /* millis() when packet should be sent */
     uint8_t priority;        /* Lower number = higher priority */
+    struct lbt_session lbt;  /* Channel access state (CAD backoff) */
+    uint32_t fingerprint;    /* Flood forwards: meshgrid_packet_fingerprint() */
+    uint8_t copies;          /* Flood forwards: copies heard so far */
+    uint8_t suppress_k;      /* Cancel at this many copies (MESHGRID_SUPPRESS_OFF = never) */
     bool valid;
 };
 
+/* Flood forward accounting */
+struct forward_stats {
+    uint32_t queued;
+    uint32_t sent;
+    uint32_t suppressed; /* Cancelled after overhearing enough copies */
+};
+
 /* Airtime tracking */
 struct airtime_tracker {
     uint32_t window_start; /* Start of current window (millis) */
@@ -36,6 +48,10 @@ struct airtime_tracker {
 /* Queue management functions */
 void tx_queue_init(void);
 bool tx_queue_add(const uint8_t* buf, int len, uint32_t delay_ms, uint8_t priority);
+bool tx_queue_add_forward(const uint8_t* buf, int len, uint32_t delay_ms, uint8_t priority, uint32_t fingerprint,
+                          uint8_t suppress_k);
+bool tx_queue_overheard(uint32_t fingerprint);
+const struct forward_stats* tx_queue_forward_stats(void);
 void tx_queue_process(void);
 uint32_t airtime_get_silence_required(void);
 
@@ -66,8 +82,8 @@ void send_channel_message_v1(uint8_t channel_hash, const uint8_t* channel_secret
 void send_channel_message(uint8_t channel_hash, const uint8_t* channel_secret, const char* text,
                           const char* channel_name);
 
-/* Process received packet */
-void process_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr);
+/* Process received packet (rx_time_us: micros() at the RX interrupt) */
+void process_packet(uint8_t* buf, int len, int16_t rssi, int8_t snr, uint32_t rx_time_us);
 
 /* Get random byte */
 uint8_t random_byte(void);
@@ -0,0 +1,235 @@
+/**
+ * Forwarding engine - dedup, hop limit, rate, policy and suppression in one place
+ */
+
+#include "forward.h"
+#include "utils.h"
+#include "../messaging.h"
+#include "../neighbors.h"
+#include "utils/debug.h"
+#include "utils/role.h"
+
+extern "C" {
+#include "network/protocol.h"
+#include "hardware/crypto/crypto.h"
+}
+
+/* Externs from main.cpp */
+extern struct meshgrid_state mesh;
+extern enum meshgrid_device_mode device_mode;
+extern uint32_t stat_flood_fwd;
+extern struct channel_entry custom_channels[MAX_CUSTOM_CHANNELS];
+extern int custom_channel_count;
+extern uint8_t public_channel_hash;
+
+#define TRACE_HEADER_LEN 9 /* [trace_id:4][auth_code:4][flags:1], then the hashes to visit */
+#define TRACE_PRIORITY 5
+
+static struct forward_drops drops = {0};
+static struct forward_classes classes = {0};
+
+/* Do we hold the key for this channel hash? (public or custom) */
+static bool have_channel(uint8_t hash) {
+#if !MESHGRID_ROLE_CHAT
+    /* Channel traffic is only relayed - never handed to MeshCore to decrypt */
+    (void)hash;
+    return false;
+#else
+    if (hash == public_channel_hash) {
+        return true;
+    }
+    for (int i = 0; i < custom_channel_count; i++) {
+        if (custom_channels[i].valid && custom_channels[i].hash == hash) {
+            return true;
+        }
+    }
+    return false;
+#endif
+}
+
+enum meshgrid_rx_class forward_classify(const struct meshgrid_packet_view* pkt) {
+    enum meshgrid_rx_class rx = meshgrid_classify(pkt, mesh.our_hash, device_mode, have_channel);
+
+    switch (rx) {
+        case RX_DROP:
+            classes.drop++;
+            break;
+        case RX_FORWARD_ONLY:
+            classes.forward_only++;
+            break;
+        case RX_CONSUME:
+            classes.consume++;
+            break;
+        case RX_CONSUME_AND_FORWARD:
+            classes.consume_and_forward++;
+            break;
+    }
+    return rx;
+}
+
+/* Who is spending our airtime - 0 if unknown (not rate limited) */
+static uint8_t source_hash(const struct meshgrid_packet_view* pkt) {
+    if (MESHGRID_IS_PATHLESS(pkt->header)) {
+        /* v1 frames keep sender and dest inside the ciphertext */
+        return 0;
+    }
+    if (pkt->route_type == ROUTE_FLOOD && pkt->path_len > 0) {
+        /* For flood packets, source is last hop in path */
+        return pkt->path[pkt->path_len - 1];
+    }
+    if (pkt->payload_type == PAYLOAD_ADVERT && pkt->payload_len >= 32) {
+        /* For adverts, hash the public key */
+        return crypto_hash_pubkey(&pkt->payload[0]);
+    }
+    if ((pkt->payload_type == PAYLOAD_TXT_MSG || pkt->payload_type == PAYLOAD_GRP_TXT) && pkt->payload_len >= 2) {
+        /* For messages, source hash is in payload[1] */
+        return pkt->payload[1];
+    }
+    return 0;
+}
+
+bool forward_admit(const struct meshgrid_packet_view* pkt) {
+    if (seen_check_and_add(pkt)) {
+        /* Another relay's copy - may make our own pending forward redundant */
+        if (MESHGRID_IS_FLOOD(pkt->route_type) && meshgrid_copy_suppresses(pkt)) {
+            tx_queue_overheard(meshgrid_packet_fingerprint(pkt));
+        }
+        drops.duplicate++;
+        return false;
+    }
+
+    /* SECURITY: rate limit per source (skip ACKs to prevent legitimate traffic blocking) */
+    uint8_t source = source_hash(pkt);
+    if (pkt->payload_type != PAYLOAD_ACK && source != 0 && rate_limit_check(source)) {
+        DEBUG_WARNF("RATE LIMIT: Dropped packet from 0x%02X (DoS protection)", source);
+        mesh.packets_dropped++;
+        drops.rate++;
+        return false;
+    }
+    return true;
+}
+
+/* Encode the frame with its new path straight from the RX buffer and queue it */
+static bool schedule(const struct meshgrid_packet_view* pkt, const uint8_t* path, uint8_t path_len,
+                     uint32_t delay_ms, uint8_t priority, bool flood, uint8_t suppress_k) {
+    uint8_t tx_buf[MESHGRID_MAX_PACKET_SIZE];
+    int tx_len = meshgrid_view_encode(pkt, path, path_len, tx_buf, sizeof(tx_buf));
+    if (tx_len <= 0) {
+        return false;
+    }
+
+    bool queued = flood ? tx_queue_add_forward(tx_buf, tx_len, delay_ms, priority,
+                                               meshgrid_packet_fingerprint(pkt), suppress_k)
+                        : tx_queue_add(tx_buf, tx_len, delay_ms, priority);
+    if (!queued) {
+        drops.queue_full++;
+        return false;
+    }
+
+    mesh.packets_fwd++;
+    DEBUG_INFOF("QUEUE FWD type=%d v%d len=%d hops:%d delay:%dms prio:%d", pkt->payload_type, pkt->version, tx_len,
+                path_len, delay_ms, priority);
+    return true;
+}
+
+/* TRACE: relay if we are the next hash on its list, adding our SNR to the path */
+static bool forward_trace(const struct meshgrid_packet_view* pkt) {
+    if (pkt->route_type != ROUTE_DIRECT || pkt->payload_len < TRACE_HEADER_LEN) {
+        return false;
+    }
+
+    uint8_t path_sz = pkt->payload[8] & 0x03; /* Lower 2 bits = hash size (0 = 1 byte) */
+    uint16_t offset = (uint16_t)pkt->path_len << path_sz;
+    if (offset >= pkt->payload_len - TRACE_HEADER_LEN || pkt->payload[TRACE_HEADER_LEN + offset] != mesh.our_hash) {
+        return false;
+    }
+    if (pkt->path_len >= MESHGRID_MAX_PATH_SIZE) {
+        drops.ttl++;
+        return false;
+    }
+
+    uint8_t path[MESHGRID_MAX_PATH_SIZE];
+    memcpy(path, pkt->path, pkt->path_len);
+    path[pkt->path_len] = (uint8_t)(int8_t)(pkt->snr * 4);
+    DEBUG_INFOF("TRACE fwd (hop %d)", pkt->path_len + 1);
+    return schedule(pkt, path, pkt->path_len + 1, 0, TRACE_PRIORITY, false, MESHGRID_SUPPRESS_OFF);
+}
+
+/* Routed packet: relay only as the next hop, which leaves the path; no other relay will cover for us */
+static bool forward_direct(const struct meshgrid_packet_view* pkt) {
+    if (!meshgrid_should_forward_direct(pkt, mesh.our_hash, device_mode)) {
+        return false;
+    }
+
+    return schedule(pkt, pkt->path + 1, pkt->path_len - 1, random_byte() % MESHGRID_DIRECT_JITTER_MS, 0, false,
+                    MESHGRID_SUPPRESS_OFF);
+}
+
+static bool forward_flood(const struct meshgrid_packet_view* pkt) {
+    /* Only REPEATER forwards, CLIENT does not */
+    if (device_mode == MODE_CLIENT) {
+        return false;
+    }
+
+    /* Full path: the flood has used up its hops. Pathless v1 frames carry no
+     * hop count at all - with only the 1-byte dedup hash to stop them they
+     * would cross the whole mesh, so they are not relayed until v1 has one */
+    if (pkt->path_len >= MESHGRID_MAX_PATH_SIZE || MESHGRID_IS_PATHLESS(pkt->header)) {
+        drops.ttl++;
+        return false;
+    }
+
+    enum meshgrid_fwd_verdict verdict = meshgrid_should_forward(pkt, mesh.our_hash, device_mode);
+    if (verdict == FWD_DROP) {
+        drops.policy++;
+        return false;
+    }
+
+    /* Policy defer looks at who we heard it from - the received path */
+    uint32_t defer_ms = meshgrid_forward_defer(pkt);
+
+    /* Add ourselves to path */
+    uint8_t path[MESHGRID_MAX_PATH_SIZE];
+    uint8_t path_len = pkt->path_len;
+    memcpy(path, pkt->path, path_len);
+    path[path_len++] = mesh.our_hash;
+
+    /* Calculate delay based on path length and how well we heard it */
+    uint32_t delay_ms = meshgrid_retransmit_delay(path_len, pkt->snr, random_byte()) + defer_ms;
+    uint8_t suppress_k = meshgrid_suppress_threshold(neighbors_direct_count());
+
+    /* Policy says this leads away from dest - go last, and only if nobody else does */
+    if (verdict == FWD_RELAY_LATE) {
+        delay_ms += MESHGRID_DIRECTED_DEFER_MS;
+        suppress_k = MESHGRID_DIRECTED_SUPPRESS_K;
+    }
+
+    /* Priority: longer paths get HIGHER priority (lower number) */
+    uint8_t priority = (path_len > 0) ? (10 - path_len) : 10;
+    if (path_len >= 10)
+        priority = 1; /* Clamp to minimum */
+
+    if (!schedule(pkt, path, path_len, delay_ms, priority, true, suppress_k)) {
+        return false;
+    }
+    stat_flood_fwd++;
+    return true;
+}
+
+bool forward_packet(const struct meshgrid_packet_view* pkt) {
+    if (pkt->payload_type == PAYLOAD_TRACE) {
+        return forward_trace(pkt);
+    }
+    if (MESHGRID_IS_DIRECT(pkt->route_type)) {
+        return forward_direct(pkt);
+    }
+    return forward_flood(pkt);
+}
+
+const struct forward_drops* forward_get_drops(void) {
+    return &drops;
+}
+
+const struct forward_classes* forward_get_classes(void) {
+    return &classes;
+}
@@ -0,0 +1,54 @@
+/**
+ * Forwarding engine - the one place a received frame is relayed from
+ *
+ * forward_classify() sorts every frame from its header first, so relay
+ * traffic and frames for other nodes skip the full receive path. Every
+ * frame not dropped there passes forward_admit() once (duplicates,
+ * per-source rate), and everything we retransmit for others - routed
+ * hops, TRACE hops and floods of either protocol version - is scheduled
+ * by forward_packet().
+ * MeshCore's own relay path stays disabled (allowPacketForward), so the
+ * TX queue sees exactly one copy per relayed frame and all repeater
+ * airtime is accounted for here.
+ */
+
+#ifndef MESSAGING_FORWARD_H
+#define MESSAGING_FORWARD_H
+
+#include <Arduino.h>
+#include "utils/types.h"
+
+extern "C" {
+#include "network/protocol.h"
+}
+
+/* Why a frame was not relayed */
+struct forward_drops {
+    uint32_t duplicate;  /* Already seen within MESHGRID_DUPLICATE_WINDOW_MS */
+    uint32_t ttl;        /* Path full - hop limit reached */
+    uint32_t rate;       /* Source over its per-second budget */
+    uint32_t policy;     /* Forward policy left it to other relays */
+    uint32_t queue_full; /* No TX queue slot */
+};
+
+/* Frames per early receive class (meshgrid_rx_class) */
+struct forward_classes {
+    uint32_t drop;
+    uint32_t forward_only;
+    uint32_t consume;
+    uint32_t consume_and_forward;
+};
+
+/* Header-only receive class for pkt, counted */
+enum meshgrid_rx_class forward_classify(const struct meshgrid_packet_view* pkt);
+
+/* Ingress: dedup and rate limit, once per frame; false = drop it */
+bool forward_admit(const struct meshgrid_packet_view* pkt);
+
+/* Relay pkt if it is ours to relay; true if a retransmission was queued */
+bool forward_packet(const struct meshgrid_packet_view* pkt);
+
+const struct forward_drops* forward_get_drops(void);
+const struct forward_classes* forward_get_classes(void);
+
+#endif /* MESSAGING_FORWARD_H */
@@ -0,0 +1,218 @@
+/**
+ * Message inbox - received messages in one shared ring arena
+ *
+ * Records are appended at tail and evicted from head, in store order.
+ * A record never straddles the end of the arena: when it does not fit
+ * there, writing restarts at offset 0 and the arena is "wrapped" until
+ * head catches up with wrap_end.
+ */
+
+#include "inbox.h"
+#include "utils/arena.h"
+#include <string.h>
+
+struct inbox_ref {
+    uint16_t off; /* Record offset in the arena */
+    uint16_t seq; /* Its sequence number - stale once the record is evicted */
+};
+
+struct inbox_ring {
+    uint16_t next;  /* Slot for the next ref */
+    uint16_t count; /* Refs held, oldest may be stale */
+};
+
+static uint8_t *arena; /* MESSAGE_ARENA_SIZE bytes, cold boot arena */
+static uint16_t head;     /* Oldest record */
+static uint16_t tail;     /* Next write offset */
+static uint16_t wrap_end; /* End of the records above tail while wrapped */
+static bool wrapped;
+static uint16_t records;
+static uint16_t next_seq;
+
+static struct inbox_ref public_refs[PUBLIC_MESSAGE_BUFFER_SIZE];
+static struct inbox_ref direct_refs[DIRECT_MESSAGE_BUFFER_SIZE];
+static struct inbox_ref channel_refs[MAX_CUSTOM_CHANNELS][CHANNEL_MESSAGE_BUFFER_SIZE];
+static struct inbox_ring rings[INBOX_CONVS];
+
+static struct inbox_stats stats;
+
+static struct inbox_msg *record_at(uint16_t off)
+{
+    return (struct inbox_msg *)&arena[off];
+}
+
+static struct inbox_ref *ring_refs(uint8_t conv, uint16_t *depth)
+{
+    if (conv == INBOX_PUBLIC) {
+        *depth = PUBLIC_MESSAGE_BUFFER_SIZE;
+        return public_refs;
+    }
+    if (conv == INBOX_DIRECT) {
+        *depth = DIRECT_MESSAGE_BUFFER_SIZE;
+        return direct_refs;
+    }
+    *depth = CHANNEL_MESSAGE_BUFFER_SIZE;
+    return channel_refs[conv - INBOX_CHANNEL(0)];
+}
+
+/* Still in the arena? Records are evicted in sequence order */
+static bool ref_live(const struct inbox_ref *ref)
+{
+    uint16_t age = (uint16_t)(next_seq - ref->seq);
+    return age != 0 && age <= records;
+}
+
+static void evict_oldest(void)
+{
+    head += record_at(head)->size;
+    records--;
+    stats.evicted++;
+
+    if (records == 0) {
+        head = tail = 0;
+        wrapped = false;
+    } else if (wrapped && head == wrap_end) {
+        head = 0;
+        wrapped = false;
+    }
+}
+
+/* Offset of size free bytes at the write end, evicting the oldest records for room */
+static uint16_t make_room(uint16_t size)
+{
+    for (;;) {
+        if (!wrapped) {
+            /* Records in [head, tail): room after tail, else before head */
+            if ((uint32_t)tail + size <= MESSAGE_ARENA_SIZE) {
+                return tail;
+            }
+            if (size <= head) {
+                wrap_end = tail;
+                wrapped = true;
+                return 0;
+            }
+        } else if ((uint32_t)tail + size <= head) {
+            /* Records in [head, wrap_end) and [0, tail): room in between */
+            return tail;
+        }
+        evict_oldest();
+    }
+}
+
+/* Drop refs whose records the arena has evicted (always the oldest ones) */
+static void ring_trim(uint8_t conv)
+{
+    struct inbox_ring *ring = &rings[conv];
+    uint16_t depth;
+    const struct inbox_ref *refs = ring_refs(conv, &depth);
+
+    while (ring->count > 0 && !ref_live(&refs[(ring->next + depth - ring->count) % depth])) {
+        ring->count--;
+    }
+}
+
+void inbox_init(void)
+{
+    if (!arena) {
+        arena = (uint8_t *)arena_alloc(ARENA_COLD, MESSAGE_ARENA_SIZE, "inbox");
+    }
+    memset(&stats, 0, sizeof(stats));
+    inbox_clear_all();
+}
+
+void inbox_add(uint8_t conv, uint8_t sender_hash, uint8_t channel_hash, uint8_t protocol_version,
+               uint32_t timestamp, const char *sender_name, const char *text)
+{
+    if (conv >= INBOX_CONVS) {
+        return;
+    }
+    if (!sender_name) {
+        sender_name = "";
+    }
+    if (!text) {
+        text = "";
+    }
+
+    uint8_t name_len = (uint8_t)strnlen(sender_name, INBOX_NAME_MAX);
+    uint8_t text_len = (uint8_t)strnlen(text, INBOX_TEXT_MAX);
+    uint16_t size = (uint16_t)((sizeof(struct inbox_msg) + name_len + 1 + text_len + 1 + 3) & ~3u);
+
+    uint16_t off = make_room(size);
+    struct inbox_msg *m = record_at(off);
+    m->size = size;
+    m->seq = next_seq++;
+    m->timestamp = timestamp;
+    m->sender_hash = sender_hash;
+    m->channel_hash = channel_hash;
+    m->protocol_version = protocol_version;
+    m->name_len = name_len;
+    m->text_len = text_len;
+    memcpy(m->strings, sender_name, name_len);
+    m->strings[name_len] = '\0';
+    memcpy(m->strings + name_len + 1, text, text_len);
+    m->strings[name_len + 1 + text_len] = '\0';
+
+    tail = off + size;
+    records++;
+    stats.stored++;
+
+    struct inbox_ring *ring = &rings[conv];
+    uint16_t depth;
+    struct inbox_ref *refs = ring_refs(conv, &depth);
+    refs[ring->next].off = off;
+    refs[ring->next].seq = m->seq;
+    ring->next = (ring->next + 1) % depth;
+    if (ring->count < depth) {
+        ring->count++;
+    }
+}
+
+uint16_t inbox_count(uint8_t conv)
+{
+    if (conv >= INBOX_CONVS) {
+        return 0;
+    }
+    ring_trim(conv);
+    return rings[conv].count;
+}
+
+const struct inbox_msg *inbox_get(uint8_t conv, uint16_t i)
+{
+    uint16_t count = inbox_count(conv);
+    if (i >= count) {
+        return NULL;
+    }
+
+    uint16_t depth;
+    const struct inbox_ref *refs = ring_refs(conv, &depth);
+    return record_at(refs[(rings[conv].next + depth - count + i) % depth].off);
+}
+
+void inbox_clear(uint8_t conv)
+{
+    if (conv < INBOX_CONVS) {
+        rings[conv].next = 0;
+        rings[conv].count = 0;
+    }
+}
+
+void inbox_clear_all(void)
+{
+    head = tail = wrap_end = 0;
+    wrapped = false;
+    records = 0;
+    memset(rings, 0, sizeof(rings));
+}
+
+const struct inbox_stats *inbox_get_stats(void)
+{
+    stats.records = records;
+    if (records == 0) {
+        stats.used = 0;
+    } else if (wrapped) {
+        stats.used = (uint16_t)(wrap_end - head + tail);
+    } else {
+        stats.used = (uint16_t)(tail - head);
+    }
+    return &stats;
+}
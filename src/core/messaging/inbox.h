@@ -0,0 +1,94 @@
+/**
+ * Message inbox - received messages in one shared ring arena
+ *
+ * Every stored message is one variable-length record (header, sender
+ * name, text) appended to a byte ring of MESSAGE_ARENA_SIZE. When the
+ * ring is full the oldest records go first, whatever conversation they
+ * belong to. Each conversation (public channel, direct messages, each
+ * custom channel) keeps a small ring of record offsets, so listing one
+ * walks only its own messages and reads them in place.
+ *
+ * A short message costs its length plus a 16-byte header instead of a
+ * fixed 156-byte slot, and idle channels reserve no text space at all.
+ * The arena itself is cold boot-arena memory (PSRAM when present).
+ * Record pointers stay valid until the next inbox_add(). Pure C, not
+ * thread safe - messages are stored and read from the main loop.
+ */
+
+#ifndef MESHGRID_INBOX_H
+#define MESHGRID_INBOX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "utils/memory.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if MESSAGE_ARENA_SIZE > 65535 || (MESSAGE_ARENA_SIZE & 3) != 0
+#    error "MESSAGE_ARENA_SIZE must be a multiple of 4 below 64 KB"
+#endif
+
+/* Conversations */
+#define INBOX_PUBLIC 0
+#define INBOX_DIRECT 1
+#define INBOX_CHANNEL(i) (2 + (i)) /* custom_channels[i] */
+#define INBOX_CONVS (2 + MAX_CUSTOM_CHANNELS)
+
+#define INBOX_NAME_MAX 16  /* Sender name, without terminator */
+#define INBOX_TEXT_MAX 127 /* Message text, without terminator */
+
+struct inbox_msg {
+    uint16_t size; /* Whole record, 4-byte aligned */
+    uint16_t seq;  /* Store order, wraps */
+    uint32_t timestamp;
+    uint8_t sender_hash;
+    uint8_t channel_hash;     /* 0 for direct message */
+    uint8_t protocol_version; /* 0=v0 (MeshCore), 1=v1 (meshgrid enhanced) */
+    uint8_t name_len;
+    uint8_t text_len;
+    uint8_t reserved[3];
+    char strings[]; /* sender_name\0text\0 */
+};
+
+struct inbox_stats {
+    uint32_t stored;  /* Messages added */
+    uint32_t evicted; /* Oldest records dropped for room */
+    uint16_t records; /* Records in the arena */
+    uint16_t used;    /* Arena bytes holding records */
+};
+
+static inline const char *inbox_sender(const struct inbox_msg *m)
+{
+    return m->strings;
+}
+
+static inline const char *inbox_text(const struct inbox_msg *m)
+{
+    return m->strings + m->name_len + 1;
+}
+
+void inbox_init(void);
+
+/* Store a message in conv; names and texts longer than the limits are cut */
+void inbox_add(uint8_t conv, uint8_t sender_hash, uint8_t channel_hash, uint8_t protocol_version,
+               uint32_t timestamp, const char *sender_name, const char *text);
+
+/* Messages still held for conv */
+uint16_t inbox_count(uint8_t conv);
+
+/* i-th message of conv, oldest first; NULL if i >= inbox_count(conv) */
+const struct inbox_msg *inbox_get(uint8_t conv, uint16_t i);
+
+/* Forget conv's messages (their records age out of the arena) */
+void inbox_clear(uint8_t conv);
+void inbox_clear_all(void);
+
+const struct inbox_stats *inbox_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_INBOX_H */
@@ -0,0 +1,530 @@
+/**
+ * Message log - received messages kept on flash across reboots
+ *
+ * Segment n is MSG_LOG_DIR/<n in hex>.log; only appends ever touch it
+ * and it is deleted whole. On flash a record is a 4-byte frame header
+ * (magic, body length, CRC-16/CCITT of the body) and the body. After a
+ * boot, appends start a fresh segment rather than trusting the tail of
+ * the last one.
+ */
+
+#include "msg_log.h"
+#include "utils/types.h"
+#include "utils/debug.h"
+#include "utils/arena.h"
+#include "utils/crc16.h"
+
+#if MSG_LOG_ENABLED
+#    include <LittleFS.h>
+#endif
+
+#if MSG_LOG_ENABLED
+
+extern struct channel_entry custom_channels[MAX_CUSTOM_CHANNELS];
+extern int custom_channel_count;
+
+#    define MSG_LOG_DIR "/msglog"
+#    define RECORD_MAGIC 0xA7
+
+static_assert(MSG_LOG_SEGMENT_SIZE <= 65536, "Index offsets are 16 bits");
+static_assert(MSG_LOG_BATCH_SIZE <= MSG_LOG_SEGMENT_SIZE, "A batch may span at most two segments");
+static_assert(MSG_LOG_SEGMENTS < 256, "Index keeps the low byte of the segment number");
+
+struct record_frame {
+    uint8_t magic;
+    uint8_t len;  /* Body bytes that follow */
+    uint16_t crc; /* CRC-16/CCITT of the body */
+};
+
+struct record_body {
+    uint32_t seq;
+    uint32_t timestamp;
+    uint8_t conv;
+    uint8_t sender_hash;
+    uint8_t channel_hash;
+    uint8_t protocol_version;
+    uint8_t name_len;
+    uint8_t text_len;
+    char strings[INBOX_NAME_MAX + INBOX_TEXT_MAX]; /* Name then text, unterminated */
+} __attribute__((packed));
+
+#    define BODY_FIXED offsetof(struct record_body, strings)
+
+struct index_slot {
+    uint16_t off; /* Record offset in its segment */
+    uint8_t seg;  /* Segment number, low byte */
+    uint8_t conv;
+};
+
+static_assert(sizeof(struct index_slot) == 4, "ARENA_COLD_SIZE budgets 4 bytes per slot");
+
+static struct index_slot* slots; /* MSG_LOG_INDEX_SIZE, cold boot arena */
+static uint16_t slot_head; /* Oldest message */
+static uint16_t slot_count;
+static uint16_t conv_counts[INBOX_CONVS];
+
+static uint32_t first_seg; /* Oldest segment file on flash */
+static uint32_t cur_seg;   /* Segment appends go to */
+static uint32_t seg_size;  /* Bytes of cur_seg, batched ones included */
+static uint32_t next_seq;
+
+static uint8_t batch[MSG_LOG_BATCH_SIZE];
+static uint16_t batch_len;
+static uint16_t batch_split; /* Leading batch bytes that belong to cur_seg - 1 */
+static uint32_t batch_since; /* When the oldest batched record came in */
+
+static struct msg_log_stats stats;
+
+static void seg_path(char* buf, size_t size, uint32_t seg) {
+    snprintf(buf, size, MSG_LOG_DIR "/%08lx.log", (unsigned long)seg);
+}
+
+/* Full segment number of a slot - live segments are never 256 apart */
+static uint32_t slot_seg(const struct index_slot* slot) {
+    return cur_seg - (uint8_t)((uint8_t)cur_seg - slot->seg);
+}
+
+static void drop_oldest(void) {
+    uint8_t conv = slots[slot_head].conv;
+    if (conv < INBOX_CONVS) {
+        conv_counts[conv]--;
+    }
+    slot_head = (slot_head + 1) % MSG_LOG_INDEX_SIZE;
+    slot_count--;
+}
+
+static void push_slot(uint32_t seg, uint32_t off, uint8_t conv) {
+    if (slot_count == MSG_LOG_INDEX_SIZE) {
+        drop_oldest();
+    }
+    struct index_slot* slot = &slots[(slot_head + slot_count) % MSG_LOG_INDEX_SIZE];
+    slot->off = (uint16_t)off;
+    slot->seg = (uint8_t)seg;
+    slot->conv = conv;
+    slot_count++;
+    if (conv < INBOX_CONVS) {
+        conv_counts[conv]++;
+    }
+}
+
+/* Start the next segment; past MSG_LOG_SEGMENTS the oldest one's messages leave the index */
+static void roll_segment(void) {
+    cur_seg++;
+    seg_size = 0;
+    if (cur_seg + 1 < MSG_LOG_SEGMENTS) {
+        return;
+    }
+    uint32_t oldest_kept = cur_seg + 1 - MSG_LOG_SEGMENTS;
+    while (slot_count > 0 && slot_seg(&slots[slot_head]) < oldest_kept) {
+        drop_oldest();
+    }
+}
+
+static bool write_segment(uint32_t seg, const uint8_t* data, size_t len) {
+    if (len == 0) {
+        return true;
+    }
+    char path[32];
+    seg_path(path, sizeof(path), seg);
+    File f = LittleFS.open(path, FILE_APPEND);
+    if (!f) {
+        return false;
+    }
+    size_t written = f.write(data, len);
+    f.close();
+    return written == len;
+}
+
+static void flush_batch(void) {
+    if (batch_len == 0) {
+        return;
+    }
+    bool ok = write_segment(cur_seg - 1, batch, batch_split) &&
+              write_segment(cur_seg, batch + batch_split, batch_len - batch_split);
+    batch_len = 0;
+    batch_split = 0;
+    stats.flushes++;
+
+    if (!ok) {
+        /* Later offsets in this segment no longer match the file */
+        stats.write_errors++;
+        roll_segment();
+    }
+}
+
+/* Delete the oldest segment file once no index slot points into it */
+static bool compact_step(void) {
+    uint32_t oldest_live = slot_count > 0 ? slot_seg(&slots[slot_head]) : cur_seg;
+    if (batch_split > 0 && oldest_live > cur_seg - 1) {
+        oldest_live = cur_seg - 1;
+    }
+    if (first_seg >= oldest_live) {
+        return false;
+    }
+
+    char path[32];
+    seg_path(path, sizeof(path), first_seg);
+    if (LittleFS.exists(path)) {
+        LittleFS.remove(path);
+        stats.retired++;
+    }
+    first_seg++;
+    return true;
+}
+
+static void append(uint8_t conv, uint8_t sender_hash, uint8_t channel_hash, uint8_t protocol_version,
+                   uint32_t timestamp, const char* sender_name, const char* text) {
+    if (!stats.mounted || conv >= INBOX_CONVS) {
+        return;
+    }
+
+    struct record_body body;
+    body.seq = next_seq;
+    body.timestamp = timestamp;
+    body.conv = conv;
+    body.sender_hash = sender_hash;
+    body.channel_hash = channel_hash;
+    body.protocol_version = protocol_version;
+    body.name_len = (uint8_t)strnlen(sender_name, INBOX_NAME_MAX);
+    body.text_len = (uint8_t)strnlen(text, INBOX_TEXT_MAX);
+    memcpy(body.strings, sender_name, body.name_len);
+    memcpy(body.strings + body.name_len, text, body.text_len);
+
+    struct record_frame frame;
+    frame.magic = RECORD_MAGIC;
+    frame.len = (uint8_t)(BODY_FIXED + body.name_len + body.text_len);
+    frame.crc = crc16_ccitt((const uint8_t*)&body, frame.len);
+    uint16_t rec_len = sizeof(frame) + frame.len;
+
+    if (batch_len + rec_len > MSG_LOG_BATCH_SIZE) {
+        /* msg_log_loop() has fallen behind - the inbox still has it */
+        stats.dropped++;
+        return;
+    }
+    if (seg_size + rec_len > MSG_LOG_SEGMENT_SIZE) {
+        batch_split = batch_len;
+        roll_segment();
+    }
+
+    if (batch_len == 0) {
+        batch_since = millis();
+    }
+    memcpy(batch + batch_len, &frame, sizeof(frame));
+    memcpy(batch + batch_len + sizeof(frame), &body, frame.len);
+    push_slot(cur_seg, seg_size, conv);
+
+    batch_len += rec_len;
+    seg_size += rec_len;
+    next_seq++;
+    stats.appended++;
+}
+
+/* Next record from f at its position; false at end of file or a bad frame */
+static bool read_record(File& f, struct record_body* body, uint16_t* rec_len) {
+    struct record_frame frame;
+    if (f.read((uint8_t*)&frame, sizeof(frame)) != sizeof(frame)) {
+        return false;
+    }
+    if (frame.magic != RECORD_MAGIC || frame.len < BODY_FIXED || frame.len > sizeof(*body)) {
+        return false;
+    }
+    if (f.read((uint8_t*)body, frame.len) != frame.len) {
+        return false;
+    }
+    if (crc16_ccitt((const uint8_t*)body, frame.len) != frame.crc ||
+        BODY_FIXED + body->name_len + body->text_len != frame.len) {
+        return false;
+    }
+    *rec_len = sizeof(frame) + frame.len;
+    return true;
+}
+
+/* Custom channels are logged by index - find the record's channel again by hash */
+static uint8_t resolve_conv(const struct record_body* body) {
+    if (body->conv < INBOX_CHANNEL(0)) {
+        return body->conv;
+    }
+    for (int i = 0; i < custom_channel_count; i++) {
+        if (custom_channels[i].valid && custom_channels[i].hash == body->channel_hash) {
+            return INBOX_CHANNEL(i);
+        }
+    }
+    return MSG_LOG_ORPHAN;
+}
+
+/* Index one segment and replay it into the inbox, up to its first bad record */
+static void scan_segment(uint32_t seg) {
+    char path[32];
+    seg_path(path, sizeof(path), seg);
+    File f = LittleFS.open(path, FILE_READ);
+    if (!f) {
+        return;
+    }
+
+    struct record_body body;
+    char name[INBOX_NAME_MAX + 1];
+    char text[INBOX_TEXT_MAX + 1];
+    uint32_t off = 0;
+    uint16_t rec_len;
+    while (off < f.size()) {
+        if (!read_record(f, &body, &rec_len)) {
+            stats.corrupt++;
+            break;
+        }
+
+        uint8_t conv = resolve_conv(&body);
+        push_slot(seg, off, conv);
+        if (conv < INBOX_CONVS) {
+            memcpy(name, body.strings, body.name_len);
+            name[body.name_len] = '\0';
+            memcpy(text, body.strings + body.name_len, body.text_len);
+            text[body.text_len] = '\0';
+            inbox_add(conv, body.sender_hash, body.channel_hash, body.protocol_version, body.timestamp, name, text);
+        }
+        if (body.seq >= next_seq) {
+            next_seq = body.seq + 1;
+        }
+        off += rec_len;
+    }
+    f.close();
+}
+
+void msg_log_init(void) {
+    if (!slots) {
+        slots = (struct index_slot*)arena_alloc(ARENA_COLD, MSG_LOG_INDEX_SIZE * sizeof(struct index_slot),
+                                                "msglog_index");
+    }
+    memset(&stats, 0, sizeof(stats));
+    memset(conv_counts, 0, sizeof(conv_counts));
+    slot_head = slot_count = 0;
+    batch_len = batch_split = 0;
+    first_seg = cur_seg = 0;
+    seg_size = 0;
+    next_seq = 0;
+
+    /* Formats the partition on first boot */
+    if (!LittleFS.begin(true, "/littlefs", 4, "spiffs")) {
+        DEBUG_WARN("Message log: filesystem mount failed, RAM inbox only");
+        return;
+    }
+    if (!LittleFS.exists(MSG_LOG_DIR)) {
+        LittleFS.mkdir(MSG_LOG_DIR);
+    }
+
+    /* Segment range on flash */
+    bool found = false;
+    uint32_t lo = 0, hi = 0;
+    File dir = LittleFS.open(MSG_LOG_DIR);
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        const char* name = strrchr(f.name(), '/');
+        name = name ? name + 1 : f.name();
+        char* end;
+        uint32_t seg = strtoul(name, &end, 16);
+        bool is_segment = end != name && strcmp(end, ".log") == 0;
+        f.close(); /* name points into the handle */
+        if (!is_segment) {
+            continue;
+        }
+        if (!found || seg < lo) {
+            lo = seg;
+        }
+        if (!found || seg > hi) {
+            hi = seg;
+        }
+        found = true;
+    }
+    dir.close();
+
+    stats.mounted = true;
+    if (!found) {
+        return;
+    }
+
+    /* Load the newest MSG_LOG_SEGMENTS, older ones are left for compaction. Appends
+     * go to a fresh segment - the first roll brings the count back to the limit */
+    first_seg = lo;
+    cur_seg = hi + 1;
+    uint32_t start = lo;
+    if (hi - lo + 1 > MSG_LOG_SEGMENTS) {
+        start = hi + 1 - MSG_LOG_SEGMENTS;
+    }
+    for (uint32_t seg = start; seg <= hi; seg++) {
+        scan_segment(seg);
+    }
+
+    DEBUG_INFOF("Message log: %u messages, segments %lu-%lu, %lu bad", slot_count, (unsigned long)first_seg,
+                (unsigned long)hi, (unsigned long)stats.corrupt);
+}
+
+void msg_log_store(uint8_t conv, uint8_t sender_hash, uint8_t channel_hash, uint8_t protocol_version,
+                   uint32_t timestamp, const char* sender_name, const char* text) {
+    if (!sender_name) {
+        sender_name = "";
+    }
+    if (!text) {
+        text = "";
+    }
+    inbox_add(conv, sender_hash, channel_hash, protocol_version, timestamp, sender_name, text);
+    append(conv, sender_hash, channel_hash, protocol_version, timestamp, sender_name, text);
+}
+
+bool msg_log_loop(void) {
+    if (!stats.mounted) {
+        return false;
+    }
+    if (batch_len > 0 && (batch_len >= MSG_LOG_BATCH_SIZE / 2 || millis() - batch_since >= MSG_LOG_FLUSH_MS)) {
+        flush_batch();
+        return true;
+    }
+    return compact_step();
+}
+
+void msg_log_flush(void) {
+    if (stats.mounted) {
+        flush_batch();
+    }
+}
+
+uint16_t msg_log_count(uint8_t conv) {
+    if (conv == MSG_LOG_ALL) {
+        return slot_count;
+    }
+    return conv < INBOX_CONVS ? conv_counts[conv] : 0;
+}
+
+uint16_t msg_log_page(uint8_t conv, uint16_t skip, uint16_t limit, msg_log_visit_fn visit, void* ctx) {
+    if (!stats.mounted) {
+        return 0;
+    }
+    if (limit > MSG_LOG_PAGE_MAX) {
+        limit = MSG_LOG_PAGE_MAX;
+    }
+
+    /* Walk the index newest first, keeping the page's slots */
+    struct index_slot picked[MSG_LOG_PAGE_MAX];
+    uint16_t n = 0;
+    for (uint16_t i = slot_count; i > 0 && n < limit; i--) {
+        const struct index_slot* slot = &slots[(slot_head + i - 1) % MSG_LOG_INDEX_SIZE];
+        if (conv != MSG_LOG_ALL && slot->conv != conv) {
+            continue;
+        }
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+        picked[n++] = *slot;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    flush_batch();
+
+    /* Read them oldest first, reopening only when the segment changes */
+    File f;
+    uint32_t open_seg = 0;
+    uint16_t shown = 0;
+    struct record_body body;
+    struct msg_log_entry entry;
+    uint16_t rec_len;
+    while (n > 0) {
+        const struct index_slot* slot = &picked[--n];
+        uint32_t seg = slot_seg(slot);
+        if (!f || seg != open_seg) {
+            if (f) {
+                f.close();
+            }
+            char path[32];
+            seg_path(path, sizeof(path), seg);
+            f = LittleFS.open(path, FILE_READ);
+            open_seg = seg;
+        }
+        if (!f || !f.seek(slot->off) || !read_record(f, &body, &rec_len)) {
+            continue;
+        }
+
+        entry.seq = body.seq;
+        entry.timestamp = body.timestamp;
+        entry.conv = slot->conv;
+        entry.sender_hash = body.sender_hash;
+        entry.channel_hash = body.channel_hash;
+        entry.protocol_version = body.protocol_version;
+        memcpy(entry.sender_name, body.strings, body.name_len);
+        entry.sender_name[body.name_len] = '\0';
+        memcpy(entry.text, body.strings + body.name_len, body.text_len);
+        entry.text[body.text_len] = '\0';
+        visit(&entry, ctx);
+        shown++;
+    }
+    if (f) {
+        f.close();
+    }
+    return shown;
+}
+
+void msg_log_clear(void) {
+    if (!stats.mounted) {
+        return;
+    }
+    slot_head = slot_count = 0;
+    memset(conv_counts, 0, sizeof(conv_counts));
+    batch_len = batch_split = 0;
+
+    char path[32];
+    for (uint32_t seg = first_seg; seg <= cur_seg; seg++) {
+        seg_path(path, sizeof(path), seg);
+        if (LittleFS.exists(path)) {
+            LittleFS.remove(path);
+            stats.retired++;
+        }
+    }
+    cur_seg++;
+    first_seg = cur_seg;
+    seg_size = 0;
+}
+
+const struct msg_log_stats* msg_log_get_stats(void) {
+    stats.messages = slot_count;
+    stats.pending = batch_len;
+    stats.segments = stats.mounted ? (uint16_t)(cur_seg - first_seg + 1) : 0;
+    return &stats;
+}
+
+#else /* !MSG_LOG_ENABLED */
+
+static struct msg_log_stats stats;
+
+void msg_log_init(void) {}
+
+void msg_log_store(uint8_t conv, uint8_t sender_hash, uint8_t channel_hash, uint8_t protocol_version,
+                   uint32_t timestamp, const char* sender_name, const char* text) {
+    inbox_add(conv, sender_hash, channel_hash, protocol_version, timestamp, sender_name, text);
+}
+
+bool msg_log_loop(void) {
+    return false;
+}
+
+void msg_log_flush(void) {}
+
+uint16_t msg_log_count(uint8_t conv) {
+    (void)conv;
+    return 0;
+}
+
+uint16_t msg_log_page(uint8_t conv, uint16_t skip, uint16_t limit, msg_log_visit_fn visit, void* ctx) {
+    (void)conv;
+    (void)skip;
+    (void)limit;
+    (void)visit;
+    (void)ctx;
+    return 0;
+}
+
+void msg_log_clear(void) {}
+
+const struct msg_log_stats* msg_log_get_stats(void) {
+    return &stats;
+}
+
+#endif /* MSG_LOG_ENABLED */
@@ -0,0 +1,84 @@
+/**
+ * Message log - received messages kept on flash across reboots
+ *
+ * Every message stored in the RAM inbox is also appended to a log of
+ * segment files on the LittleFS partition ("spiffs" in the partition
+ * tables). Records are CRC-framed, so a torn write at power loss costs
+ * only the records after it in that segment. Appends land in a RAM batch
+ * first and reach flash from msg_log_loop() in one write - the receive
+ * path never waits on flash.
+ *
+ * A RAM index keeps 4 bytes per logged message (segment, offset,
+ * conversation) in store order, which is all a paged query needs. The
+ * log is FIFO: once the newest MSG_LOG_SEGMENTS segments or the index
+ * are full, the oldest messages drop out, and msg_log_loop() deletes
+ * segment files nothing in the index points into any more.
+ *
+ * At boot the log is scanned once, the index rebuilt and the messages
+ * replayed into the inbox. ESP32 family only; elsewhere the log is off
+ * and messages live in the RAM inbox alone.
+ */
+
+#ifndef MESSAGING_MSG_LOG_H
+#define MESSAGING_MSG_LOG_H
+
+#include <Arduino.h>
+#include "utils/memory.h"
+#include "core/messaging/inbox.h"
+
+#define MSG_LOG_ALL 0xFE    /* Query every conversation */
+#define MSG_LOG_ORPHAN 0xFF /* Logged on a channel we no longer have */
+#define MSG_LOG_PAGE_MAX 32 /* Most messages one page can return */
+
+struct msg_log_entry {
+    uint32_t seq; /* Store order, never reused */
+    uint32_t timestamp;
+    uint8_t conv; /* INBOX_* conversation, or MSG_LOG_ORPHAN */
+    uint8_t sender_hash;
+    uint8_t channel_hash;
+    uint8_t protocol_version;
+    char sender_name[INBOX_NAME_MAX + 1];
+    char text[INBOX_TEXT_MAX + 1];
+};
+
+struct msg_log_stats {
+    uint32_t appended;     /* Records batched for flash */
+    uint32_t flushes;      /* Batch writes */
+    uint32_t dropped;      /* Batch full - kept in RAM only */
+    uint32_t corrupt;      /* Bad records found at boot */
+    uint32_t retired;      /* Segment files deleted */
+    uint32_t write_errors; /* Failed segment writes */
+    uint16_t messages;     /* Messages in the index */
+    uint16_t pending;      /* Batched bytes not yet on flash */
+    uint16_t segments;     /* Segment files, including the one being written */
+    bool mounted;
+};
+
+/* Mount, rebuild the index and replay the log into the inbox (after channels are loaded) */
+void msg_log_init(void);
+
+/* Keep a received message: in the inbox now, on flash with the next batch */
+void msg_log_store(uint8_t conv, uint8_t sender_hash, uint8_t channel_hash, uint8_t protocol_version,
+                   uint32_t timestamp, const char* sender_name, const char* text);
+
+/* Background work from the main loop: one batch flush or one segment deletion.
+ * true if it touched flash */
+bool msg_log_loop(void);
+
+/* Write the batch out now (before reboot, before reading pages) */
+void msg_log_flush(void);
+
+/* Messages held for conv (or MSG_LOG_ALL) */
+uint16_t msg_log_count(uint8_t conv);
+
+/* Newest-first paging: skip the newest `skip` messages of conv, then visit up to
+ * `limit` (at most MSG_LOG_PAGE_MAX) oldest of them first; returns the visited count */
+typedef void (*msg_log_visit_fn)(const struct msg_log_entry* entry, void* ctx);
+uint16_t msg_log_page(uint8_t conv, uint16_t skip, uint16_t limit, msg_log_visit_fn visit, void* ctx);
+
+/* Forget every logged message and delete the segment files */
+void msg_log_clear(void);
+
+const struct msg_log_stats* msg_log_get_stats(void);
+
+#endif /* MESSAGING_MSG_LOG_H */
@@ -27,9 +27,10 @@ extern struct display_state display_state;
  * Handle received advertisement packet
  * Dispatches to protocol-specific handlers (v0 or v1)
  */
-void handle_advert(struct meshgrid_packet* pkt, int16_t rssi, int8_t snr) {
-    /* Dispatch to protocol-auto handler */
-    advert_auto_receive(pkt, rssi, snr);
+void handle_advert(const struct meshgrid_packet_view* pkt, int16_t rssi, int8_t snr) {
+    /* Dispatch to protocol-auto handler (MeshCore has already parsed the advert from the raw frame) */
+    (void)pkt;
+    advert_auto_receive(NULL, rssi, snr);
 
     /* Mark display as dirty for UI update */
     display_state.dirty = true;
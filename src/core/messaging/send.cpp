@@ -9,6 +9,8 @@
 #include "utils/serial_output.h"
 #include "utils/debug.h"
 #include "network/protocol.h"
+#include "network/reachability.h"
+#include "network/mpr.h"
 #include "radio/radio_hal.h"
 
 // Use C bridge to avoid namespace conflict
@@ -33,6 +35,31 @@ extern bool radio_in_rx_mode;
 /* Functions from main.cpp */
 extern void led_blink(void);
 
+#if PROTOCOL_V1_ENABLED
+/*
+ * Zero-hop v1 advert carrying our reachability filter, neighbor list and
+ * multipoint relay set: [src hash][filter][n][neighbors][m][relays]
+ * MeshCore advert app_data has no room for them, so they ride in a
+ * companion frame; MeshCore nodes drop version 1 payloads unread.
+ */
+static void send_reach_advert(void) {
+    struct meshgrid_packet pkt;
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.route_type = ROUTE_DIRECT;
+    pkt.payload_type = PAYLOAD_ADVERT;
+    pkt.version = PAYLOAD_VER_MESHGRID;
+    pkt.header = MESHGRID_MAKE_HEADER(ROUTE_DIRECT, PAYLOAD_ADVERT, PAYLOAD_VER_MESHGRID);
+    pkt.payload_len = reach_encode_advert(mesh.our_hash, pkt.payload);
+    pkt.payload_len += mpr_encode(&pkt.payload[pkt.payload_len], millis());
+
+    uint8_t tx_buf[MESHGRID_MAX_PACKET_SIZE];
+    int tx_len = meshgrid_packet_encode(&pkt, tx_buf, sizeof(tx_buf));
+    if (tx_len > 0) {
+        tx_queue_add(tx_buf, tx_len, 0, 5);
+    }
+}
+#endif
+
 /*
  * Broadcast advertisement packet
  * Uses MeshCore v0 for advertisements
@@ -53,6 +80,10 @@ void send_advertisement(uint8_t route_type) {
 
     uint32_t tx_after = mesh.packets_tx;
     DEBUG_INFOF("send_advertisement() END tx_after=%lu", tx_after);
+
+#if PROTOCOL_V1_ENABLED
+    send_reach_advert();
+#endif
 }
 
 /*
@@ -73,10 +104,7 @@ void send_advert_direct(void) {
     strncpy((char*)&packet[2], name ? name : "test", 16);
 
     // Transmit
-    int16_t result = radio_transmit(packet, 32);
-    if (result == 0) {
-        mesh.packets_tx++;
-    }
+    radio_transmit(packet, 32);
 
     // Return to RX mode
     if (!radio_in_rx_mode) {
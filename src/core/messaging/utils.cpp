@@ -8,11 +8,13 @@
 #include "utils/debug.h"
 #include "utils/types.h"
 #include "radio/radio_hal.h"
+#include "radio/radio_task.h"
 #include <Arduino.h>
 
 extern "C" {
 #include "network/protocol.h"
 #include "utils/cobs.h"
+#include "radio/duty_cycle.h"
 }
 
 /* Externs from main.cpp */
@@ -25,6 +27,15 @@ extern struct seen_entry seen_table[];
 extern uint8_t seen_idx;
 
 extern uint32_t stat_duplicates;
+extern struct radio_config_t {
+    float frequency;
+    float bandwidth;
+    uint8_t spreading_factor;
+    uint8_t coding_rate;
+    uint16_t preamble_len;
+    int8_t tx_power;
+    bool config_saved;
+} radio_config;
 
 /* Rate limiting: Track packet timestamps per source hash */
 #define RATE_LIMIT_WINDOW_MS 1000 // 1 second window
@@ -97,6 +108,7 @@ bool rate_limit_check(uint8_t source_hash) {
 
 static struct queued_packet tx_queue[TX_QUEUE_SIZE];
 static struct airtime_tracker airtime = {0};
+static struct forward_stats fwd_stats = {0};
 
 void tx_queue_init(void) {
     for (int i = 0; i < TX_QUEUE_SIZE; i++) {
@@ -107,38 +119,87 @@ void tx_queue_init(void) {
     airtime.last_tx_ms = 0;
 }
 
-/*
- * Add packet to transmission queue with priority
- * Priority based on path_len: longer paths get HIGHER priority (lower number)
- * Returns true if added, false if queue is full
- */
-bool tx_queue_add(const uint8_t* buf, int len, uint32_t delay_ms, uint8_t priority) {
-    /* Find empty slot */
+/* Take a free slot - returns its index, or -1 if the queue is full */
+static int tx_queue_insert(const uint8_t* buf, int len, uint32_t delay_ms, uint8_t priority) {
     for (int i = 0; i < TX_QUEUE_SIZE; i++) {
         if (!tx_queue[i].valid) {
             memcpy(tx_queue[i].buf, buf, len);
             tx_queue[i].len = len;
             tx_queue[i].scheduled_time = millis() + delay_ms;
             tx_queue[i].priority = priority;
+            lbt_session_reset(&tx_queue[i].lbt);
+            tx_queue[i].fingerprint = 0;
+            tx_queue[i].copies = 0;
+            tx_queue[i].suppress_k = MESHGRID_SUPPRESS_OFF;
             tx_queue[i].valid = true;
-            return true;
+            return i;
         }
     }
 
     /* Queue full - drop packet */
     DEBUG_WARN("TX QUEUE FULL - dropped packet");
+    return -1;
+}
+
+/*
+ * Add packet to transmission queue with priority
+ * Priority based on path_len: longer paths get HIGHER priority (lower number)
+ * Returns true if added, false if queue is full
+ */
+bool tx_queue_add(const uint8_t* buf, int len, uint32_t delay_ms, uint8_t priority) {
+    return tx_queue_insert(buf, len, delay_ms, priority) >= 0;
+}
+
+/*
+ * Queue a flood forward that overheard copies may cancel
+ * The copy that triggered the forward counts as the first one.
+ */
+bool tx_queue_add_forward(const uint8_t* buf, int len, uint32_t delay_ms, uint8_t priority, uint32_t fingerprint,
+                          uint8_t suppress_k) {
+    int i = tx_queue_insert(buf, len, delay_ms, priority);
+    if (i < 0) {
+        return false;
+    }
+
+    tx_queue[i].fingerprint = fingerprint;
+    tx_queue[i].copies = 1;
+    tx_queue[i].suppress_k = suppress_k;
+    fwd_stats.queued++;
+    return true;
+}
+
+/*
+ * A duplicate of a flood was heard - count it against a pending forward
+ * Returns true if the forward was cancelled (enough neighbors relayed it).
+ */
+bool tx_queue_overheard(uint32_t fingerprint) {
+    for (int i = 0; i < TX_QUEUE_SIZE; i++) {
+        if (!tx_queue[i].valid || tx_queue[i].suppress_k == MESHGRID_SUPPRESS_OFF ||
+            tx_queue[i].fingerprint != fingerprint) {
+            continue;
+        }
+        if (++tx_queue[i].copies >= tx_queue[i].suppress_k) {
+            tx_queue[i].valid = false;
+            fwd_stats.suppressed++;
+            DEBUG_INFOF("SUPPRESS fwd after %d copies", tx_queue[i].copies);
+            return true;
+        }
+        return false;
+    }
     return false;
 }
 
+const struct forward_stats* tx_queue_forward_stats(void) {
+    fwd_stats.sent = radio_tx_forwarded();
+    return &fwd_stats;
+}
+
 /*
  * Calculate airtime for a packet
- * Based on RadioLib transmission time calculation
- * Assumes SF7, BW125, CR5 (typical LoRa settings)
+ * Exact LoRa time-on-air for the current SF/BW/CR/preamble
  */
 static uint32_t calculate_airtime_ms(int packet_len) {
-    /* Rough estimation: ~5-6ms per byte for SF7/BW125 */
-    /* Add preamble time (~15ms) */
-    return 15 + (packet_len * 6);
+    return radio_airtime_ms(packet_len);
 }
 
 /*
@@ -187,17 +248,14 @@ static void airtime_record_tx(uint32_t tx_duration_ms) {
  * Called from main loop() - finds highest priority ready packet and transmits
  */
 void tx_queue_process(void) {
+    static uint32_t last_tx_time = 0;
     uint32_t now = millis();
 
     /* Check silence period after last transmission */
     uint32_t silence_required = airtime_get_silence_required();
-    if (silence_required > 0) {
-        static uint32_t last_tx_time = 0;
-        if (now - last_tx_time < silence_required) {
-            return; /* Still in silence period */
-        }
+    if (silence_required > 0 && now - last_tx_time < silence_required) {
+        return; /* Still in silence period */
     }
-    static uint32_t last_tx_time = 0; /* Moved outside to persist */
 
     /* Find highest priority packet that's ready to send */
     int best_idx = -1;
@@ -236,19 +294,57 @@ void tx_queue_process(void) {
         return;
     }
 
-    /* Transmit (collision avoidance via queue + random delays) */
-    int16_t result = get_radio()->transmit(tx_queue[best_idx].buf, tx_queue[best_idx].len);
-    radio_in_rx_mode = false; /* Mark as not in RX after TX */
-    get_radio()->startReceive();
+    /* Regional duty cycle - delay until the sub-band budget has room */
+    radio_lock(); /* The radio task records into the same ledger */
+#ifdef ENABLE_RADIO_TASK
+    /* Frames already handed to the task are not in the ledger yet */
+    uint32_t duty_wait =
+        duty_cycle_admit(radio_config.frequency, tx_duration + radio_task_queued_airtime_ms(), now);
+#else
+    uint32_t duty_wait = duty_cycle_admit(radio_config.frequency, tx_duration, now);
+#endif
+    if (duty_wait == DUTY_NEVER) {
+        duty_cycle_get_stats()->refused++;
+    } else if (duty_wait > 0) {
+        duty_cycle_get_stats()->deferred++;
+    }
+    radio_unlock();
+    if (duty_wait == DUTY_NEVER) {
+        DEBUG_WARNF("DUTY CYCLE: %lu ms frame exceeds hourly budget - dropped", (unsigned long)tx_duration);
+        tx_queue[best_idx].valid = false;
+        return;
+    }
+    if (duty_wait > 0) {
+        tx_queue[best_idx].scheduled_time = now + duty_wait;
+        return;
+    }
+
+#ifndef ENABLE_RADIO_TASK
+    /* Listen before talk - on a busy channel, back off and retry later */
+    /* (with the radio task, LBT runs there for every submitted frame) */
+    uint32_t backoff = lbt_acquire(&tx_queue[best_idx].lbt, now);
+    if (backoff > 0) {
+        tx_queue[best_idx].scheduled_time = now + backoff;
+        return;
+    }
+#endif
+
+    /* packets_tx and forwards sent are counted by the radio once the frame is on air */
+    uint8_t flags = tx_queue[best_idx].copies > 0 ? RADIO_TX_FORWARD : 0;
+    int16_t result = radio_transmit_flags(tx_queue[best_idx].buf, tx_queue[best_idx].len, flags);
+    radio_start_receive();
 
-    /* Update statistics */
-    if (result == 0) {     /* RADIOLIB_ERR_NONE = 0 */
-        mesh.packets_tx++; /* Increment TX counter on success */
+    if (result == RADIO_ERR_TX_QUEUE_FULL || result == RADIO_ERR_DUTY_CYCLE) {
+        /* Not sent - keep the packet and try again once a frame's airtime has passed */
+        tx_queue[best_idx].scheduled_time = now + tx_duration;
+        return;
+    }
+    if (result == RADIOLIB_ERR_NONE) {
+        airtime_record_tx(tx_duration);
+        last_tx_time = millis();
     }
-    airtime_record_tx(tx_duration);
-    last_tx_time = now;
 
-    /* Mark packet as transmitted */
+    /* Transmitted (or the chip failed it) */
     tx_queue[best_idx].valid = false;
 }
 
@@ -260,7 +356,7 @@ uint32_t get_uptime_secs(void) {
     return (millis() - boot_time) / 1000;
 }
 
-bool seen_check_and_add(const struct meshgrid_packet* pkt) {
+bool seen_check_and_add(const struct meshgrid_packet_view* pkt) {
     uint8_t hash;
     meshgrid_packet_hash(pkt, &hash);
 
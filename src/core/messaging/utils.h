@@ -7,6 +7,9 @@
 /* TX Queue */
 void tx_queue_init(void);
 bool tx_queue_add(const uint8_t* buf, int len, uint32_t delay_ms, uint8_t priority);
+bool tx_queue_add_forward(const uint8_t* buf, int len, uint32_t delay_ms, uint8_t priority, uint32_t fingerprint,
+                          uint8_t suppress_k);
+bool tx_queue_overheard(uint32_t fingerprint);
 void tx_queue_process(void);
 
 /* Airtime Management */
@@ -17,7 +20,7 @@ uint8_t random_byte(void);
 uint32_t get_uptime_secs(void);
 
 /* Deduplication */
-bool seen_check_and_add(const struct meshgrid_packet* pkt);
+bool seen_check_and_add(const struct meshgrid_packet_view* pkt);
 
 /* Rate Limiting */
 bool rate_limit_check(uint8_t source_hash);
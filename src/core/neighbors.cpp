@@ -3,8 +3,14 @@
  */
 
 #include "neighbors.h"
+#include "advertising.h"
+#include "node_dir.h"
 #include "utils/debug.h"
+#include "utils/arena.h"
+#include "utils/constants.h"
+#include "utils/crc16.h"
 #include <Arduino.h>
+#include <stddef.h>
 #include <string.h>
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
 #    include <Preferences.h>
@@ -25,7 +31,52 @@ extern struct meshgrid_state mesh;
 struct meshgrid_neighbor neighbors[MAX_NEIGHBORS];
 uint16_t neighbor_count = 0;
 
-struct meshgrid_neighbor* neighbor_find(uint8_t hash) {
+/* Restored at boot without a shared secret - neighbors_derive_step() catches up */
+static uint16_t secrets_pending = 0;
+
+/* NVS snapshot: the most recently used entries in one CRC-checked blob.
+ * Shared secrets are not stored - they are recalculated from the pubkeys,
+ * so a physical compromise of the flash does not leak them */
+#define SNAPSHOT_VERSION 2
+
+struct snapshot_entry {
+    uint8_t pubkey[MESHGRID_PUBKEY_SIZE];
+    char name[MESHGRID_NODE_NAME_MAX]; /* Unterminated */
+    uint8_t protocol_version;
+    uint8_t hops;
+    uint16_t dir_slot; /* Directory slot hint, checked against the pubkey */
+    uint32_t last_seq_rx;
+    uint32_t next_seq_tx;
+};
+
+struct neighbor_snapshot {
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t count; /* Entries, most recently used first */
+    uint16_t crc;   /* CRC-16/CCITT of the entries */
+    uint16_t reserved2;
+    struct snapshot_entry entries[NEIGHBOR_SNAPSHOT_MAX];
+};
+
+static_assert(sizeof(struct snapshot_entry) == 60, "ARENA_COLD_SIZE budgets 60 bytes per snapshot entry");
+static_assert(offsetof(struct neighbor_snapshot, entries) == 8, "ARENA_COLD_SIZE budgets an 8-byte header");
+
+static struct neighbor_snapshot* snapshot; /* Cold boot arena, only touched when saving or loading */
+static bool snapshot_dirty;
+static uint32_t dirty_since;
+static uint32_t last_commit;
+
+uint16_t neighbors_direct_count(void) {
+    uint16_t count = 0;
+    for (int i = 0; i < neighbor_count; i++) {
+        if (neighbors[i].hops == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static struct meshgrid_neighbor* hot_find(uint8_t hash) {
     for (int i = 0; i < neighbor_count; i++) {
         if (neighbors[i].hash == hash) {
             return &neighbors[i];
@@ -34,6 +85,138 @@ struct meshgrid_neighbor* neighbor_find(uint8_t hash) {
     return nullptr;
 }
 
+void neighbors_mark_dirty(void) {
+    if (!snapshot_dirty) {
+        snapshot_dirty = true;
+        dirty_since = millis();
+    }
+}
+
+static void count_node_type(enum meshgrid_node_type type, bool add) {
+    uint32_t* stat;
+    switch (type) {
+        case NODE_TYPE_CLIENT:
+            stat = &stat_clients;
+            break;
+        case NODE_TYPE_REPEATER:
+            stat = &stat_repeaters;
+            break;
+        case NODE_TYPE_ROOM:
+            stat = &stat_rooms;
+            break;
+        default:
+            return;
+    }
+    if (add) {
+        (*stat)++;
+    } else if (*stat > 0) {
+        (*stat)--;
+    }
+}
+
+/* Copy printable ASCII only */
+static void copy_name(char* dst, const char* src) {
+    size_t write_pos = 0;
+    for (size_t i = 0; src[i] != '\0' && write_pos < MESHGRID_NODE_NAME_MAX; i++) {
+        if (src[i] >= 32 && src[i] <= 126) {
+            dst[write_pos++] = src[i];
+        }
+    }
+    dst[write_pos] = '\0';
+}
+
+/* Write n to the node directory; a node that took over another entry's slot
+ * leaves that entry without one */
+static void dir_save(struct meshgrid_neighbor* n) {
+    struct node_dir_entry entry;
+    memcpy(entry.pubkey, n->pubkey, MESHGRID_PUBKEY_SIZE);
+    memcpy(entry.name, n->name, sizeof(entry.name));
+    entry.protocol_version = n->protocol_version;
+    entry.last_seq_rx = n->last_seq_rx;
+    entry.next_seq_tx = n->next_seq_tx;
+
+    uint16_t hint = n->dir_slot;
+    n->dir_slot = node_dir_put(hint, &entry);
+    if (n->dir_slot == hint || n->dir_slot == NODE_DIR_NONE) {
+        return;
+    }
+    /* A new slot (no hint, or a stale one): other entries' hints to it are stale now */
+    for (int i = 0; i < neighbor_count; i++) {
+        if (&neighbors[i] != n && neighbors[i].dir_slot == n->dir_slot) {
+            neighbors[i].dir_slot = NODE_DIR_NONE;
+        }
+    }
+}
+
+/* Entry leaves the table - the directory keeps what is needed to page it back in */
+static void neighbor_retire(struct meshgrid_neighbor* n) {
+    count_node_type(n->node_type, false);
+    if (n->dir_slot == NODE_DIR_NONE || n->protocol_version >= 1) {
+        dir_save(n); /* Not on flash yet, or v1 sequence counters moved on */
+    }
+}
+
+/* Blank entry for a node entering the table; a full table gives up its least recently used */
+static struct meshgrid_neighbor* hot_slot(void) {
+    struct meshgrid_neighbor* n;
+    if (neighbor_count < MAX_NEIGHBORS) {
+        n = &neighbors[neighbor_count++];
+    } else {
+        n = &neighbors[0];
+        for (int i = 1; i < neighbor_count; i++) {
+            if ((int32_t)(neighbors[i].last_used - n->last_used) < 0) {
+                n = &neighbors[i];
+            }
+        }
+        neighbor_retire(n);
+    }
+    memset(n, 0, sizeof(*n));
+    n->dir_slot = NODE_DIR_NONE;
+    return n;
+}
+
+/* Fill a blank entry from the directory. Signal fields stay unknown until the node is heard */
+static void page_in(struct meshgrid_neighbor* n, const struct node_dir_entry* entry, uint16_t slot) {
+    memcpy(n->pubkey, entry->pubkey, MESHGRID_PUBKEY_SIZE);
+    n->hash = crypto_hash_pubkey(entry->pubkey);
+    copy_name(n->name, entry->name);
+    n->node_type = infer_node_type(n->name);
+    n->firmware = infer_firmware(n->name);
+    n->protocol_version = entry->protocol_version;
+    n->hops = NEIGHBOR_HOPS_UNKNOWN;
+    n->last_seen = millis();
+    n->last_used = millis();
+    n->last_seq_rx = entry->last_seq_rx;
+    n->next_seq_tx = entry->next_seq_tx ? entry->next_seq_tx : 1;
+    n->dir_slot = slot;
+
+    /* Most page-ins only need to know the node exists - derive the secret on first use */
+    n->secret_valid = false;
+    secrets_pending++;
+    link_quality_init(&n->link);
+    count_node_type(n->node_type, true);
+    node_dir_touch(slot);
+
+    neighbors_mark_dirty();
+
+    DEBUG_INFOF("[Neighbors] Paged in %s (0x%02x) from directory slot %u", n->name, n->hash, slot);
+}
+
+struct meshgrid_neighbor* neighbor_find(uint8_t hash) {
+    struct meshgrid_neighbor* n = hot_find(hash);
+    if (n == nullptr) {
+        struct node_dir_entry entry;
+        uint16_t slot = node_dir_lookup(hash, &entry);
+        if (slot == NODE_DIR_NONE) {
+            return nullptr;
+        }
+        n = hot_slot();
+        page_in(n, &entry, slot);
+    }
+    n->last_used = millis();
+    return n;
+}
+
 enum meshgrid_node_type infer_node_type(const char* name) {
     if (strncmp(name, "rpt-", 4) == 0 || strncmp(name, "RPT", 3) == 0 || strstr(name, "relay") ||
         strstr(name, "Relay") || strstr(name, "repeater") || strstr(name, "Repeater")) {
@@ -61,84 +244,47 @@ enum meshgrid_firmware infer_firmware(const char* name) {
 void neighbor_update(const uint8_t* pubkey, const char* name, uint32_t timestamp, int16_t rssi, int8_t snr,
                      uint8_t hops, uint8_t protocol_version) {
     uint8_t hash = crypto_hash_pubkey(pubkey);
-    struct meshgrid_neighbor* n = neighbor_find(hash);
+    struct meshgrid_neighbor* n = hot_find(hash);
     bool is_new = false;
+    bool dir_dirty = false;
 
     DEBUG_INFOF("[Neighbors] neighbor_update: name=%s, hash=0x%02x, rssi=%d, snr=%d, found=%s", name, hash, rssi, snr,
                 n ? "yes" : "no");
 
     if (n == nullptr) {
-        is_new = true;
-        /* Add new neighbor */
-        if (neighbor_count >= MAX_NEIGHBORS) {
-            /* Table full - remove oldest */
-            uint32_t oldest_time = neighbors[0].last_seen;
-            int oldest_idx = 0;
-            for (int i = 1; i < neighbor_count; i++) {
-                if (neighbors[i].last_seen < oldest_time) {
-                    oldest_time = neighbors[i].last_seen;
-                    oldest_idx = i;
-                }
-            }
-            /* Decrement stat for old node type */
-            switch (neighbors[oldest_idx].node_type) {
-                case NODE_TYPE_CLIENT:
-                    if (stat_clients > 0)
-                        stat_clients--;
-                    break;
-                case NODE_TYPE_REPEATER:
-                    if (stat_repeaters > 0)
-                        stat_repeaters--;
-                    break;
-                case NODE_TYPE_ROOM:
-                    if (stat_rooms > 0)
-                        stat_rooms--;
-                    break;
-                default:
-                    break;
-            }
-            n = &neighbors[oldest_idx];
+        struct node_dir_entry entry;
+        uint16_t slot = node_dir_find(pubkey, NODE_DIR_NONE, &entry);
+        n = hot_slot();
+
+        if (slot != NODE_DIR_NONE) {
+            /* Known node back in range - keeps its v1 sequence counters */
+            page_in(n, &entry, slot);
         } else {
-            n = &neighbors[neighbor_count++];
-        }
+            is_new = true;
+            dir_dirty = true;
 
-        memcpy(n->pubkey, pubkey, MESHGRID_PUBKEY_SIZE);
-        n->hash = hash;
+            memcpy(n->pubkey, pubkey, MESHGRID_PUBKEY_SIZE);
+            n->hash = hash;
 
-        /* Sanitize name - remove control characters */
-        size_t write_pos = 0;
-        for (size_t i = 0; name[i] != '\0' && write_pos < MESHGRID_NODE_NAME_MAX; i++) {
-            if (name[i] >= 32 && name[i] <= 126) { /* Only printable ASCII */
-                n->name[write_pos++] = name[i];
-            }
-        }
-        n->name[write_pos] = '\0';
-        n->node_type = infer_node_type(name);
-        n->firmware = infer_firmware(name);
-        n->protocol_version = protocol_version;
-        n->hops = hops;
+            /* Sanitize name - remove control characters */
+            copy_name(n->name, name);
+            n->node_type = infer_node_type(name);
+            n->firmware = infer_firmware(name);
+            n->protocol_version = protocol_version;
+            n->hops = hops;
 
-        /* Calculate and cache shared secret (ECDH) - like MeshCore does */
-        crypto_key_exchange(n->shared_secret, mesh.privkey, pubkey);
-        n->secret_valid = true;
+            /* Calculate and cache shared secret (ECDH) - like MeshCore does */
+            crypto_key_exchange(n->shared_secret, mesh.privkey, pubkey);
+            n->secret_valid = true;
 
-        /* Initialize sequence counters for Protocol v1 */
-        n->last_seq_rx = 0;
-        n->next_seq_tx = 1; /* Start at 1 (0 reserved for handshake) */
-
-        /* Update type stats */
-        switch (n->node_type) {
-            case NODE_TYPE_CLIENT:
-                stat_clients++;
-                break;
-            case NODE_TYPE_REPEATER:
-                stat_repeaters++;
-                break;
-            case NODE_TYPE_ROOM:
-                stat_rooms++;
-                break;
-            default:
-                break;
+            /* Initialize sequence counters for Protocol v1 */
+            n->last_seq_rx = 0;
+            n->next_seq_tx = 1; /* Start at 1 (0 reserved for handshake) */
+
+            link_quality_init(&n->link);
+
+            /* Update type stats */
+            count_node_type(n->node_type, true);
         }
     }
 
@@ -148,160 +294,336 @@ void neighbor_update(const uint8_t* pubkey, const char* name, uint32_t timestamp
         n->name[MESHGRID_NODE_NAME_MAX] = '\0';
 
         /* Re-infer firmware and node type based on new name */
+        count_node_type(n->node_type, false);
         n->firmware = infer_firmware(name);
         n->node_type = infer_node_type(name);
+        count_node_type(n->node_type, true);
+        dir_dirty = true;
+    }
+    if (n->protocol_version != protocol_version) {
+        dir_dirty = true;
     }
 
     n->last_seen = millis();
+    n->last_used = millis();
     n->advert_timestamp = timestamp;
     n->rssi = rssi;
     n->snr = snr;
     n->protocol_version = protocol_version; /* Update protocol version from latest advert */
+    bool was_direct = !is_new && n->hops == 0;
     if (hops < n->hops)
         n->hops = hops; /* Track shortest path */
     last_activity_time = millis();
 
+    /* Directory write only when something it keeps changed; otherwise just recency */
+    if (dir_dirty) {
+        dir_save(n);
+        neighbors_mark_dirty();
+    } else {
+        node_dir_touch(n->dir_slot);
+    }
+
+    /* Local advert pacing: a new direct neighbor changes the neighborhood,
+     * a known one re-advertising confirms it */
+    if (hops == 0) {
+        if (was_direct) {
+            advertising_heard_consistent();
+        } else {
+            advertising_topology_changed();
+        }
+    }
+
+    /* Adverts overdue past the sender's max gap count as lost frames; a zero-hop advert
+     * that created the entry also gives the first link measurement */
+    link_quality_note_advert(&n->link, millis());
+    if (hops == 0 && !n->link.seeded) {
+        link_quality_note_rx(&n->link, rssi, snr);
+    }
+
     if (is_new) {
         DEBUG_INFOF("[Neighbors] NEW neighbor added: %s (0x%02x), total neighbors: %d", name, hash, neighbor_count);
     }
+}
 
-    /* Save neighbors to NVS when new neighbor added (batched - save every 5 new neighbors) */
-    static uint8_t neighbors_since_save = 0;
-    if (is_new) {
-        neighbors_since_save++;
-        if (neighbors_since_save >= 5) {
-            neighbors_save_to_nvs();
-            neighbors_since_save = 0;
-        }
+void neighbor_note_frame(uint8_t hash, int16_t rssi, int8_t snr) {
+    struct meshgrid_neighbor* n = hot_find(hash); /* Not worth paging a node in for */
+    if (n) {
+        link_quality_note_rx(&n->link, rssi, snr);
     }
 }
 
 const uint8_t* neighbor_get_shared_secret(uint8_t hash) {
     struct meshgrid_neighbor* n = neighbor_find(hash);
-    if (n && n->secret_valid) {
+    if (n && neighbor_ensure_secret(n)) {
         return n->shared_secret;
     }
     return nullptr;
 }
 
-void neighbors_save_to_nvs(void) {
-    Preferences prefs;
-    prefs.begin("neighbors", false); // Read-write
-
-    /* Set NVS format version */
-    prefs.putUChar("version", 1);
-
-    /* Save up to 10 most recent neighbors with valid secrets */
-    uint8_t saved_count = 0;
-    for (int i = 0; i < neighbor_count && saved_count < 10; i++) {
-        if (neighbors[i].secret_valid) {
-            char key[16];
-            snprintf(key, sizeof(key), "n%d_hash", saved_count);
-            prefs.putUChar(key, neighbors[i].hash);
-
-            snprintf(key, sizeof(key), "n%d_pubkey", saved_count);
-            prefs.putBytes(key, neighbors[i].pubkey, MESHGRID_PUBKEY_SIZE);
-
-            snprintf(key, sizeof(key), "n%d_name", saved_count);
-            prefs.putString(key, neighbors[i].name);
+bool neighbor_ensure_secret(struct meshgrid_neighbor* n) {
+    if (!n->secret_valid) {
+        crypto_key_exchange(n->shared_secret, mesh.privkey, n->pubkey);
+        n->secret_valid = true;
+        if (secrets_pending > 0) {
+            secrets_pending--;
+        }
+    }
+    return n->secret_valid;
+}
 
-            /* Save sequence numbers (Protocol v1) */
-            snprintf(key, sizeof(key), "n%d_seqrx", saved_count);
-            prefs.putUInt(key, neighbors[i].last_seq_rx);
+bool neighbors_derive_step(void) {
+    if (secrets_pending == 0) {
+        return false;
+    }
+    for (uint16_t i = 0; i < neighbor_count; i++) {
+        if (!neighbors[i].secret_valid) {
+            neighbor_ensure_secret(&neighbors[i]);
+            return true;
+        }
+    }
+    secrets_pending = 0; /* The rest were evicted before their turn */
+    return false;
+}
 
-            snprintf(key, sizeof(key), "n%d_seqtx", saved_count);
-            prefs.putUInt(key, neighbors[i].next_seq_tx);
+/* Entries to snapshot: the NEIGHBOR_SNAPSHOT_MAX most recently used, newest first */
+static uint16_t snapshot_pick(uint16_t* order) {
+    for (uint16_t i = 0; i < neighbor_count; i++) {
+        order[i] = i;
+    }
+    uint16_t count = neighbor_count < NEIGHBOR_SNAPSHOT_MAX ? neighbor_count : NEIGHBOR_SNAPSHOT_MAX;
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t newest = i;
+        for (uint16_t j = i + 1; j < neighbor_count; j++) {
+            if ((int32_t)(neighbors[order[j]].last_used - neighbors[order[newest]].last_used) > 0) {
+                newest = j;
+            }
+        }
+        uint16_t tmp = order[i];
+        order[i] = order[newest];
+        order[newest] = tmp;
+    }
+    return count;
+}
 
-            /* NOTE: We do NOT store shared_secret in NVS for security.
-             * Shared secrets are recalculated from public keys on boot.
-             * This prevents physical compromise from leaking all secrets. */
+bool neighbors_save_to_nvs(void) {
+    if (!snapshot) {
+        return false; /* Not loaded yet - would overwrite the saved table */
+    }
 
-            saved_count++;
-        }
+    uint16_t order[MAX_NEIGHBORS];
+    uint16_t count = snapshot_pick(order);
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->version = SNAPSHOT_VERSION;
+    snapshot->count = count;
+    for (uint16_t i = 0; i < count; i++) {
+        const struct meshgrid_neighbor* n = &neighbors[order[i]];
+        struct snapshot_entry* e = &snapshot->entries[i];
+        memcpy(e->pubkey, n->pubkey, MESHGRID_PUBKEY_SIZE);
+        strncpy(e->name, n->name, MESHGRID_NODE_NAME_MAX);
+        e->protocol_version = n->protocol_version;
+        e->hops = n->hops;
+        e->dir_slot = n->dir_slot;
+        e->last_seq_rx = n->last_seq_rx;
+        e->next_seq_tx = n->next_seq_tx;
     }
+    size_t entries_len = count * sizeof(struct snapshot_entry);
+    snapshot->crc = crc16_ccitt((const uint8_t*)snapshot->entries, entries_len);
 
-    prefs.putUChar("count", saved_count);
+    /* One blob, one NVS commit */
+    Preferences prefs;
+    prefs.begin("neighbors", false);
+    size_t len = offsetof(struct neighbor_snapshot, entries) + entries_len;
+    bool ok = prefs.putBytes("table", snapshot, len) == len;
+    if (!ok) {
+        DEBUG_WARN("[Neighbors] Snapshot write failed");
+    }
     prefs.end();
-}
 
-void neighbors_load_from_nvs(void) {
-    Preferences prefs;
-    prefs.begin("neighbors", false); // Read-write for version check
+    snapshot_dirty = false;
+    last_commit = millis();
+    return ok;
+}
 
-    /* Check NVS format version - clear if incompatible */
-    uint8_t nvs_version = prefs.getUChar("version", 0);
-    if (nvs_version != 1) {
-        DEBUG_INFO("Incompatible neighbor NVS format, clearing...");
-        prefs.clear();
-        prefs.putUChar("version", 1);
-        prefs.end();
-        return;
+bool neighbors_persist_loop(void) {
+    if (!snapshot_dirty) {
+        return false;
     }
+    /* Let a burst of changes settle, and commit at most once per interval */
+    uint32_t now = millis();
+    if (now - dirty_since < NEIGHBOR_SAVE_DELAY_MS || now - last_commit < NEIGHBOR_SAVE_INTERVAL_MS) {
+        return false;
+    }
+    neighbors_save_to_nvs();
+    return true;
+}
 
-    uint8_t saved_count = prefs.getUChar("count", 0);
-    if (saved_count > 10)
-        saved_count = 10; // Sanity check
+/* Put a saved neighbor back in the table; nullptr if its name has nothing printable */
+static struct meshgrid_neighbor* restore_neighbor(const uint8_t* pubkey, const char* name, uint32_t last_used) {
+    struct meshgrid_neighbor* n = &neighbors[neighbor_count];
+    memset(n, 0, sizeof(*n));
+    copy_name(n->name, name);
+    if (n->name[0] == '\0') {
+        return nullptr;
+    }
+    memcpy(n->pubkey, pubkey, MESHGRID_PUBKEY_SIZE);
+    n->hash = crypto_hash_pubkey(n->pubkey);
+
+    /* Shared secret is recalculated from the public key after boot (not stored, for security) */
+    n->secret_valid = false;
+    secrets_pending++;
+    n->last_seen = millis(); /* Not heard since boot */
+    n->last_used = last_used;
+    n->node_type = infer_node_type(n->name);
+    n->firmware = infer_firmware(n->name);
+    link_quality_init(&n->link);
+    count_node_type(n->node_type, true);
+    neighbor_count++;
+    return n;
+}
 
-    DEBUG_INFOF("Loading %d neighbors from NVS...", saved_count);
+/* Per-key layout of earlier firmware: "version" 1, "count", then n<i>_<field> per entry */
+#define LEGACY_FORMAT 1
+#define LEGACY_MAX 10
 
-    for (uint8_t i = 0; i < saved_count; i++) {
-        if (neighbor_count >= MAX_NEIGHBORS)
-            break;
+static const char* const legacy_fields[] = {"hash", "pubkey", "name", "seqrx", "seqtx"};
 
-        struct meshgrid_neighbor* n = &neighbors[neighbor_count];
+/* Read the per-key layout into the table and the node directory; entries read */
+static uint16_t legacy_load(Preferences& prefs) {
+    uint8_t saved_count = prefs.getUChar("count", 0);
+    if (saved_count > LEGACY_MAX) {
+        saved_count = LEGACY_MAX; // Sanity check
+    }
 
+    uint32_t now = millis();
+    uint16_t loaded = 0;
+    for (uint8_t i = 0; i < saved_count && neighbor_count < MAX_NEIGHBORS; i++) {
         char key[16];
-        snprintf(key, sizeof(key), "n%d_hash", i);
-        n->hash = prefs.getUChar(key, 0);
-        if (n->hash == 0)
-            continue; // Invalid
-
+        uint8_t pubkey[MESHGRID_PUBKEY_SIZE];
         snprintf(key, sizeof(key), "n%d_pubkey", i);
-        if (prefs.getBytes(key, n->pubkey, MESHGRID_PUBKEY_SIZE) != MESHGRID_PUBKEY_SIZE)
+        if (prefs.getBytes(key, pubkey, MESHGRID_PUBKEY_SIZE) != MESHGRID_PUBKEY_SIZE) {
             continue;
-
+        }
         snprintf(key, sizeof(key), "n%d_name", i);
         String name = prefs.getString(key, "");
-        if (name.length() == 0)
+        struct meshgrid_neighbor* n = restore_neighbor(pubkey, name.c_str(), now - loaded);
+        if (!n) {
             continue;
-
-        /* Sanitize name - remove control characters from NVS */
-        size_t write_pos = 0;
-        for (size_t read_pos = 0; read_pos < name.length() && write_pos < MESHGRID_NODE_NAME_MAX; read_pos++) {
-            char c = name[read_pos];
-            if (c >= 32 && c <= 126) { /* Only printable ASCII */
-                n->name[write_pos++] = c;
-            }
         }
-        n->name[write_pos] = '\0';
-
-        if (write_pos == 0)
-            continue; /* Skip if name is all control chars */
 
-        /* Recalculate shared secret from public key (don't load from NVS for security) */
-        crypto_key_exchange(n->shared_secret, mesh.privkey, n->pubkey);
-        n->secret_valid = true;
-        n->last_seen = millis(); // Mark as old
-        n->node_type = infer_node_type(n->name);
-        n->firmware = infer_firmware(n->name);
-
-        /* Load sequence numbers (Protocol v1) */
+        /* Protocol v1 sequence numbers */
         snprintf(key, sizeof(key), "n%d_seqrx", i);
         n->last_seq_rx = prefs.getUInt(key, 0);
-
         snprintf(key, sizeof(key), "n%d_seqtx", i);
         n->next_seq_tx = prefs.getUInt(key, 1);
-        if (n->next_seq_tx == 0)
+        if (n->next_seq_tx == 0) {
             n->next_seq_tx = 1; /* Ensure never 0 */
+        }
 
-        neighbor_count++;
+        /* These counters are newer than any directory record - write it over in place */
+        struct node_dir_entry entry;
+        n->dir_slot = node_dir_find(n->pubkey, NODE_DIR_NONE, &entry);
+        if (n->dir_slot != NODE_DIR_NONE) {
+            n->protocol_version = entry.protocol_version; /* Not in the per-key layout */
+        }
+        dir_save(n);
+        loaded++;
 
-        DEBUG_INFOF("  Restored: %s (0x%02x)", n->name, n->hash);
+        DEBUG_INFOF("  Migrated: %s (0x%02x)", n->name, n->hash);
     }
+    return loaded;
+}
 
+static void legacy_clear(void) {
+    Preferences prefs;
+    if (prefs.begin("neighbors", false)) {
+        /* Version first: a clear cut short leaves stray keys, never a second migration */
+        prefs.remove("version");
+        prefs.remove("count");
+        for (int i = 0; i < LEGACY_MAX; i++) {
+            for (size_t f = 0; f < sizeof(legacy_fields) / sizeof(legacy_fields[0]); f++) {
+                char key[16];
+                snprintf(key, sizeof(key), "n%d_%s", i, legacy_fields[f]);
+                prefs.remove(key);
+            }
+        }
+    }
     prefs.end();
 }
 
+void neighbors_load_from_nvs(void) {
+    if (!snapshot) {
+        snapshot = (struct neighbor_snapshot*)arena_alloc(ARENA_COLD, sizeof(struct neighbor_snapshot),
+                                                          "nbr_snapshot");
+    }
+
+    Preferences prefs;
+    prefs.begin("neighbors", false); // Read-write for format check
+
+    uint8_t format = prefs.getUChar("version", 0);
+    if (format == LEGACY_FORMAT) {
+        uint16_t loaded = legacy_load(prefs);
+        prefs.end();
+        /* One-time migration: the keys go once the blob holding their entries is on flash */
+        if (neighbors_save_to_nvs()) {
+            legacy_clear();
+            DEBUG_INFOF("Migrated %d neighbors to the snapshot blob", loaded);
+        }
+        return;
+    }
+    if (format != 0) {
+        DEBUG_INFO("Incompatible neighbor NVS format, clearing...");
+        prefs.clear();
+        prefs.end();
+        return;
+    }
+
+    size_t len = prefs.getBytesLength("table");
+    size_t header = offsetof(struct neighbor_snapshot, entries);
+    bool ok = len >= header && len <= sizeof(*snapshot) && prefs.getBytes("table", snapshot, len) == len;
+    prefs.end();
+    if (len == 0) {
+        return;
+    }
+
+    size_t entries_len = len - header;
+    if (!ok || snapshot->version != SNAPSHOT_VERSION || snapshot->count > NEIGHBOR_SNAPSHOT_MAX ||
+        entries_len != snapshot->count * sizeof(struct snapshot_entry) ||
+        crc16_ccitt((const uint8_t*)snapshot->entries, entries_len) != snapshot->crc) {
+        DEBUG_WARN("Neighbor snapshot invalid, ignoring");
+        return;
+    }
+
+    DEBUG_INFOF("Loading %d neighbors from NVS...", snapshot->count);
+
+    uint32_t now = millis();
+    for (uint16_t i = 0; i < snapshot->count && neighbor_count < MAX_NEIGHBORS; i++) {
+        const struct snapshot_entry* e = &snapshot->entries[i];
+        char name[MESHGRID_NODE_NAME_MAX + 1];
+        memcpy(name, e->name, MESHGRID_NODE_NAME_MAX);
+        name[MESHGRID_NODE_NAME_MAX] = '\0';
+
+        struct meshgrid_neighbor* n = restore_neighbor(e->pubkey, name, now - i); /* Keep the saved LRU order */
+        if (!n) {
+            continue; /* Skip if name is all control chars */
+        }
+        n->protocol_version = e->protocol_version;
+        n->hops = e->hops;
+
+        /* Protocol v1 sequence numbers */
+        n->last_seq_rx = e->last_seq_rx;
+        n->next_seq_tx = e->next_seq_tx ? e->next_seq_tx : 1; /* Ensure never 0 */
+
+        /* Link to its directory record, or seed the directory with it */
+        struct node_dir_entry entry;
+        n->dir_slot = node_dir_find(n->pubkey, e->dir_slot, &entry);
+        if (n->dir_slot == NODE_DIR_NONE) {
+            dir_save(n);
+        }
+
+        DEBUG_INFOF("  Restored: %s (0x%02x)", n->name, n->hash);
+    }
+}
+
 void neighbors_prune_stale(void) {
     uint32_t now = millis();
 
@@ -310,22 +632,11 @@ void neighbors_prune_stale(void) {
 
         /* Remove if not seen for NEIGHBOR_TIMEOUT */
         if (age_ms > MESHGRID_NEIGHBOR_TIMEOUT_MS) {
-            /* Decrement stat for removed node type */
-            switch (neighbors[i].node_type) {
-                case NODE_TYPE_CLIENT:
-                    if (stat_clients > 0)
-                        stat_clients--;
-                    break;
-                case NODE_TYPE_REPEATER:
-                    if (stat_repeaters > 0)
-                        stat_repeaters--;
-                    break;
-                case NODE_TYPE_ROOM:
-                    if (stat_rooms > 0)
-                        stat_rooms--;
-                    break;
-                default:
-                    break;
+            neighbor_retire(&neighbors[i]);
+            neighbors_mark_dirty();
+
+            if (neighbors[i].hops == 0) {
+                advertising_topology_changed(); /* Lost a direct neighbor */
             }
 
             /* Remove by shifting array left */
@@ -16,29 +16,56 @@ extern "C" {
 extern struct meshgrid_neighbor neighbors[MAX_NEIGHBORS];
 extern uint16_t neighbor_count; /* uint16_t to support 512 neighbors */
 
-/* Find neighbor by hash */
+#define NEIGHBOR_HOPS_UNKNOWN 0xFF /* Paged in from the node directory, not heard yet */
+
+/* Find neighbor by hash - a node the table dropped is paged back in from the
+ * node directory, evicting the least recently used entry */
 struct meshgrid_neighbor* neighbor_find(uint8_t hash);
 
 /* Update or add neighbor */
 void neighbor_update(const uint8_t* pubkey, const char* name, uint32_t timestamp, int16_t rssi, int8_t snr,
                      uint8_t hops, uint8_t protocol_version);
 
+/* A frame transmitted by this neighbor was received - feeds its link quality */
+void neighbor_note_frame(uint8_t hash, int16_t rssi, int8_t snr);
+
 /* Get cached shared secret for neighbor (returns nullptr if not found/valid) */
 const uint8_t* neighbor_get_shared_secret(uint8_t hash);
 
+/* Derive n's ECDH secret now if it was restored at boot and the background step
+ * has not reached it yet. true once the secret is valid */
+bool neighbor_ensure_secret(struct meshgrid_neighbor* n);
+
+/* Deferred boot work: derives the secret of one neighbor restored from NVS.
+ * false once none is left */
+bool neighbors_derive_step(void);
+
 /* Infer node type from name */
 enum meshgrid_node_type infer_node_type(const char* name);
 
 /* Infer firmware from name */
 enum meshgrid_firmware infer_firmware(const char* name);
 
-/* Save neighbors to NVS (up to 10 with valid secrets) */
-void neighbors_save_to_nvs(void);
+/* Write the NEIGHBOR_SNAPSHOT_MAX most recently used neighbors to NVS as one blob, now;
+ * false if NVS refused it */
+bool neighbors_save_to_nvs(void);
 
-/* Load neighbors from NVS on boot */
+/* Table changed in a way worth persisting - saved later by neighbors_persist_loop() */
+void neighbors_mark_dirty(void);
+
+/* Write-behind from the main loop: saves a dirty table once changes have settled
+ * for NEIGHBOR_SAVE_DELAY_MS, at most once per NEIGHBOR_SAVE_INTERVAL_MS. true if it wrote */
+bool neighbors_persist_loop(void);
+
+/* Load neighbors from NVS on boot - one blob read (after node_dir_init). The per-key
+ * layout of earlier firmware is migrated into the blob and the node directory once.
+ * Shared secrets are derived later, by neighbors_derive_step() or on first use */
 void neighbors_load_from_nvs(void);
 
-/* Prune stale neighbors (not seen for NEIGHBOR_TIMEOUT) */
+/* Prune stale neighbors (not seen for NEIGHBOR_TIMEOUT) - they stay in the node directory */
 void neighbors_prune_stale(void);
 
+/* Neighbors heard directly (0 hops) - local density for flood suppression */
+uint16_t neighbors_direct_count(void);
+
 #endif /* MESHGRID_NEIGHBORS_H */
@@ -0,0 +1,393 @@
+/**
+ * Node directory - every node ever heard, kept on flash
+ *
+ * NODE_DIR_PATH holds one 64-byte record per slot, written in place.
+ * A record carries a CRC-16/CCITT and the directory clock when it was
+ * written; a torn write fails the CRC at boot and frees the slot. The
+ * clock restarts from the newest stamp on flash, so recency survives a
+ * reboot as of each node's last write.
+ *
+ * Slots are taken in file order, and queued writes reach flash in the
+ * order they were queued, so a write never lands beyond the end of the
+ * file. A failed write stays at the head of the queue and is retried
+ * from the main loop; its slot stays with its node either way, so a
+ * neighbor's slot hint never ends up pointing at a slot handed to
+ * someone else.
+ */
+
+#include "node_dir.h"
+#include "utils/debug.h"
+#include "utils/arena.h"
+#include "utils/crc16.h"
+#include <Arduino.h>
+#include <string.h>
+
+#if NODE_DIR_ENABLED
+#    include <LittleFS.h>
+#endif
+
+extern "C" {
+#include "hardware/crypto/crypto.h"
+}
+
+#if NODE_DIR_ENABLED
+
+#    define NODE_DIR_PATH "/nodes.dir"
+#    define NODE_DIR_WRITE_TRIES 3 /* Attempts at one record before it is dropped */
+
+struct dir_record {
+    uint16_t crc; /* CRC-16/CCITT of the rest of the record */
+    uint8_t hash;
+    uint8_t protocol_version;
+    uint32_t stamp; /* Directory clock when written, never 0 */
+    uint8_t pubkey[MESHGRID_PUBKEY_SIZE];
+    uint32_t last_seq_rx;
+    uint32_t next_seq_tx;
+    char name[MESHGRID_NODE_NAME_MAX]; /* Unterminated */
+};
+
+static_assert(sizeof(struct dir_record) == 64, "Records are 64 bytes on flash");
+static_assert(NODE_DIR_CAPACITY < NODE_DIR_NONE, "Slots are 16 bits");
+
+struct pending_write {
+    uint16_t slot;
+    uint8_t attempts; /* Failed writes so far */
+    struct dir_record rec;
+};
+
+/* Per slot, one cold boot arena block: stamps (0 = free), then hashes */
+static uint32_t* slot_stamp;
+static uint8_t* slot_hash;
+static uint16_t slot_top; /* Slots ever taken - the file holds [0, slot_top) once flushed */
+static uint32_t clock_now;
+
+static struct pending_write queue[NODE_DIR_PENDING];
+static uint8_t queue_len;
+
+static struct node_dir_stats stats;
+
+static uint16_t record_crc(const struct dir_record* rec) {
+    return crc16_ccitt((const uint8_t*)rec + sizeof(rec->crc), sizeof(*rec) - sizeof(rec->crc));
+}
+
+static void encode(struct dir_record* rec, const struct node_dir_entry* entry, uint32_t stamp) {
+    memset(rec, 0, sizeof(*rec));
+    rec->hash = crypto_hash_pubkey(entry->pubkey);
+    rec->protocol_version = entry->protocol_version;
+    rec->stamp = stamp;
+    memcpy(rec->pubkey, entry->pubkey, MESHGRID_PUBKEY_SIZE);
+    rec->last_seq_rx = entry->last_seq_rx;
+    rec->next_seq_tx = entry->next_seq_tx;
+    strncpy(rec->name, entry->name, MESHGRID_NODE_NAME_MAX);
+    rec->crc = record_crc(rec);
+}
+
+static bool record_valid(const struct dir_record* rec) {
+    return rec->stamp != 0 && record_crc(rec) == rec->crc;
+}
+
+static void decode(const struct dir_record* rec, struct node_dir_entry* out) {
+    memcpy(out->pubkey, rec->pubkey, MESHGRID_PUBKEY_SIZE);
+    memcpy(out->name, rec->name, MESHGRID_NODE_NAME_MAX);
+    out->name[MESHGRID_NODE_NAME_MAX] = '\0';
+    out->protocol_version = rec->protocol_version;
+    out->last_seq_rx = rec->last_seq_rx;
+    out->next_seq_tx = rec->next_seq_tx;
+}
+
+static bool write_record(File& f, struct pending_write* w) {
+    if (f && f.seek((uint32_t)w->slot * sizeof(struct dir_record)) &&
+        f.write((const uint8_t*)&w->rec, sizeof(w->rec)) == sizeof(w->rec)) {
+        stats.writes++;
+        return true;
+    }
+    /* The slot stays taken - a stale record on flash fails the pubkey check on lookup */
+    stats.write_errors++;
+    w->attempts++;
+    DEBUG_WARNF("Node directory: write of slot %u failed", w->slot);
+    return false;
+}
+
+/* Write the oldest n queued records in one open. With retry, a failed record
+ * that has tries left stays at the head (and the rest behind it, in order) */
+static void write_queued(uint8_t n, bool retry) {
+    if (n == 0) {
+        return;
+    }
+    File f = LittleFS.open(NODE_DIR_PATH, "r+");
+    uint8_t done = 0;
+    while (done < n) {
+        if (!write_record(f, &queue[done]) && retry && queue[done].attempts < NODE_DIR_WRITE_TRIES) {
+            break;
+        }
+        done++;
+    }
+    if (f) {
+        f.close();
+    }
+    queue_len -= done;
+    memmove(queue, queue + done, queue_len * sizeof(queue[0]));
+}
+
+/* Record in slot, from the write queue if it has not reached flash yet */
+static bool read_record(File& f, uint16_t slot, struct dir_record* rec) {
+    for (uint8_t i = 0; i < queue_len; i++) {
+        if (queue[i].slot == slot) {
+            *rec = queue[i].rec;
+            return true;
+        }
+    }
+    if (!f) {
+        f = LittleFS.open(NODE_DIR_PATH, FILE_READ);
+    }
+    stats.lookups++;
+    return f && f.seek((uint32_t)slot * sizeof(struct dir_record)) &&
+           f.read((uint8_t*)rec, sizeof(*rec)) == sizeof(*rec) && record_valid(rec);
+}
+
+/* Free slot in file order, else the least recently heard node's */
+static uint16_t take_slot(void) {
+    for (uint16_t i = 0; i < slot_top; i++) {
+        if (slot_stamp[i] == 0) {
+            return i;
+        }
+    }
+    if (slot_top < NODE_DIR_CAPACITY) {
+        return slot_top++;
+    }
+    uint16_t oldest = 0;
+    for (uint16_t i = 1; i < NODE_DIR_CAPACITY; i++) {
+        if (slot_stamp[i] < slot_stamp[oldest]) {
+            oldest = i;
+        }
+    }
+    stats.replaced++;
+    return oldest;
+}
+
+void node_dir_init(void) {
+    if (!slot_stamp) {
+        uint8_t* mem = (uint8_t*)arena_alloc(ARENA_COLD, NODE_DIR_CAPACITY * 5, "nodedir_index");
+        slot_stamp = (uint32_t*)mem;
+        slot_hash = mem + NODE_DIR_CAPACITY * sizeof(uint32_t);
+    }
+    memset(&stats, 0, sizeof(stats));
+    memset(slot_stamp, 0, NODE_DIR_CAPACITY * sizeof(uint32_t));
+    slot_top = 0;
+    clock_now = 0;
+    queue_len = 0;
+
+    /* Formats the partition on first boot */
+    if (!LittleFS.begin(true, "/littlefs", 4, "spiffs")) {
+        DEBUG_WARN("Node directory: filesystem mount failed, neighbor table only");
+        return;
+    }
+    File f = LittleFS.open(NODE_DIR_PATH, FILE_READ);
+    if (!f) {
+        f = LittleFS.open(NODE_DIR_PATH, FILE_WRITE); /* Create it empty */
+        if (!f) {
+            DEBUG_WARN("Node directory: cannot create " NODE_DIR_PATH);
+            return;
+        }
+        f.close();
+        stats.mounted = true;
+        return;
+    }
+
+    uint32_t records = f.size() / sizeof(struct dir_record);
+    slot_top = records < NODE_DIR_CAPACITY ? (uint16_t)records : NODE_DIR_CAPACITY;
+
+    struct dir_record chunk[16];
+    for (uint16_t base = 0; base < slot_top; base += 16) {
+        uint16_t n = slot_top - base < 16 ? slot_top - base : 16;
+        size_t got = f.read((uint8_t*)chunk, n * sizeof(struct dir_record)) / sizeof(struct dir_record);
+        for (uint16_t i = 0; i < n; i++) {
+            if (i >= got || !record_valid(&chunk[i])) {
+                stats.corrupt++;
+                continue;
+            }
+            slot_stamp[base + i] = chunk[i].stamp;
+            slot_hash[base + i] = chunk[i].hash;
+            if (chunk[i].stamp > clock_now) {
+                clock_now = chunk[i].stamp;
+            }
+            stats.nodes++;
+        }
+    }
+    f.close();
+
+    stats.mounted = true;
+    DEBUG_INFOF("Node directory: %u nodes in %u slots, %lu bad", stats.nodes, slot_top,
+                (unsigned long)stats.corrupt);
+}
+
+uint16_t node_dir_lookup(uint8_t hash, struct node_dir_entry* out) {
+    if (!stats.mounted) {
+        return NODE_DIR_NONE;
+    }
+    uint16_t best = NODE_DIR_NONE;
+    for (uint16_t i = 0; i < slot_top; i++) {
+        if (slot_hash[i] != hash || slot_stamp[i] == 0) {
+            continue;
+        }
+        if (best == NODE_DIR_NONE || slot_stamp[i] > slot_stamp[best]) {
+            best = i;
+        }
+    }
+    if (best == NODE_DIR_NONE) {
+        return NODE_DIR_NONE;
+    }
+
+    File f;
+    struct dir_record rec;
+    bool ok = read_record(f, best, &rec) && rec.hash == hash;
+    if (f) {
+        f.close();
+    }
+    if (!ok) {
+        return NODE_DIR_NONE;
+    }
+    decode(&rec, out);
+    return best;
+}
+
+uint16_t node_dir_find(const uint8_t* pubkey, uint16_t hint, struct node_dir_entry* out) {
+    if (!stats.mounted) {
+        return NODE_DIR_NONE;
+    }
+    uint8_t hash = crypto_hash_pubkey(pubkey);
+    uint16_t found = NODE_DIR_NONE;
+    File f;
+    struct dir_record rec;
+    for (uint32_t n = 0; n <= slot_top && found == NODE_DIR_NONE; n++) {
+        /* The hint first, then every other slot with the hash */
+        uint16_t i = n == 0 ? hint : (uint16_t)(n - 1);
+        if ((n > 0 && i == hint) || i >= slot_top || slot_hash[i] != hash || slot_stamp[i] == 0) {
+            continue;
+        }
+        if (read_record(f, i, &rec) && memcmp(rec.pubkey, pubkey, MESHGRID_PUBKEY_SIZE) == 0) {
+            decode(&rec, out);
+            found = i;
+        }
+    }
+    if (f) {
+        f.close();
+    }
+    return found;
+}
+
+uint16_t node_dir_put(uint16_t slot, const struct node_dir_entry* entry) {
+    if (!stats.mounted) {
+        return NODE_DIR_NONE;
+    }
+    /* A hint is only reused while the slot still holds a node with this hash -
+     * after a replacement or a clear it belongs to someone else (or nobody) */
+    uint8_t hash = crypto_hash_pubkey(entry->pubkey);
+    if (slot >= slot_top || slot_stamp[slot] == 0 || slot_hash[slot] != hash) {
+        slot = take_slot();
+    }
+    if (slot_stamp[slot] == 0) {
+        stats.nodes++;
+    }
+    slot_stamp[slot] = ++clock_now;
+    slot_hash[slot] = hash;
+
+    /* A queued write to the same slot is superseded in place */
+    struct pending_write* w = nullptr;
+    for (uint8_t i = 0; i < queue_len; i++) {
+        if (queue[i].slot == slot) {
+            w = &queue[i];
+            break;
+        }
+    }
+    if (!w) {
+        if (queue_len == NODE_DIR_PENDING) {
+            write_queued(1, false);
+        }
+        w = &queue[queue_len++];
+        w->slot = slot;
+    }
+    w->attempts = 0;
+    encode(&w->rec, entry, slot_stamp[slot]);
+    return slot;
+}
+
+void node_dir_touch(uint16_t slot) {
+    if (slot < slot_top && slot_stamp[slot] != 0) {
+        slot_stamp[slot] = ++clock_now;
+    }
+}
+
+bool node_dir_loop(void) {
+    if (queue_len == 0) {
+        return false;
+    }
+    write_queued(1, true);
+    return true;
+}
+
+void node_dir_flush(void) {
+    write_queued(queue_len, false);
+}
+
+void node_dir_clear(void) {
+    if (!stats.mounted) {
+        return;
+    }
+    queue_len = 0;
+    memset(slot_stamp, 0, NODE_DIR_CAPACITY * sizeof(uint32_t));
+    slot_top = 0;
+    stats.nodes = 0;
+    File f = LittleFS.open(NODE_DIR_PATH, FILE_WRITE); /* Truncates */
+    if (f) {
+        f.close();
+    }
+}
+
+const struct node_dir_stats* node_dir_get_stats(void) {
+    stats.pending = queue_len;
+    return &stats;
+}
+
+#else /* !NODE_DIR_ENABLED */
+
+static struct node_dir_stats stats;
+
+void node_dir_init(void) {}
+
+uint16_t node_dir_lookup(uint8_t hash, struct node_dir_entry* out) {
+    (void)hash;
+    (void)out;
+    return NODE_DIR_NONE;
+}
+
+uint16_t node_dir_find(const uint8_t* pubkey, uint16_t hint, struct node_dir_entry* out) {
+    (void)pubkey;
+    (void)hint;
+    (void)out;
+    return NODE_DIR_NONE;
+}
+
+uint16_t node_dir_put(uint16_t slot, const struct node_dir_entry* entry) {
+    (void)slot;
+    (void)entry;
+    return NODE_DIR_NONE;
+}
+
+void node_dir_touch(uint16_t slot) {
+    (void)slot;
+}
+
+bool node_dir_loop(void) {
+    return false;
+}
+
+void node_dir_flush(void) {}
+
+void node_dir_clear(void) {}
+
+const struct node_dir_stats* node_dir_get_stats(void) {
+    return &stats;
+}
+
+#endif /* NODE_DIR_ENABLED */
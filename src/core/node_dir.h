@@ -0,0 +1,80 @@
+/**
+ * Node directory - every node ever heard, kept on flash
+ *
+ * The neighbor table holds at most MAX_NEIGHBORS nodes; when it fills,
+ * the least recently used one is dropped, and without a copy elsewhere
+ * its pubkey would be gone until its next flood advert, hours away. The
+ * directory keeps pubkey, name and protocol v1 sequence counters of up
+ * to NODE_DIR_CAPACITY nodes in fixed 64-byte records of one file on the
+ * LittleFS partition, and the neighbor table pages nodes back in from it
+ * when a packet refers to one it no longer holds.
+ *
+ * RAM keeps only the 1-byte hash and a recency stamp per slot, so a
+ * lookup for a hash nobody in the directory has never touches flash.
+ * Record writes are queued and reach flash from node_dir_loop(), which
+ * retries a failed one a few times. When the directory is full, the
+ * least recently heard node is replaced.
+ * ESP32 family only; elsewhere every lookup misses.
+ */
+
+#ifndef MESHGRID_NODE_DIR_H
+#define MESHGRID_NODE_DIR_H
+
+#include <stdint.h>
+#include "utils/memory.h"
+
+extern "C" {
+#include "network/protocol.h"
+}
+
+#define NODE_DIR_NONE 0xFFFF /* No directory slot */
+
+struct node_dir_entry {
+    uint8_t pubkey[MESHGRID_PUBKEY_SIZE];
+    char name[MESHGRID_NODE_NAME_MAX + 1];
+    uint8_t protocol_version;
+    uint32_t last_seq_rx; /* Protocol v1 replay window */
+    uint32_t next_seq_tx;
+};
+
+struct node_dir_stats {
+    uint32_t lookups;      /* Flash reads for a node the neighbor table lacked */
+    uint32_t writes;       /* Records written */
+    uint32_t replaced;     /* Nodes dropped for room */
+    uint32_t corrupt;      /* Bad records found at boot */
+    uint32_t write_errors; /* Failed record writes */
+    uint16_t nodes;        /* Slots in use */
+    uint16_t pending;      /* Queued record writes */
+    bool mounted;
+};
+
+/* Mount and index the directory file (before neighbors are restored) */
+void node_dir_init(void);
+
+/* Most recently heard node with this hash; its slot, or NODE_DIR_NONE */
+uint16_t node_dir_lookup(uint8_t hash, struct node_dir_entry* out);
+
+/* The node with this pubkey, trying slot hint first (NODE_DIR_NONE for no hint);
+ * its slot, or NODE_DIR_NONE */
+uint16_t node_dir_find(const uint8_t* pubkey, uint16_t hint, struct node_dir_entry* out);
+
+/* Queue a write of entry to slot - NODE_DIR_NONE, or a hint whose slot no longer holds
+ * a node with the entry's hash, takes a free slot or replaces the least recently heard
+ * node. Returns the slot written (callers must adopt it), NODE_DIR_NONE if unmounted */
+uint16_t node_dir_put(uint16_t slot, const struct node_dir_entry* entry);
+
+/* Node in slot was heard - keeps it from being replaced (RAM only) */
+void node_dir_touch(uint16_t slot);
+
+/* Background work from the main loop: one queued record write. true if it touched flash */
+bool node_dir_loop(void);
+
+/* Write every queued record now (before reboot) */
+void node_dir_flush(void);
+
+/* Forget every node and delete the directory file */
+void node_dir_clear(void);
+
+const struct node_dir_stats* node_dir_get_stats(void);
+
+#endif /* MESHGRID_NODE_DIR_H */
@@ -6,6 +6,7 @@
 
 #include "ble_serial.h"
 #include "utils/debug.h"
+#include "utils/arena.h"
 
 #if defined(ARDUINO_ARCH_ESP32) && defined(ENABLE_BLE)
 
@@ -88,18 +89,18 @@ int ble_serial_init(const char* device_name) {
 
     /* Create BLE Server */
     ble_server = BLEDevice::createServer();
-    ble_server->setCallbacks(new MyBLEServerCallbacks());
+    ble_server->setCallbacks(arena_new<MyBLEServerCallbacks>(ARENA_HOT, "ble_server_cb"));
 
     /* Create BLE Service */
     BLEService* service = ble_server->createService(SERVICE_UUID);
 
     /* Create TX characteristic (notify - app reads from this) */
     ble_tx_char = service->createCharacteristic(CHARACTERISTIC_UUID_TX, BLECharacteristic::PROPERTY_NOTIFY);
-    ble_tx_char->addDescriptor(new BLE2902());
+    ble_tx_char->addDescriptor(arena_new<BLE2902>(ARENA_HOT, "ble_cccd"));
 
     /* Create RX characteristic (write - app writes to this) */
     ble_rx_char = service->createCharacteristic(CHARACTERISTIC_UUID_RX, BLECharacteristic::PROPERTY_WRITE);
-    ble_rx_char->setCallbacks(new BLERxCallbacks());
+    ble_rx_char->setCallbacks(arena_new<BLERxCallbacks>(ARENA_HOT, "ble_rx_cb"));
 
     /* Start service */
     service->start();
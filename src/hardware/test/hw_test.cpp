@@ -5,6 +5,7 @@
 #include "hw_test.h"
 #include "../telemetry/telemetry.h"
 #include "radio/radio_hal.h"
+#include "radio/radio_task.h"
 #include <Arduino.h>
 #include <RadioLib.h>
 #include <string.h>
@@ -16,6 +17,8 @@
 #define RADIO_TEST_PACKET_SIZE 32
 #define RADIO_TEST_DELAY_MS 100
 
+extern bool radio_in_rx_mode;
+
 /**
  * Battery drain test
  * Runs CPU and radio under load to measure power consumption
@@ -150,7 +153,9 @@ int hw_test_solar(struct hw_test_result* result, hw_test_progress_cb progress) {
 
 /**
  * Radio power test
- * Transmits test packets at max power
+ * Transmits test packets at max power. Each packet takes the radio lock
+ * and goes through the duty-cycle check, so the radio task keeps
+ * receiving in between.
  */
 int hw_test_radio(struct hw_test_result* result, hw_test_progress_cb progress) {
     uint8_t test_packet[RADIO_TEST_PACKET_SIZE];
@@ -179,7 +184,10 @@ int hw_test_radio(struct hw_test_result* result, hw_test_progress_cb progress) {
 
     /* Transmit test packets */
     for (int i = 0; i < RADIO_TEST_PACKETS; i++) {
-        int state = get_radio()->transmit(test_packet, RADIO_TEST_PACKET_SIZE);
+        radio_lock();
+        int state = radio_transmit_now(test_packet, RADIO_TEST_PACKET_SIZE, 0);
+        radio_in_rx_mode = (get_radio()->startReceive() == RADIOLIB_ERR_NONE);
+        radio_unlock();
 
         if (state == RADIOLIB_ERR_NONE) {
             result->packets_sent++;
@@ -198,7 +206,9 @@ int hw_test_radio(struct hw_test_result* result, hw_test_progress_cb progress) {
     result->passed = (result->packets_sent == RADIO_TEST_PACKETS);
 
     /* Read RSSI (if we received anything back) */
+    radio_lock();
     result->rssi_dbm = get_radio()->getRSSI();
+    radio_unlock();
 
     if (progress) {
         char status[32];
@@ -12,6 +12,7 @@
  * Optional Features (compile-time):
  *   - BLE:  Bluetooth UART for wireless serial access
  *   - MQTT: Bridge mesh messages to MQTT broker
+ *   - Role: repeater / companion / room server profiles (utils/role.h)
  *
  * ============================================================================
  */
@@ -34,10 +35,13 @@
 /* ===== Utilities ===== */
 #include "utils/constants.h"
 #include "utils/memory.h"
+#include "utils/role.h"
 #include "utils/types.h"
 #include "utils/ui_lib.h"
 #include "utils/serial_output.h"
 #include "utils/debug.h"
+#include "utils/arena.h"
+#include "utils/boot_profile.h"
 #include "version.h"
 
 /* ===== Hardware Abstraction ===== */
@@ -59,15 +63,22 @@ extern "C" {
 /* ===== Radio Subsystem ===== */
 #include "radio/radio_hal.h"
 #include "radio/radio_loop.h"
+#include "radio/radio_lbt.h"
+#include "radio/radio_task.h"
+#include "radio/radio_health.h"
 
 /* ===== Network Protocol ===== */
 extern "C" {
 #include "network/protocol.h"
+#include "network/reachability.h"
+#include "network/mpr.h"
+#include "network/geo.h"
 }
 
 /* ===== Core Functionality ===== */
 #include "core/identity.h"
 #include "core/config.h"
+#include "core/config_store.h"
 #include "core/security.h"
 #include "core/neighbors.h"
 #include "core/channels.h"
@@ -76,6 +87,9 @@ extern "C" {
 #include "core/power.h"
 #include "core/commands.h"
 #include "core/meshcore_bridge.h"
+#include "core/messaging/inbox.h"
+#include "core/messaging/msg_log.h"
+#include "core/node_dir.h"
 
 /* Protocol advertisement handlers */
 #include <advert_auto.h>
@@ -101,7 +115,7 @@ int custom_channel_count = 0;
 /*
  * Configuration - set via serial commands or stored in flash
  */
-enum meshgrid_device_mode device_mode = MODE_CLIENT;
+enum meshgrid_device_mode device_mode = MESHGRID_ROLE_MODE;
 uint32_t advert_interval_ms = (12 * 60 * 60 * 1000); /* 12 hours */
 
 /*
@@ -122,8 +136,10 @@ static SPIClass* radio_spi = nullptr;
 /* Create display as global object BEFORE Wire.begin() - like MeshCore does
  * Use -1 for reset pin to avoid crashes, handle reset manually in display_init()
  * Non-static so it can be accessed by ui/screens.cpp */
+#if MESHGRID_ROLE_UI
 Adafruit_SSD1306 display_128x64(128, 64, &Wire, -1);
 Adafruit_SSD1306* display = nullptr; /* Will point to display_128x64 after board detection */
+#endif
 
 /*
  * Mesh state
@@ -183,25 +199,6 @@ uint32_t stat_rooms = 0;
 
 /* LOG/MONITOR system removed - use DEBUG macros for development debugging */
 
-/*
- * Message inbox buffers (tiered by channel type)
- * Sizes in config/memory.h, struct in lib/types.h
- */
-
-/* Separate buffers for different message types */
-struct message_entry public_messages[PUBLIC_MESSAGE_BUFFER_SIZE];
-int public_msg_index = 0;
-int public_msg_count = 0;
-
-struct message_entry direct_messages[DIRECT_MESSAGE_BUFFER_SIZE];
-int direct_msg_index = 0;
-int direct_msg_count = 0;
-
-/* Per-channel message buffers (50 channels × 5 messages each) */
-struct message_entry channel_messages[MAX_CUSTOM_CHANNELS][CHANNEL_MESSAGE_BUFFER_SIZE];
-int channel_msg_index[MAX_CUSTOM_CHANNELS] = {0};
-int channel_msg_count[MAX_CUSTOM_CHANNELS] = {0};
-
 /*
  * Telemetry
  */
@@ -225,19 +222,24 @@ void led_blink(void) {
 /* ========================================================================= */
 
 static void on_button_short_press(void) {
+#if MESHGRID_ROLE_UI
     /* Short press: next screen or scroll down */
     display_scroll_down(&display_state);
+#endif
     led_blink();
 }
 
 static void on_button_long_press(void) {
     /* Long press: scroll up or send advertisement */
+#if MESHGRID_ROLE_UI
     if (display_state.current_screen == SCREEN_NEIGHBORS || display_state.current_screen == SCREEN_MESSAGES) {
         display_scroll_up(&display_state);
-    } else {
-        /* Send local advertisement on button press */
-        send_advertisement(ROUTE_DIRECT);
+        led_blink();
+        return;
     }
+#endif
+    /* Send local advertisement on button press */
+    send_advertisement(ROUTE_DIRECT);
     led_blink();
 }
 
@@ -258,22 +260,39 @@ static void button_setup(void) {
 volatile bool radio_interrupt_flag = false;
 
 volatile uint32_t isr_trigger_count = 0;
+volatile uint32_t radio_isr_time_us = 0;   /* micros() at the last RX interrupt */
+volatile uint32_t radio_irq_overruns = 0;  /* Interrupts that fired before the previous frame was read */
 bool radio_in_rx_mode = false;
 
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
 void ICACHE_RAM_ATTR radio_isr(void) {
+    if (radio_interrupt_flag) {
+        radio_irq_overruns++;
+    }
+    radio_isr_time_us = micros();
     radio_interrupt_flag = true;
     isr_trigger_count++;
+#ifdef ENABLE_RADIO_TASK
+    radio_task_notify_from_isr();
+#endif
     /* NOTE: Can't use Serial.print in ISR on ESP32 - causes crashes */
 }
 #elif defined(ARCH_NRF52840) || defined(ARCH_RP2040)
 void radio_isr(void) {
+    if (radio_interrupt_flag) {
+        radio_irq_overruns++;
+    }
+    radio_isr_time_us = micros();
     radio_interrupt_flag = true;
     isr_trigger_count++;
     digitalWrite(board->power_pins.led, !digitalRead(board->power_pins.led)); // Toggle LED on interrupt
 }
 #else
 void radio_isr(void) {
+    if (radio_interrupt_flag) {
+        radio_irq_overruns++;
+    }
+    radio_isr_time_us = micros();
     radio_interrupt_flag = true;
     isr_trigger_count++;
 }
@@ -283,7 +302,7 @@ static int radio_init(void) {
     const struct radio_pins* pins = &board->radio_pins;
 
 #if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
-    radio_spi = new SPIClass(HSPI);
+    radio_spi = arena_new<SPIClass>(ARENA_HOT, "radio_spi", HSPI);
     radio_spi->begin(pins->sck, pins->miso, pins->mosi, pins->cs);
 #elif defined(ARCH_NRF52840) || defined(ARCH_RP2040)
     radio_spi = &SPI;
@@ -294,18 +313,8 @@ static int radio_init(void) {
 #endif
 
     /* Build radio config from current settings */
-    struct radio_config hal_config = {
-        .frequency = radio_config.frequency,
-        .bandwidth = radio_config.bandwidth,
-        .spreading_factor = radio_config.spreading_factor,
-        .coding_rate = radio_config.coding_rate,
-        .tx_power = radio_config.tx_power,
-        .preamble_len = radio_config.preamble_len,
-        .use_crc = board->lora_defaults.use_crc,
-        .tcxo_voltage = board->lora_defaults.tcxo_voltage,
-        .dio2_as_rf_switch = board->lora_defaults.dio2_as_rf_switch,
-        .sync_word = board->lora_defaults.sync_word,
-    };
+    struct radio_config hal_config;
+    radio_build_config(&hal_config);
 
     /* Initialize radio via HAL - Module creation handled inside */
     if (radio_hal_init(&radio_inst, pins, radio_spi, &hal_config, board->radio) != 0) {
@@ -328,23 +337,53 @@ static int radio_init(void) {
 
 bool radio_ok = true;
 
+/* Native USB CDC: give an attached host up to BOOT_USB_WAIT_MS to open the
+ * port so the banner is not lost. The radio is already listening, so the
+ * wait keeps it serviced. UART-bridge boards have nothing to wait for */
+static void usb_wait_for_host(void) {
+#if ARDUINO_USB_CDC_ON_BOOT
+    uint32_t start = millis();
+    while (!Serial && millis() - start < BOOT_USB_WAIT_MS) {
+        radio_rx_service();
+        delay(10);
+    }
+#endif
+}
+
+/* Put the radio in RX - first thing after the config it needs is loaded */
+static void radio_start(void) {
+    DEBUG_INFO("Initializing radio...");
+    radio_ok = (radio_init() == 0);
+    if (!radio_ok) {
+        DEBUG_ERROR("Radio init failed");
+        Serial.println("FATAL: Radio init failed");
+        Serial.println("Serial CLI still available for debugging");
+        // DON'T hang - allow serial CLI to work for debugging
+        return;
+    }
+
+    DEBUG_INFO("Radio init OK");
+    /* Listen-before-talk: CAD before every TX, seed backoff per node */
+    lbt_init(radio_scan_channel, micros() ^ ((uint32_t)mesh.our_hash << 24));
+    int rx_state = radio()->startReceive();
+    radio_health_init(millis());
+    DEBUG_INFOF("startReceive() returned: %d (ISR attached, DIO0=%d, DIO1=%d)", rx_state, board->radio_pins.dio0,
+                board->radio_pins.dio1);
+#ifdef ENABLE_RADIO_TASK
+    /* Hand the chip to the radio task from here on */
+    if (radio_task_start() != 0) {
+        Serial.println("FATAL: Radio task start failed");
+    }
+#endif
+}
+
 void setup() {
     Serial.begin(115200);
-    // ESP32-S3 USB CDC takes time to become active
-    // Wait for USB to be ready before sending any output
-    delay(2000);
-
-    Serial.println("\n=================================");
-    Serial.println("  MESHGRID - MeshCore Compatible");
-    Serial.print("  Firmware v"); Serial.println(MESHGRID_VERSION);
-    Serial.print("  Build: "); Serial.println(MESHGRID_BUILD_DATE);
-    Serial.println("=================================\n");
 
+    arena_init();           /* Before anything sized at boot is allocated */
     serial_commands_init(); /* Clear serial buffers */
 
     board = &CURRENT_BOARD_CONFIG;
-    Serial.print("Board: "); Serial.print(board->vendor); Serial.print(" "); Serial.println(board->name);
-
     if (board->early_init) {
         board->early_init();
     }
@@ -352,25 +391,51 @@ void setup() {
     /* Enable VEXT power FIRST for Heltec boards - OLED needs power before I2C init! */
     power_init();
 
-    /* Initialize I2C AFTER power - like MeshCore's board.begin() does */
+    /* Initialize I2C AFTER power - like MeshCore's board.begin() does.
+     * The OLED gets BOOT_I2C_SETTLE_MS before the deferred display step */
     const struct display_pins* dpins = &board->display_pins;
     if (dpins->sda >= 0 && dpins->scl >= 0) {
         DEBUG_INFOF("I2C init: SDA=%d SCL=%d", dpins->sda, dpins->scl);
         Wire.begin(dpins->sda, dpins->scl);
-        delay(100); // Give I2C and OLED power time to stabilize
     }
 
     boot_time = millis();
-    identity_init();
+    boot_mark("hardware");
+
+    /* Only what the radio needs comes before it: identity (LBT seed) and config */
+    config_store_init();   // NVS config image, before anything reads settings
+    identity_init();       // Keypair and node hash
+    init_public_channel(); // Initialize MeshCore public channel
+    tx_queue_init();       // Initialize packet transmission queue
+    inbox_init();          // Message arena, before anything can store
+    config_load();         // Load saved radio config from flash
+    boot_mark("config");
+
+    /* Listen now - frames heard during the rest of boot wait in the RX FIFO */
+    radio_start();
+    boot_mark("radio");
+
+    usb_wait_for_host();
+    Serial.println("\n=================================");
+    Serial.println("  MESHGRID - MeshCore Compatible");
+    Serial.print("  Firmware v"); Serial.println(MESHGRID_VERSION);
+    Serial.print("  Build: "); Serial.println(MESHGRID_BUILD_DATE);
+    Serial.println("=================================\n");
+    Serial.print("Board: "); Serial.print(board->vendor); Serial.print(" "); Serial.println(board->name);
     DEBUG_INFOF("Node: %s (0x%02X)", mesh.name, mesh.our_hash);
-    DEBUG_INFOF("Mode: %s", device_mode == MODE_REPEATER ? "REPEATER" : "CLIENT");
+    DEBUG_INFOF("Mode: %s (role: %s)", device_mode == MODE_REPEATER ? "REPEATER" : "CLIENT", MESHGRID_ROLE_NAME);
 
-    init_public_channel();     // Initialize MeshCore public channel
-    tx_queue_init();           // Initialize packet transmission queue
-    config_load();             // Load saved radio config from flash
     security_init();           // Initialize PIN authentication
-    neighbors_load_from_nvs(); // Restore neighbors with cached secrets
+    node_dir_init();           // Every known node on flash, before neighbors link to it
+    radio_rx_service();        // Flash mounts and scans take a while
+    neighbors_load_from_nvs(); // Restore neighbors, secrets derived after boot
+    reach_init(mesh.our_hash, millis()); // Bloom reachability, seeded with ourselves
+    mpr_init(mesh.our_hash);   // Multipoint relays, flooding until neighbors report
+    geo_init();                // Node positions (ours comes from config_load)
     channels_load_from_nvs();  // Restore custom channels
+    msg_log_init();            // Message log on flash, replayed into the inbox
+    radio_rx_service();
+    boot_mark("storage");
 
     DEBUG_INFO("=== Initializing MeshCore v0 ===");
     meshcore_bridge_initialize(); // Initialize MeshCore v0 integration
@@ -380,58 +445,18 @@ void setup() {
 
     button_setup();
     telemetry_init();
-    DEBUG_INFO("Initializing display...");
-    display_init(&display);
-    if (display) {
-        DEBUG_INFO("Display initialized OK");
-    } else {
-        DEBUG_WARN("Display init failed or not present");
-    }
+#if MESHGRID_ROLE_UI
     display_state_init(&display_state);
-
-    /* Board-specific late initialization (e.g., display contrast) */
-    if (board->late_init)
-        board->late_init();
-
-    if (display) {
-        display->clearDisplay();
-        display->setTextSize(2);
-        display->setCursor(10, 20);
-        display->println("MESHGRID");
-        display->setTextSize(1);
-        display->setCursor(20, 45);
-        display->println(board->name);
-        display->display();
-        delay(1500);
-    }
+#endif
 
     /* Initialize advertisement system (bloom filters for v1) */
     DEBUG_INFO("Initializing advertisement system...");
     advert_auto_init();
 
-    DEBUG_INFO("Initializing radio...");
-    radio_ok = (radio_init() == 0);
-    if (!radio_ok) {
-        DEBUG_ERROR("Radio init failed");
-        Serial.println("FATAL: Radio init failed");
-        Serial.println("Serial CLI still available for debugging");
-        // DON'T hang - allow serial CLI to work for debugging
-    } else {
-        DEBUG_INFO("Radio init OK");
-        int rx_state = radio()->startReceive();
-        DEBUG_INFOF("startReceive() returned: %d (ISR attached, DIO0=%d, DIO1=%d)", rx_state, board->radio_pins.dio0,
-                    board->radio_pins.dio1);
+    if (radio_ok) {
         send_advertisement(ROUTE_DIRECT); /* Initial local advertisement */
     }
-
-#ifdef ENABLE_BLE
-    /* Initialize BLE UART service for wireless serial access */
-    char ble_name[32];
-    snprintf(ble_name, sizeof(ble_name), "meshgrid-%02X", mesh.our_hash);
-    if (ble_serial_init(ble_name) == 0) {
-        DEBUG_INFOF("BLE UART service: %s", ble_name);
-    }
-#endif
+    boot_mark("ready");
 
     Serial.println("\nReady! Type /help for commands.\n");
 #ifdef ENABLE_BLE
@@ -441,10 +466,96 @@ void setup() {
 #endif
 }
 
+/* ========================================================================= */
+/* Deferred boot work                                                        */
+/* ========================================================================= */
+
+/* What setup() leaves for after the node is up - one step per loop pass */
+enum boot_step {
+    BOOT_STEP_DISPLAY, /* Display init and splash */
+    BOOT_STEP_BLE,     /* BLE UART service */
+    BOOT_STEP_SECRETS, /* ECDH for the neighbors restored from NVS */
+    BOOT_STEP_DONE,
+};
+
+static enum boot_step boot_step = BOOT_STEP_DISPLAY;
+static uint32_t splash_until = 0; /* Display updates hold off until then */
+
+/* true if it did work (the radio may want servicing) */
+static bool boot_background(void) {
+    switch (boot_step) {
+        case BOOT_STEP_DISPLAY:
+#if MESHGRID_ROLE_UI
+            if (millis() - boot_time < BOOT_I2C_SETTLE_MS) {
+                return false;
+            }
+            DEBUG_INFO("Initializing display...");
+            display_init(&display);
+            if (display) {
+                DEBUG_INFO("Display initialized OK");
+            } else {
+                DEBUG_WARN("Display init failed or not present");
+            }
+#endif
+            /* Board-specific late initialization (e.g., display contrast) */
+            if (board->late_init)
+                board->late_init();
+#if MESHGRID_ROLE_UI
+            if (display) {
+                display->clearDisplay();
+                display->setTextSize(2);
+                display->setCursor(10, 20);
+                display->println("MESHGRID");
+                display->setTextSize(1);
+                display->setCursor(20, 45);
+                display->println(board->name);
+                display->display();
+                splash_until = millis() + BOOT_SPLASH_MS;
+            }
+            boot_mark("display");
+#endif
+            boot_step = BOOT_STEP_BLE;
+            return true;
+
+        case BOOT_STEP_BLE: {
+#ifdef ENABLE_BLE
+            /* Initialize BLE UART service for wireless serial access */
+            char ble_name[32];
+            snprintf(ble_name, sizeof(ble_name), "meshgrid-%02X", mesh.our_hash);
+            if (ble_serial_init(ble_name) == 0) {
+                DEBUG_INFOF("BLE UART service: %s", ble_name);
+            }
+            boot_mark("ble");
+#endif
+            boot_step = BOOT_STEP_SECRETS;
+            return true;
+        }
+
+        case BOOT_STEP_SECRETS:
+            if (neighbors_derive_step()) {
+                return true;
+            }
+            boot_mark("secrets");
+
+            /* Boot allocations are done - report placement, refuse any later ones */
+            arena_seal();
+            boot_step = BOOT_STEP_DONE;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
 void loop() {
     /* Radio RX handling */
     radio_loop_process();
 
+    /* Boot work deferred until the node is up: display, BLE, neighbor secrets */
+    if (boot_background()) {
+        radio_rx_service();
+    }
+
     /* MeshCore v0 processing */
     meshcore_bridge_loop();
 
@@ -462,6 +573,7 @@ void loop() {
 
     /* Handle serial commands (USB + BLE) */
     handle_serial();
+    radio_rx_service(); /* Commands may have blocked on TX or Serial.flush */
 
 #ifdef ENABLE_BLE
     /* Process BLE events */
@@ -474,6 +586,26 @@ void loop() {
     /* Periodic advertisements */
     advertising_process();
 
+    /* Message log: batched flash writes and segment cleanup, off the RX path */
+    if (msg_log_loop()) {
+        radio_rx_service(); /* A flash write or delete can stall for milliseconds */
+    }
+
+    /* Node directory: queued record writes */
+    if (node_dir_loop()) {
+        radio_rx_service();
+    }
+
+    /* Neighbor snapshot: write-behind, rate-limited NVS commits */
+    if (neighbors_persist_loop()) {
+        radio_rx_service();
+    }
+
+    /* Config store: settled settings and channels to NVS */
+    if (config_store_loop()) {
+        radio_rx_service();
+    }
+
     /* Read telemetry periodically */
     if (millis() - last_telemetry_read > TELEMETRY_READ_INTERVAL_MS) {
         telemetry_read(&telemetry);
@@ -488,12 +620,15 @@ void loop() {
         last_neighbor_prune = millis();
     }
 
+#if MESHGRID_ROLE_UI
     /* Update display every 500ms */
     static uint32_t last_display = 0;
-    if (millis() - last_display > 500) {
+    if (millis() - last_display > 500 && (int32_t)(millis() - splash_until) >= 0) {
         display_update(display, &display_state);
         last_display = millis();
+        radio_rx_service(); /* I2C/SPI display flush can take tens of ms */
     }
+#endif
 
     /* Power management */
     power_check_sleep();
@@ -0,0 +1,255 @@
+/**
+ * Geographic greedy forwarding - node positions from adverts
+ *
+ * Pure C, no Arduino dependencies: time is passed in by the caller.
+ */
+
+#include "geo.h"
+#include "utils/memory.h"
+#include <math.h>
+#include <string.h>
+
+/* Longitude scale cos(lat) in Q16 */
+#define GEO_SCALE_SHIFT 16
+
+struct geo_node {
+    uint8_t hash;
+    bool valid;
+    int32_t lat_e6;
+    int32_t lon_e6;
+    uint32_t lon_scale; /* cos(lat_e6) in Q16, set when the position is stored */
+    uint32_t seen_ms;   /* Last advert with a position */
+    uint32_t direct_ms; /* Last frame transmitted directly by it, 0 = never */
+};
+
+static struct geo_node nodes[GEO_NODES];
+static struct meshgrid_position self;
+static struct geo_stats stats;
+
+static bool node_fresh(const struct geo_node *g, uint32_t now)
+{
+    return g->valid && now - g->seen_ms <= GEO_POSITION_TIMEOUT_MS;
+}
+
+static bool node_direct(const struct geo_node *g, uint32_t now)
+{
+    return node_fresh(g, now) && g->direct_ms != 0 && now - g->direct_ms <= GEO_NEIGHBOR_TIMEOUT_MS;
+}
+
+static struct geo_node *find_node(uint8_t hash, uint32_t now)
+{
+    for (int i = 0; i < GEO_NODES; i++) {
+        if (nodes[i].hash == hash && node_fresh(&nodes[i], now)) {
+            return &nodes[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Squared distance in microdegrees of latitude (equirectangular).
+ * Only ever compared between points around the same destination, so the
+ * longitude scale is the destination's. Both deltas stay within 180e6, so
+ * the sum fits an int64 with room to spare.
+ */
+static int64_t dist2(int32_t lat_a, int32_t lon_a, int32_t lat_b, int32_t lon_b, uint32_t lon_scale)
+{
+    int64_t dlat = (int64_t)lat_a - lat_b;
+    int64_t dlon = (int64_t)lon_a - lon_b;
+
+    /* Shorter way around the antimeridian */
+    if (dlon > 180000000) {
+        dlon -= 360000000;
+    } else if (dlon < -180000000) {
+        dlon += 360000000;
+    }
+    dlon = (dlon * lon_scale) >> GEO_SCALE_SHIFT;
+    return dlat * dlat + dlon * dlon;
+}
+
+/* Integer square root (floor) - distances for geo_progress() */
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+void geo_init(void)
+{
+    memset(nodes, 0, sizeof(nodes));
+    memset(&stats, 0, sizeof(stats));
+}
+
+void geo_set_self(const struct meshgrid_position *pos)
+{
+    if (pos && pos->valid) {
+        self = *pos;
+    } else {
+        memset(&self, 0, sizeof(self));
+    }
+}
+
+const struct meshgrid_position *geo_get_self(void)
+{
+    return &self;
+}
+
+void geo_note(uint8_t hash, const struct meshgrid_position *pos, uint8_t hops, uint32_t now)
+{
+    struct geo_node *slot = NULL;
+
+    if (!pos->valid) {
+        return;
+    }
+
+    for (int i = 0; i < GEO_NODES; i++) {
+        if (nodes[i].valid && nodes[i].hash == hash) {
+            slot = &nodes[i];
+            break;
+        }
+    }
+
+    if (!slot) {
+        /* Free or stale slot, else the position heard least recently */
+        for (int i = 0; i < GEO_NODES; i++) {
+            if (!node_fresh(&nodes[i], now)) {
+                slot = &nodes[i];
+                break;
+            }
+            if (!slot || now - nodes[i].seen_ms > now - slot->seen_ms) {
+                slot = &nodes[i];
+            }
+        }
+        memset(slot, 0, sizeof(*slot));
+        slot->hash = hash;
+        slot->valid = true;
+    }
+
+    if (slot->lat_e6 != pos->lat_e6 || slot->lon_scale == 0) {
+        /* Once per stored position, not per forwarded packet */
+        slot->lon_scale = (uint32_t)(cos(pos->lat_e6 * (M_PI / 180e6)) * (1 << GEO_SCALE_SHIFT) + 0.5);
+    }
+    slot->lat_e6 = pos->lat_e6;
+    slot->lon_e6 = pos->lon_e6;
+    slot->seen_ms = now;
+    if (hops == 0) {
+        slot->direct_ms = now ? now : 1;
+    }
+}
+
+void geo_note_neighbor(uint8_t hash, uint32_t now)
+{
+    struct geo_node *g = find_node(hash, now);
+    if (g) {
+        g->direct_ms = now ? now : 1;
+    }
+}
+
+enum geo_result geo_forward(uint8_t dest, uint8_t upstream, uint32_t now)
+{
+    const struct geo_node *d = find_node(dest, now);
+    const struct geo_node *up = find_node(upstream, now);
+
+    if (!self.valid || !d || !up || dest == upstream) {
+        stats.unknown++;
+        return GEO_UNKNOWN;
+    }
+
+    int64_t theirs = dist2(up->lat_e6, up->lon_e6, d->lat_e6, d->lon_e6, d->lon_scale);
+    int64_t ours = dist2(self.lat_e6, self.lon_e6, d->lat_e6, d->lon_e6, d->lon_scale);
+
+    if (ours < theirs) {
+        stats.closer++;
+        return GEO_CLOSER;
+    }
+
+    /* Some other neighbor of ours makes progress - it (or one like it) carries the flood */
+    for (int i = 0; i < GEO_NODES; i++) {
+        const struct geo_node *g = &nodes[i];
+        if (g == up || !node_direct(g, now)) {
+            continue;
+        }
+        if (dist2(g->lat_e6, g->lon_e6, d->lat_e6, d->lon_e6, d->lon_scale) < theirs) {
+            stats.farther++;
+            return GEO_FARTHER;
+        }
+    }
+
+    stats.perimeter++;
+    return GEO_VOID;
+}
+
+int16_t geo_progress(uint8_t dest, uint8_t upstream, uint32_t now)
+{
+    const struct geo_node *d = find_node(dest, now);
+    const struct geo_node *up = find_node(upstream, now);
+
+    if (!self.valid || !d || !up) {
+        return -1;
+    }
+
+    int64_t gain = (int64_t)isqrt64(dist2(up->lat_e6, up->lon_e6, d->lat_e6, d->lon_e6, d->lon_scale)) -
+                   isqrt64(dist2(self.lat_e6, self.lon_e6, d->lat_e6, d->lon_e6, d->lon_scale));
+
+    /* Our farthest direct neighbor stands in for the radio range */
+    int64_t range = 0;
+    for (int i = 0; i < GEO_NODES; i++) {
+        if (node_direct(&nodes[i], now)) {
+            int64_t r = dist2(nodes[i].lat_e6, nodes[i].lon_e6, self.lat_e6, self.lon_e6, d->lon_scale);
+            if (r > range) {
+                range = r;
+            }
+        }
+    }
+    if (range <= 0) {
+        return -1;
+    }
+    range = isqrt64(range);
+
+    if (gain <= 0) {
+        return 0;
+    }
+    return gain >= range ? 1000 : (int16_t)(gain * 1000 / range);
+}
+
+bool geo_behind(uint8_t dest, uint8_t tx, uint32_t now)
+{
+    const struct geo_node *d = find_node(dest, now);
+    const struct geo_node *t = find_node(tx, now);
+
+    if (!self.valid || !d || !t) {
+        return false;
+    }
+
+    return dist2(t->lat_e6, t->lon_e6, d->lat_e6, d->lon_e6, d->lon_scale) >
+           dist2(self.lat_e6, self.lon_e6, d->lat_e6, d->lon_e6, d->lon_scale);
+}
+
+const struct geo_stats *geo_get_stats(uint32_t now)
+{
+    stats.known = 0;
+    stats.direct = 0;
+    for (int i = 0; i < GEO_NODES; i++) {
+        if (node_fresh(&nodes[i], now)) {
+            stats.known++;
+            if (node_direct(&nodes[i], now)) {
+                stats.direct++;
+            }
+        }
+    }
+    return &stats;
+}
@@ -0,0 +1,81 @@
+/**
+ * Geographic greedy forwarding - node positions from adverts
+ *
+ * Fixed repeaters can carry their position in the MeshCore advert
+ * (ADV_LATLON, degrees x 1e6). Positions are kept per node hash, and a
+ * direct message flooded toward a node with a known position is carried
+ * on by repeaters strictly closer to it than the previous hop.
+ *
+ * A repeater that is not closer steps back: if it knows a direct neighbor
+ * that is, it relays late and only when no copy from a node at least as
+ * close is overheard. Greedy forwarding stalls in a void, where the
+ * previous hop has no neighbor closer to the destination than itself; a
+ * repeater that knows no closer neighbor falls back to flooding (perimeter
+ * fallback). Missing positions - ours, the destination's or the previous
+ * hop's - also mean plain flooding.
+ *
+ * Relays that make more progress go first, and only copies from nodes at
+ * least as close to the destination cancel a pending relay: on a long
+ * chain, copies from behind would otherwise stall the flood.
+ * Pure C - the caller owns the clock.
+ */
+
+#ifndef MESHGRID_GEO_H
+#define MESHGRID_GEO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GEO_POSITION_TIMEOUT_MS (24UL * 60 * 60 * 1000) /* Two flood advert periods */
+#define GEO_NEIGHBOR_TIMEOUT_MS 900000UL                /* Direct neighbor freshness (MESHGRID_NEIGHBOR_TIMEOUT_MS) */
+
+enum geo_result {
+    GEO_UNKNOWN = -1, /* A position is missing - flood */
+    GEO_FARTHER = 0,  /* Not closer than the previous hop, a known neighbor is - defer */
+    GEO_CLOSER = 1,   /* Strictly closer than the previous hop */
+    GEO_VOID = 2,     /* No known neighbor closer than the previous hop - perimeter */
+};
+
+struct geo_stats {
+    uint32_t closer;    /* Relayed: strictly closer to dest */
+    uint32_t farther;   /* Deferred to a closer neighbor */
+    uint32_t perimeter; /* Fell back to flooding around a void */
+    uint32_t unknown;   /* Fell back to flooding for lack of positions */
+    uint16_t known;     /* Nodes with a position */
+    uint16_t direct;    /* ... heard directly */
+};
+
+void geo_init(void);
+
+/* Our own position (fixed install); NULL or !pos->valid clears it */
+void geo_set_self(const struct meshgrid_position *pos);
+const struct meshgrid_position *geo_get_self(void);
+
+/* Position from a node's advert, heard over hops relays */
+void geo_note(uint8_t hash, const struct meshgrid_position *pos, uint8_t hops, uint32_t now);
+
+/* Heard a frame transmitted directly by this node */
+void geo_note_neighbor(uint8_t hash, uint32_t now);
+
+/* Where do we stand for a flood toward dest, heard from neighbor upstream? */
+enum geo_result geo_forward(uint8_t dest, uint8_t upstream, uint32_t now);
+
+/* Our progress toward dest over upstream, in permille of a hop (-1 = unknown) */
+int16_t geo_progress(uint8_t dest, uint8_t upstream, uint32_t now);
+
+/* Is tx strictly farther from dest than we are? (false if unknown) */
+bool geo_behind(uint8_t dest, uint8_t tx, uint32_t now);
+
+const struct geo_stats *geo_get_stats(uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_GEO_H */
@@ -0,0 +1,105 @@
+/**
+ * Per-neighbor link quality estimator
+ *
+ * Pure C, no Arduino dependencies: time is passed in by the caller.
+ */
+
+#include "link_quality.h"
+#include <string.h>
+
+static void update_score(struct link_quality *lq)
+{
+    int32_t snr = lq->snr_x16;
+    int32_t floor = LINK_SNR_FLOOR * 16;
+    int32_t ceil = LINK_SNR_CEIL * 16;
+
+    if (snr < floor) {
+        snr = floor;
+    } else if (snr > ceil) {
+        snr = ceil;
+    }
+
+    /* SNR headroom (0-100) weighted by how many frames actually get through */
+    int32_t snr_pct = (snr - floor) * 100 / (ceil - floor);
+    lq->score = (uint8_t)(snr_pct * lq->pdr / LINK_PDR_SCALE);
+}
+
+/* One delivery opportunity: hit or miss, EWMA with the same alpha */
+static void pdr_sample(struct link_quality *lq, bool delivered)
+{
+    int32_t pdr = lq->pdr;
+
+    /* Round toward the sample so a clean link climbs all the way back */
+    if (delivered) {
+        pdr += (LINK_PDR_SCALE - pdr + (1 << LINK_EWMA_SHIFT) - 1) >> LINK_EWMA_SHIFT;
+    } else {
+        pdr -= (pdr + (1 << LINK_EWMA_SHIFT) - 1) >> LINK_EWMA_SHIFT;
+    }
+    lq->pdr = (uint16_t)pdr;
+}
+
+static void pdr_update(struct link_quality *lq, uint32_t missed)
+{
+    if (missed > LINK_MAX_LOSS_BURST) {
+        missed = LINK_MAX_LOSS_BURST;
+    }
+    lq->lost += missed;
+
+    while (missed--) {
+        pdr_sample(lq, false);
+    }
+    pdr_sample(lq, true);
+    update_score(lq);
+}
+
+void link_quality_init(struct link_quality *lq)
+{
+    memset(lq, 0, sizeof(*lq));
+    lq->pdr = LINK_PDR_SCALE; /* Innocent until frames go missing */
+}
+
+void link_quality_note_rx(struct link_quality *lq, int16_t rssi, int8_t snr)
+{
+    int16_t snr_x16 = (int16_t)(snr * 16);
+    int16_t rssi_x16 = (int16_t)(rssi * 16);
+
+    if (!lq->seeded) {
+        lq->snr_x16 = snr_x16;
+        lq->rssi_x16 = rssi_x16;
+        lq->seeded = true;
+    } else {
+        lq->snr_x16 += (snr_x16 - lq->snr_x16) / (1 << LINK_EWMA_SHIFT);
+        lq->rssi_x16 += (rssi_x16 - lq->rssi_x16) / (1 << LINK_EWMA_SHIFT);
+    }
+
+    lq->frames++;
+    update_score(lq);
+}
+
+void link_quality_note_seq(struct link_quality *lq, uint32_t last_seq, uint32_t seq)
+{
+    /* First sequence from this peer, or a replay - no gap information */
+    if (last_seq == 0 || seq <= last_seq) {
+        return;
+    }
+
+    pdr_update(lq, seq - last_seq - 1);
+}
+
+void link_quality_note_advert(struct link_quality *lq, uint32_t now)
+{
+    if (lq->last_advert_ms == 0) {
+        lq->last_advert_ms = now ? now : 1;
+        return;
+    }
+
+    uint32_t gap = now - lq->last_advert_ms;
+    if (gap < LINK_ADVERT_MIN_GAP_MS) {
+        return;
+    }
+    lq->last_advert_ms = now;
+
+    /* Trickle backs a quiet neighborhood off to the max gap, so any shorter
+     * gap is normal pacing; only whole max gaps without an advert are losses */
+    pdr_update(lq, gap / LINK_ADVERT_MAX_GAP_MS);
+}
@@ -0,0 +1,68 @@
+/**
+ * Per-neighbor link quality estimator
+ *
+ * The last frame's RSSI/SNR is too noisy to decide anything on. Each
+ * neighbor keeps:
+ *   - EWMA SNR and RSSI over every frame it transmitted to us
+ *   - an estimated packet delivery ratio (PDR), from gaps in v1 sequence
+ *     numbers and from adverts overdue by more than the sender's longest
+ *     advert gap (Trickle spaces healthy adverts anywhere up to it)
+ *   - a 0-100 score combining both, refreshed on every update
+ * Pure C - the caller owns the clock.
+ */
+
+#ifndef MESHGRID_LINK_QUALITY_H
+#define MESHGRID_LINK_QUALITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LINK_EWMA_SHIFT 3               /* alpha = 1/8 */
+#define LINK_SNR_FLOOR (-20)            /* dB: score 0 */
+#define LINK_SNR_CEIL 10                /* dB: full SNR score */
+#define LINK_PDR_SCALE 1000             /* PDR in per-mille */
+#define LINK_MAX_LOSS_BURST 16          /* Losses counted per gap (caps restarts) */
+#define LINK_ADVERT_MIN_GAP_MS 60000    /* Closer adverts are relayed copies, not a new period */
+#define LINK_ADVERT_MAX_GAP_MS 660000UL /* Sender's longest advert gap (MESHGRID_LOCAL_ADVERT_MAX_GAP_MS) + 10% */
+
+struct link_quality {
+    int16_t snr_x16;      /* EWMA SNR, dB * 16 */
+    int16_t rssi_x16;     /* EWMA RSSI, dBm * 16 */
+    uint16_t pdr;         /* Estimated delivery ratio, per-mille */
+    uint8_t score;        /* 0-100 */
+    bool seeded;          /* At least one frame measured */
+    uint32_t frames;      /* Frames measured */
+    uint32_t lost;        /* Sequence gaps + missed adverts */
+    uint32_t last_advert_ms;
+};
+
+void link_quality_init(struct link_quality *lq);
+
+/* A frame transmitted by this neighbor was received */
+void link_quality_note_rx(struct link_quality *lq, int16_t rssi, int8_t snr);
+
+/* A v1 sequence number arrived after last_seq (0 = none yet) */
+void link_quality_note_seq(struct link_quality *lq, uint32_t last_seq, uint32_t seq);
+
+/* An advert from this neighbor arrived */
+void link_quality_note_advert(struct link_quality *lq, uint32_t now);
+
+static inline int8_t link_quality_snr(const struct link_quality *lq)
+{
+    return (int8_t)(lq->snr_x16 / 16);
+}
+
+static inline int16_t link_quality_rssi(const struct link_quality *lq)
+{
+    return (int16_t)(lq->rssi_x16 / 16);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_LINK_QUALITY_H */
@@ -0,0 +1,348 @@
+/**
+ * Multipoint relays (OLSR-style) - shrink flood fan-out
+ *
+ * Pure C, no Arduino dependencies: time is passed in by the caller.
+ */
+
+#include "mpr.h"
+#include "utils/memory.h"
+#include <string.h>
+
+struct mpr_peer {
+    uint8_t hash;
+    bool valid;
+    bool has_list;
+    bool lists_us;    /* Symmetric: it hears us too */
+    bool selected_us; /* We are one of its MPRs */
+    bool all_relay;   /* It announced MPR_ALL */
+    bool is_mpr;      /* We selected it */
+    uint8_t list_len;
+    uint8_t list[MPR_LIST_MAX];
+    uint32_t heard_ms; /* Last frame transmitted by this neighbor */
+    uint32_t list_ms;  /* Last announcement received */
+};
+
+static struct mpr_peer peers[MPR_NEIGHBORS];
+static struct mpr_stats stats;
+static uint8_t self_hash;
+static bool flooding = true; /* Announcing MPR_ALL */
+static bool dirty;
+
+/* 256-bit sets of 1-byte hashes */
+static inline void set_add(uint8_t *set, uint8_t h)
+{
+    set[h >> 3] |= (uint8_t)(1u << (h & 7));
+}
+
+static inline bool set_has(const uint8_t *set, uint8_t h)
+{
+    return (set[h >> 3] >> (h & 7)) & 1u;
+}
+
+static bool peer_fresh(const struct mpr_peer *p, uint32_t now)
+{
+    return p->valid && now - p->heard_ms <= MPR_PEER_TIMEOUT_MS;
+}
+
+static bool list_fresh(const struct mpr_peer *p, uint32_t now)
+{
+    return p->has_list && now - p->list_ms <= MPR_PEER_TIMEOUT_MS;
+}
+
+static bool symmetric(const struct mpr_peer *p, uint32_t now)
+{
+    return peer_fresh(p, now) && list_fresh(p, now) && p->lists_us;
+}
+
+static struct mpr_peer *find_peer(uint8_t hash)
+{
+    for (int i = 0; i < MPR_NEIGHBORS; i++) {
+        if (peers[i].valid && peers[i].hash == hash) {
+            return &peers[i];
+        }
+    }
+    return NULL;
+}
+
+static struct mpr_peer *peer_slot(uint8_t hash, uint32_t now)
+{
+    struct mpr_peer *slot = find_peer(hash);
+    if (slot) {
+        return slot;
+    }
+
+    /* Free or stale slot, else the neighbor heard least recently */
+    for (int i = 0; i < MPR_NEIGHBORS; i++) {
+        if (!peer_fresh(&peers[i], now)) {
+            slot = &peers[i];
+            break;
+        }
+        if (!slot || now - peers[i].heard_ms > now - slot->heard_ms) {
+            slot = &peers[i];
+        }
+    }
+
+    memset(slot, 0, sizeof(*slot));
+    slot->hash = hash;
+    slot->valid = true;
+    dirty = true;
+    return slot;
+}
+
+static bool list_has(const uint8_t *list, uint8_t len, uint8_t h)
+{
+    for (uint8_t i = 0; i < len; i++) {
+        if (list[i] == h) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void select_peer(struct mpr_peer *p, uint8_t *covered)
+{
+    p->is_mpr = true;
+    for (uint8_t j = 0; j < p->list_len; j++) {
+        set_add(covered, p->list[j]);
+    }
+}
+
+/* Greedy MPR selection; returns false when the data is too thin to select */
+static bool select_relays(uint32_t now)
+{
+    uint8_t one_hop[32] = {0};
+    uint8_t two_hop[32] = {0};
+    uint8_t covered[32] = {0};
+    uint8_t cover_count[256];
+    int last_cover[256];
+    bool any_symmetric = false;
+
+    for (int i = 0; i < MPR_NEIGHBORS; i++) {
+        peers[i].is_mpr = false;
+        if (!peer_fresh(&peers[i], now)) {
+            continue;
+        }
+        /* A neighbor we know nothing about could be the only way somewhere */
+        if (!list_fresh(&peers[i], now)) {
+            return false;
+        }
+        set_add(one_hop, peers[i].hash);
+        any_symmetric |= peers[i].lists_us;
+    }
+    if (!any_symmetric) {
+        return false;
+    }
+
+    /* 2-hop neighborhood: what symmetric neighbors hear that we don't */
+    memset(cover_count, 0, sizeof(cover_count));
+    stats.two_hop = 0;
+    for (int i = 0; i < MPR_NEIGHBORS; i++) {
+        if (!symmetric(&peers[i], now)) {
+            continue;
+        }
+        for (uint8_t j = 0; j < peers[i].list_len; j++) {
+            uint8_t h = peers[i].list[j];
+            if (h == self_hash || set_has(one_hop, h)) {
+                continue;
+            }
+            if (!set_has(two_hop, h)) {
+                set_add(two_hop, h);
+                stats.two_hop++;
+            }
+            cover_count[h]++;
+            last_cover[h] = i;
+        }
+    }
+
+    /* Sole providers first: nobody else reaches those 2-hop nodes */
+    for (int h = 0; h < 256; h++) {
+        if (set_has(two_hop, (uint8_t)h) && cover_count[h] == 1 && !peers[last_cover[h]].is_mpr) {
+            select_peer(&peers[last_cover[h]], covered);
+        }
+    }
+
+    /* Then the neighbor covering the most still-uncovered nodes, until done */
+    for (;;) {
+        int best = -1;
+        int best_gain = 0;
+
+        for (int i = 0; i < MPR_NEIGHBORS; i++) {
+            if (peers[i].is_mpr || !symmetric(&peers[i], now)) {
+                continue;
+            }
+            int gain = 0;
+            for (uint8_t j = 0; j < peers[i].list_len; j++) {
+                uint8_t h = peers[i].list[j];
+                if (set_has(two_hop, h) && !set_has(covered, h)) {
+                    gain++;
+                }
+            }
+            if (gain > best_gain) {
+                best = i;
+                best_gain = gain;
+            }
+        }
+        if (best < 0) {
+            break; /* Everything covered */
+        }
+        select_peer(&peers[best], covered);
+    }
+    return true;
+}
+
+void mpr_init(uint8_t our_hash)
+{
+    memset(peers, 0, sizeof(peers));
+    memset(&stats, 0, sizeof(stats));
+    self_hash = our_hash;
+    flooding = true;
+    dirty = false;
+}
+
+void mpr_note_neighbor(uint8_t hash, uint32_t now)
+{
+    if (hash == self_hash) {
+        return;
+    }
+    struct mpr_peer *p = peer_slot(hash, now);
+    p->heard_ms = now ? now : 1;
+}
+
+void mpr_merge(uint8_t from, const uint8_t *tail, uint16_t len, uint32_t now)
+{
+    if (from == self_hash || len < 2) {
+        return;
+    }
+
+    uint8_t n = tail[0];
+    if (n > MPR_LIST_MAX || len < 2 + n) {
+        return;
+    }
+    uint8_t m = tail[1 + n];
+    const uint8_t *mprs = &tail[2 + n];
+    if (m != MPR_ALL && (m > MPR_LIST_MAX || len < 2 + n + m)) {
+        return;
+    }
+
+    mpr_note_neighbor(from, now);
+    struct mpr_peer *p = peer_slot(from, now);
+
+    bool lists_us = list_has(&tail[1], n, self_hash);
+    if (!p->has_list || p->list_len != n || memcmp(p->list, &tail[1], n) != 0 || p->lists_us != lists_us) {
+        dirty = true;
+    }
+    memcpy(p->list, &tail[1], n);
+    p->list_len = n;
+    p->lists_us = lists_us;
+    p->all_relay = m == MPR_ALL;
+    p->selected_us = !p->all_relay && list_has(mprs, m, self_hash);
+    p->has_list = true;
+    p->list_ms = now;
+}
+
+bool mpr_tick(uint32_t now)
+{
+    /* Neighbors or announcements aging out change the neighborhood too */
+    for (int i = 0; i < MPR_NEIGHBORS; i++) {
+        struct mpr_peer *p = &peers[i];
+        if (p->valid && !peer_fresh(p, now)) {
+            p->valid = false;
+            dirty = true;
+        } else if (p->has_list && !list_fresh(p, now)) {
+            p->has_list = false;
+            dirty = true;
+        }
+    }
+    if (!dirty) {
+        return false;
+    }
+    dirty = false;
+
+    bool was_mpr[MPR_NEIGHBORS];
+    for (int i = 0; i < MPR_NEIGHBORS; i++) {
+        was_mpr[i] = peers[i].is_mpr;
+    }
+    bool was_flooding = flooding;
+
+    flooding = !select_relays(now);
+    if (flooding) {
+        for (int i = 0; i < MPR_NEIGHBORS; i++) {
+            peers[i].is_mpr = false;
+        }
+    }
+
+    bool changed = flooding != was_flooding;
+    for (int i = 0; i < MPR_NEIGHBORS && !changed; i++) {
+        changed = peers[i].is_mpr != was_mpr[i];
+    }
+    if (changed) {
+        stats.selections++;
+    }
+    return changed;
+}
+
+int mpr_encode(uint8_t *buf, uint32_t now)
+{
+    uint8_t n = 0;
+    uint8_t m = 0;
+
+    for (int i = 0; i < MPR_NEIGHBORS && n < MPR_LIST_MAX; i++) {
+        if (peer_fresh(&peers[i], now)) {
+            buf[1 + n++] = peers[i].hash;
+        }
+    }
+    buf[0] = n;
+
+    uint8_t *mprs = &buf[2 + n];
+    for (int i = 0; i < MPR_NEIGHBORS && !flooding; i++) {
+        if (peers[i].is_mpr && peer_fresh(&peers[i], now)) {
+            mprs[m++] = peers[i].hash;
+        }
+    }
+    buf[1 + n] = flooding ? MPR_ALL : m;
+    return 2 + n + (flooding ? 0 : m);
+}
+
+bool mpr_should_relay(uint8_t upstream, uint32_t now)
+{
+    struct mpr_peer *p = find_peer(upstream);
+
+    if (!p || !peer_fresh(p, now) || !list_fresh(p, now) || p->all_relay) {
+        stats.fallbacks++;
+        return true;
+    }
+    if (p->selected_us) {
+        stats.relayed++;
+        return true;
+    }
+    stats.skipped++;
+    return false;
+}
+
+const struct mpr_stats *mpr_get_stats(uint32_t now)
+{
+    stats.neighbors = 0;
+    stats.symmetric = 0;
+    stats.selected = 0;
+    stats.selectors = 0;
+    for (int i = 0; i < MPR_NEIGHBORS; i++) {
+        const struct mpr_peer *p = &peers[i];
+        if (!peer_fresh(p, now)) {
+            continue;
+        }
+        stats.neighbors++;
+        if (symmetric(p, now)) {
+            stats.symmetric++;
+        }
+        if (p->is_mpr) {
+            stats.selected++;
+        }
+        if (list_fresh(p, now) && p->selected_us) {
+            stats.selectors++;
+        }
+    }
+    if (flooding) {
+        stats.selected = MPR_ALL;
+    }
+    return &stats;
+}
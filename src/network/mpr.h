@@ -0,0 +1,73 @@
+/**
+ * Multipoint relays (OLSR-style) - shrink flood fan-out
+ *
+ * Every repeater relaying every flood makes airtime grow with node
+ * count. Instead each node picks a small set of its direct neighbors,
+ * its multipoint relays (MPRs), that together reach its whole 2-hop
+ * neighborhood, and announces the set. A flood is relayed only by the
+ * MPRs of the neighbor it was heard from.
+ *
+ * Neighbor lists and MPR sets ride in the v1 neighborhood advert, after
+ * the reachability filter:
+ *   [n][n neighbor hashes][m][m MPR hashes]    (m = MPR_ALL: everyone relays)
+ * A neighbor is symmetric (usable as a relay) once its list contains us.
+ *
+ * Stale data falls back to plain flooding on both ends: a node that
+ * lacks a fresh list from any of its neighbors announces MPR_ALL, and a
+ * receiver relays floods from a neighbor whose announcement is missing
+ * or stale. Pure C - the caller owns the clock.
+ */
+
+#ifndef MESHGRID_MPR_H
+#define MESHGRID_MPR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MPR_ALL 0xFF                 /* MPR count meaning "all neighbors relay" */
+#define MPR_LIST_MAX 16              /* Neighbor hashes carried per advert */
+#define MPR_PEER_TIMEOUT_MS 900000UL /* Neighbor / announcement freshness (MESHGRID_NEIGHBOR_TIMEOUT_MS) */
+
+/* Longest advert tail: both lists full */
+#define MPR_ADVERT_MAX (2 + 2 * MPR_LIST_MAX)
+
+struct mpr_stats {
+    uint32_t selections;  /* Times our MPR set changed */
+    uint32_t relayed;     /* Floods relayed as an MPR of the sender */
+    uint32_t skipped;     /* Floods left to the sender's MPRs */
+    uint32_t fallbacks;   /* Floods relayed for lack of fresh data */
+    uint8_t neighbors;    /* Direct neighbors heard */
+    uint8_t symmetric;    /* ... that list us back */
+    uint8_t two_hop;      /* 2-hop neighborhood size */
+    uint8_t selected;     /* Our MPRs (MPR_ALL while flooding) */
+    uint8_t selectors;    /* Neighbors that picked us */
+};
+
+void mpr_init(uint8_t our_hash);
+
+/* Heard a frame transmitted directly by this node */
+void mpr_note_neighbor(uint8_t hash, uint32_t now);
+
+/* Neighbor list / MPR tail of a neighborhood advert from a direct neighbor */
+void mpr_merge(uint8_t from, const uint8_t *tail, uint16_t len, uint32_t now);
+
+/* Re-select if the neighborhood changed; true when our MPR set changed */
+bool mpr_tick(uint32_t now);
+
+/* Advert tail for our neighborhood; returns bytes written (<= MPR_ADVERT_MAX) */
+int mpr_encode(uint8_t *buf, uint32_t now);
+
+/* Should we relay a flood heard from upstream? */
+bool mpr_should_relay(uint8_t upstream, uint32_t now);
+
+const struct mpr_stats *mpr_get_stats(uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_MPR_H */
@@ -0,0 +1,38 @@
+/**
+ * Received frame parsed in place
+ *
+ * meshgrid_view_parse() fills in the header fields and points path and
+ * payload into the receive buffer (the RX FIFO slot), so one parse serves
+ * dedup, the v1 and v0 handlers and the forwarder without copying the
+ * frame. A view is valid only while that buffer is - process_packet()
+ * returns before the slot is released. MeshCore's Dispatcher keeps its
+ * own pooled copy, as it handles frames after we return.
+ *
+ * Kept apart from protocol.h so the v1 bridge, which sees the v1
+ * library's packet definitions instead, can take a view too.
+ */
+
+#ifndef MESHGRID_PACKET_VIEW_H
+#define MESHGRID_PACKET_VIEW_H
+
+#include <stdint.h>
+
+struct meshgrid_packet_view {
+    uint8_t header;
+    uint8_t route_type;
+    uint8_t payload_type;
+    uint8_t version;
+    uint16_t transport_codes[2];
+
+    const uint8_t *path; /* path_len bytes in the frame (none for pathless frames) */
+    uint8_t path_len;
+    const uint8_t *payload;
+    uint16_t payload_len;
+
+    /* RX metadata */
+    int16_t rssi;
+    int8_t snr;
+    uint32_t rx_time;
+};
+
+#endif /* MESHGRID_PACKET_VIEW_H */
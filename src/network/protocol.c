@@ -3,6 +3,9 @@
  */
 
 #include "protocol.h"
+#include "reachability.h"
+#include "mpr.h"
+#include "geo.h"
 #include <string.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -20,7 +23,7 @@ uint8_t meshgrid_hash_pubkey(const uint8_t *pubkey)
  * Simple CRC-like hash for packet deduplication
  * Uses payload type + payload content
  */
-void meshgrid_packet_hash(const struct meshgrid_packet *pkt, uint8_t *hash)
+void meshgrid_packet_hash(const struct meshgrid_packet_view *pkt, uint8_t *hash)
 {
     /* Simple hash: XOR of payload type and payload bytes */
     uint8_t h = pkt->payload_type;
@@ -40,6 +43,8 @@ void meshgrid_packet_hash(const struct meshgrid_packet *pkt, uint8_t *hash)
  *   [N]     path_len
  *   [N+1..] path (path_len bytes)
  *   [...]   payload (remaining bytes)
+ *
+ * Pathless frames (MESHGRID_IS_PATHLESS) are [header][payload].
  */
 int meshgrid_packet_encode(const struct meshgrid_packet *pkt, uint8_t *buf, size_t buf_len)
 {
@@ -57,14 +62,16 @@ int meshgrid_packet_encode(const struct meshgrid_packet *pkt, uint8_t *buf, size
         buf[i++] = (pkt->transport_codes[1] >> 8) & 0xFF;
     }
 
-    /* Path length */
-    if (i + 1 > buf_len) return -2;
-    buf[i++] = pkt->path_len;
+    if (!MESHGRID_IS_PATHLESS(pkt->header)) {
+        /* Path length */
+        if (i + 1 > buf_len) return -2;
+        buf[i++] = pkt->path_len;
 
-    /* Path */
-    if (i + pkt->path_len > buf_len) return -3;
-    memcpy(&buf[i], pkt->path, pkt->path_len);
-    i += pkt->path_len;
+        /* Path */
+        if (i + pkt->path_len > buf_len) return -3;
+        memcpy(&buf[i], pkt->path, pkt->path_len);
+        i += pkt->path_len;
+    }
 
     /* Payload */
     if (i + pkt->payload_len > buf_len) return -6;
@@ -75,9 +82,10 @@ int meshgrid_packet_encode(const struct meshgrid_packet *pkt, uint8_t *buf, size
 }
 
 /*
- * Parse packet from wire format (MeshCore compatible)
+ * Parse a received frame in place (MeshCore compatible)
+ * Nothing is copied: path and payload point into buf.
  */
-int meshgrid_packet_parse(const uint8_t *buf, size_t len, struct meshgrid_packet *pkt)
+int meshgrid_view_parse(const uint8_t *buf, size_t len, struct meshgrid_packet_view *pkt)
 {
     if (len < 2) return -1;  /* Minimum: header + path_len */
 
@@ -101,18 +109,24 @@ int meshgrid_packet_parse(const uint8_t *buf, size_t len, struct meshgrid_packet
         pkt->transport_codes[1] = 0;
     }
 
-    /* Path length */
-    if (i >= len) return -1;
-    pkt->path_len = buf[i++];
-    if (pkt->path_len > MESHGRID_MAX_PATH_SIZE) return -1;
-
-    /* Path */
-    if (i + pkt->path_len > len) return -1;
-    memcpy(pkt->path, &buf[i], pkt->path_len);
-    i += pkt->path_len;
+    if (MESHGRID_IS_PATHLESS(pkt->header)) {
+        /* The nonce is not a path length - a relay must not touch it */
+        pkt->path_len = 0;
+    } else {
+        /* Path length */
+        if (i >= len) return -1;
+        pkt->path_len = buf[i++];
+        if (pkt->path_len > MESHGRID_MAX_PATH_SIZE) return -1;
+
+        /* Path */
+        if (i + pkt->path_len > len) return -1;
+        i += pkt->path_len;
+    }
+    pkt->path = &buf[i - pkt->path_len];
 
     /* Payload (remaining bytes) */
     if (i > len) return -1;
+    pkt->payload = &buf[i];
     pkt->payload_len = len - i;
     if (pkt->payload_len > MESHGRID_MAX_PAYLOAD_SIZE) return -1;
 
@@ -123,42 +137,309 @@ int meshgrid_packet_parse(const uint8_t *buf, size_t len, struct meshgrid_packet
         pkt->payload_len = 106;
     }
 
-    memcpy(pkt->payload, &buf[i], pkt->payload_len);
+    pkt->rssi = 0;
+    pkt->snr = 0;
+    pkt->rx_time = 0;
+    return 0;
+}
+
+/*
+ * Parse packet from wire format into its own storage
+ */
+int meshgrid_packet_parse(const uint8_t *buf, size_t len, struct meshgrid_packet *pkt)
+{
+    struct meshgrid_packet_view view;
+
+    if (meshgrid_view_parse(buf, len, &view) != 0) {
+        return -1;
+    }
+
+    pkt->header = view.header;
+    pkt->route_type = view.route_type;
+    pkt->payload_type = view.payload_type;
+    pkt->version = view.version;
+    pkt->transport_codes[0] = view.transport_codes[0];
+    pkt->transport_codes[1] = view.transport_codes[1];
+    pkt->path_len = view.path_len;
+    memcpy(pkt->path, view.path, view.path_len);
+    pkt->payload_len = view.payload_len;
+    memcpy(pkt->payload, view.payload, view.payload_len);
 
     return 0;
 }
 
+/*
+ * Re-encode a received frame with a new path (what a relay transmits)
+ * Header, transport codes and payload are the frame's own.
+ */
+int meshgrid_view_encode(const struct meshgrid_packet_view *pkt, const uint8_t *path, uint8_t path_len,
+                         uint8_t *buf, size_t buf_len)
+{
+    size_t i = 0;
+
+    buf[i++] = pkt->header;
+
+    if (MESHGRID_HAS_TRANSPORT(pkt->route_type)) {
+        if (i + 4 > buf_len) return -1;
+        buf[i++] = pkt->transport_codes[0] & 0xFF;
+        buf[i++] = (pkt->transport_codes[0] >> 8) & 0xFF;
+        buf[i++] = pkt->transport_codes[1] & 0xFF;
+        buf[i++] = (pkt->transport_codes[1] >> 8) & 0xFF;
+    }
+
+    if (!MESHGRID_IS_PATHLESS(pkt->header)) {
+        if (path_len > MESHGRID_MAX_PATH_SIZE || i + 1 + path_len > buf_len) return -3;
+        buf[i++] = path_len;
+        memcpy(&buf[i], path, path_len);
+        i += path_len;
+    }
+
+    if (i + pkt->payload_len > buf_len) return -6;
+    memcpy(&buf[i], pkt->payload, pkt->payload_len);
+    i += pkt->payload_len;
+
+    return (int)i;
+}
+
+static enum meshgrid_forward_policy forward_policy = FWD_POLICY_FLOOD;
+
+/* MeshCore payloads addressed to one node: [dest_hash][src_hash]... */
+static bool is_addressed(const struct meshgrid_packet_view *pkt)
+{
+    if (pkt->version != PAYLOAD_VER_MESHCORE || pkt->payload_len < 2) {
+        return false;
+    }
+
+    switch (pkt->payload_type) {
+        case PAYLOAD_REQ:
+        case PAYLOAD_RESPONSE:
+        case PAYLOAD_TXT_MSG:
+        case PAYLOAD_PATH:
+            return true;
+        default:
+            return false;
+    }
+}
+
 /*
  * Should we forward this packet?
  *
- * Returns true if:
+ * Relays (FWD_RELAY) if:
  * - Device mode is REPEATER (CLIENT does not forward)
  * - Packet is flood routed
  * - We're not already in the path
  * - Packet hasn't been seen recently (caller should check seen table)
  *
  * MeshCore compatible: CLIENT nodes don't forward, only REPEATER do
+ *
+ * Under a directed flooding policy, an addressed flood that no neighbor's
+ * Bloom filter draws past us (see reach_downstream()) is deferred
+ * (FWD_POLICY_BLOOM) or dropped (FWD_POLICY_STRICT).
+ *
+ * Under FWD_POLICY_MPR every flood is relayed only if the neighbor we
+ * heard it from selected us as one of its multipoint relays, or if its
+ * neighborhood data is missing or stale (see mpr_should_relay()).
+ *
+ * Under FWD_POLICY_GEO an addressed flood toward a node with a known
+ * position is relayed by repeaters strictly closer to it than the previous
+ * hop. One that is not, but knows a neighbor that is, relays late and only
+ * if none of them is overheard; one that knows no such neighbor floods
+ * around the void (see geo_forward()).
  */
-bool meshgrid_should_forward(const struct meshgrid_packet *pkt, uint8_t our_hash, enum meshgrid_device_mode mode)
+enum meshgrid_fwd_verdict meshgrid_should_forward(const struct meshgrid_packet_view *pkt, uint8_t our_hash,
+                                                  enum meshgrid_device_mode mode)
 {
     /* Only REPEATER mode forwards packets (CLIENT does not) */
     if (mode == MODE_CLIENT) {
-        return false;
+        return FWD_DROP;
     }
 
     /* Only flood packets should be forwarded */
     if (!MESHGRID_IS_FLOOD(pkt->route_type)) {
-        return false;
+        return FWD_DROP;
     }
 
     /* Don't forward if we're already in the path */
     for (uint8_t i = 0; i < pkt->path_len; i++) {
         if (pkt->path[i] == our_hash) {
-            return false;
+            return FWD_DROP;
         }
     }
 
-    return true;
+    int upstream = meshgrid_transmitter_hash(pkt);
+
+    /* MPR flooding: the previous hop's selected relays cover its 2-hop neighborhood */
+    if (forward_policy == FWD_POLICY_MPR) {
+        if (upstream < 0 || mpr_should_relay((uint8_t)upstream, pkt->rx_time)) {
+            return FWD_RELAY;
+        }
+        return FWD_DROP;
+    }
+
+    if (forward_policy == FWD_POLICY_FLOOD || !is_addressed(pkt)) {
+        return FWD_RELAY;
+    }
+
+    /* Greedy geographic: only progress toward dest's advertised position */
+    if (forward_policy == FWD_POLICY_GEO) {
+        if (upstream < 0) {
+            return FWD_RELAY;
+        }
+        switch (geo_forward(pkt->payload[0], (uint8_t)upstream, pkt->rx_time)) {
+            case GEO_FARTHER:
+                return FWD_RELAY_LATE; /* Only if no relay closer to dest is overheard */
+            default:
+                return FWD_RELAY; /* Closer, or a void to flood around */
+        }
+    }
+
+    /* Directed flooding: does any neighbor past the one we heard it from lead to dest? */
+    if (upstream < 0 ||
+        reach_downstream(pkt->payload[0], (uint8_t)upstream, pkt->rx_time) != REACH_NO) {
+        return FWD_RELAY;
+    }
+
+    /* Filters can be wrong - by default only step back and let others relay first */
+    return forward_policy == FWD_POLICY_STRICT ? FWD_DROP : FWD_RELAY_LATE;
+}
+
+void meshgrid_set_forward_policy(enum meshgrid_forward_policy policy)
+{
+    forward_policy = policy <= FWD_POLICY_GEO ? policy : FWD_POLICY_FLOOD;
+}
+
+enum meshgrid_forward_policy meshgrid_get_forward_policy(void)
+{
+    return forward_policy;
+}
+
+const char *meshgrid_forward_policy_name(enum meshgrid_forward_policy policy)
+{
+    switch (policy) {
+        case FWD_POLICY_BLOOM:
+            return "BLOOM";
+        case FWD_POLICY_STRICT:
+            return "STRICT";
+        case FWD_POLICY_MPR:
+            return "MPR";
+        case FWD_POLICY_GEO:
+            return "GEO";
+        default:
+            return "FLOOD";
+    }
+}
+
+int meshgrid_forward_policy_parse(const char *name)
+{
+    if (strcmp(name, "FLOOD") == 0) {
+        return FWD_POLICY_FLOOD;
+    }
+    if (strcmp(name, "BLOOM") == 0) {
+        return FWD_POLICY_BLOOM;
+    }
+    if (strcmp(name, "STRICT") == 0) {
+        return FWD_POLICY_STRICT;
+    }
+    if (strcmp(name, "MPR") == 0) {
+        return FWD_POLICY_MPR;
+    }
+    if (strcmp(name, "GEO") == 0) {
+        return FWD_POLICY_GEO;
+    }
+    return -1;
+}
+
+/*
+ * Should we relay this direct packet?
+ *
+ * A direct packet carries the remaining hops; the next relay is path[0].
+ * TRACE packets use the path for SNRs and are handled separately.
+ */
+bool meshgrid_should_forward_direct(const struct meshgrid_packet_view *pkt, uint8_t our_hash,
+                                    enum meshgrid_device_mode mode)
+{
+    if (mode == MODE_CLIENT) {
+        return false;
+    }
+
+    if (!MESHGRID_IS_DIRECT(pkt->route_type) || pkt->payload_type == PAYLOAD_TRACE) {
+        return false;
+    }
+
+    return pkt->path_len > 0 && pkt->path[0] == our_hash;
+}
+
+/*
+ * Early receive classification
+ *
+ * Decides from the header, path and the clear dest / channel byte alone
+ * whether a frame needs the full receive path (MeshCore, v1 decryption,
+ * host output) or only the forwarder, so a repeater's relay traffic
+ * skips everything else. Anything that cannot be told apart without
+ * decrypting is consumed:
+ * - v1 messages carry dest and channel inside the ciphertext
+ * - PATH floods include trace responses, whose first byte is a trace id
+ * - a dest byte matching ours may be another node's (1-byte hashes), so
+ *   addressed floods for us are still relayed, as before
+ * TRACE is consumed: its handler relays it if we are on its list.
+ */
+static enum meshgrid_rx_class rx_class(bool consume, bool relay)
+{
+    if (consume) {
+        return relay ? RX_CONSUME_AND_FORWARD : RX_CONSUME;
+    }
+    return relay ? RX_FORWARD_ONLY : RX_DROP;
+}
+
+enum meshgrid_rx_class meshgrid_classify(const struct meshgrid_packet_view *pkt, uint8_t our_hash,
+                                         enum meshgrid_device_mode mode, bool (*have_channel)(uint8_t hash))
+{
+    bool repeater = mode != MODE_CLIENT;
+
+    if (pkt->version != PAYLOAD_VER_MESHCORE && pkt->version != PAYLOAD_VER_MESHGRID) {
+        return RX_DROP; /* Reserved versions - MeshCore drops them too */
+    }
+
+    if (pkt->payload_type == PAYLOAD_TRACE) {
+        return RX_CONSUME;
+    }
+
+    /* Routed hops: only the next one may relay, nobody else looks inside */
+    if (MESHGRID_IS_DIRECT(pkt->route_type) && pkt->path_len > 0) {
+        return rx_class(false, repeater && pkt->path[0] == our_hash);
+    }
+
+    /* v1 keeps sender and dest inside the ciphertext - only decrypting tells;
+     * its neighborhood adverts and pathless messages (no hop limit) are never relayed */
+    if (pkt->version == PAYLOAD_VER_MESHGRID) {
+        return rx_class(true, repeater && MESHGRID_IS_FLOOD(pkt->route_type) && pkt->payload_type != PAYLOAD_ADVERT &&
+                                  !MESHGRID_IS_PATHLESS(pkt->header));
+    }
+
+    /* Last hop of a routed packet delivers */
+    if (MESHGRID_IS_DIRECT(pkt->route_type)) {
+        return rx_class(!is_addressed(pkt) || pkt->payload[0] == our_hash, false);
+    }
+
+    switch (pkt->payload_type) {
+        case PAYLOAD_ADVERT:
+        case PAYLOAD_PATH:
+            return rx_class(true, repeater);
+        case PAYLOAD_ACK:
+            return RX_CONSUME; /* Flood ACKs end here */
+        case PAYLOAD_TXT_MSG:
+        case PAYLOAD_REQ:
+        case PAYLOAD_RESPONSE:
+        case PAYLOAD_ANON_REQ:
+            /* [dest_hash]... */
+            return rx_class(pkt->payload_len >= 1 && pkt->payload[0] == our_hash, repeater);
+        case PAYLOAD_GRP_TXT:
+        case PAYLOAD_GRP_DATA:
+            /* [channel_hash]... */
+            return rx_class(pkt->payload_len >= 1 && have_channel(pkt->payload[0]), repeater);
+        default:
+            return rx_class(false, repeater);
+    }
 }
 
 /*
@@ -167,21 +448,36 @@ bool meshgrid_should_forward(const struct meshgrid_packet *pkt, uint8_t our_hash
  * Longer paths get priority (shorter delay) to let packets travel further
  * before being re-broadcast. This reduces collisions.
  *
+ * Receivers that heard the packet weakly are likely near the edge of the
+ * sender's range and extend coverage the most, so they go first; strong
+ * receivers wait up to SNR_SPAN_MS longer and are the ones most likely to
+ * be suppressed by overheard copies.
+ *
  * Based on MeshCore's algorithm:
- *   base_delay * (1.0 + path_len * 0.1) + random_jitter
+ *   base_delay * (1.0 + path_len * 0.1) + snr_delay + random_jitter
  */
-uint32_t meshgrid_retransmit_delay(const struct meshgrid_packet *pkt, uint32_t random_byte)
+uint32_t meshgrid_retransmit_delay(uint8_t path_len, int8_t rx_snr, uint32_t random_byte)
 {
     uint32_t base = MESHGRID_RETRANSMIT_BASE_MS;
 
     /* Increase delay based on path length (longer path = higher priority = shorter delay) */
     /* Invert: shorter path = longer delay to let long-distance packets through first */
-    uint32_t path_factor = (MESHGRID_MAX_PATH_SIZE - pkt->path_len) * 10;
+    uint32_t path_factor = (MESHGRID_MAX_PATH_SIZE - path_len) * 10;
+
+    /* SNR: linear from 0 at SNR_MIN to SNR_SPAN_MS at SNR_MAX */
+    int32_t snr = rx_snr;
+    if (snr < MESHGRID_RETRANSMIT_SNR_MIN) {
+        snr = MESHGRID_RETRANSMIT_SNR_MIN;
+    } else if (snr > MESHGRID_RETRANSMIT_SNR_MAX) {
+        snr = MESHGRID_RETRANSMIT_SNR_MAX;
+    }
+    uint32_t snr_factor = (uint32_t)(snr - MESHGRID_RETRANSMIT_SNR_MIN) * MESHGRID_RETRANSMIT_SNR_SPAN_MS /
+                          (MESHGRID_RETRANSMIT_SNR_MAX - MESHGRID_RETRANSMIT_SNR_MIN);
 
     /* Add randomness to avoid synchronized transmissions */
     uint32_t jitter = (random_byte * MESHGRID_RETRANSMIT_BASE_MS) / 256;
 
-    uint32_t delay = base + path_factor + jitter;
+    uint32_t delay = base + path_factor + snr_factor + jitter;
 
     if (delay > MESHGRID_RETRANSMIT_MAX_MS) {
         delay = MESHGRID_RETRANSMIT_MAX_MS;
@@ -190,12 +486,83 @@ uint32_t meshgrid_retransmit_delay(const struct meshgrid_packet *pkt, uint32_t r
     return delay;
 }
 
+/*
+ * Path-independent fingerprint (FNV-1a over payload type + payload)
+ * Every relayed copy of a flood carries a different path but the same
+ * fingerprint, which is what forward suppression counts.
+ */
+uint32_t meshgrid_packet_fingerprint(const struct meshgrid_packet_view *pkt)
+{
+    uint32_t h = 2166136261u;
+
+    h = (h ^ pkt->payload_type) * 16777619u;
+    for (uint16_t i = 0; i < pkt->payload_len; i++) {
+        h = (h ^ pkt->payload[i]) * 16777619u;
+    }
+    return h;
+}
+
+/*
+ * Counter-based flood suppression threshold
+ *
+ * A pending forward is cancelled once this many copies (including the
+ * one that triggered it) have been heard. Sparse neighborhoods need every
+ * relay for coverage, dense ones only a few.
+ */
+uint8_t meshgrid_suppress_threshold(uint16_t direct_neighbors)
+{
+    if (direct_neighbors <= 2) {
+        return MESHGRID_SUPPRESS_OFF;
+    }
+    if (direct_neighbors <= 5) {
+        return 4;
+    }
+    if (direct_neighbors <= 10) {
+        return 3;
+    }
+    return 2;
+}
+
+/*
+ * Policy-specific extra delay for a flood we relay
+ * FWD_POLICY_GEO: relays making more progress toward dest go first, so
+ * the others overhear them and cancel (contention-based forwarding).
+ */
+uint32_t meshgrid_forward_defer(const struct meshgrid_packet_view *pkt)
+{
+    if (forward_policy != FWD_POLICY_GEO || !is_addressed(pkt)) {
+        return 0;
+    }
+
+    int upstream = meshgrid_transmitter_hash(pkt);
+    int16_t progress = upstream < 0 ? -1 : geo_progress(pkt->payload[0], (uint8_t)upstream, pkt->rx_time);
+    if (progress < 0) {
+        return 0;
+    }
+    return (uint32_t)(1000 - progress) * MESHGRID_GEO_CONTENTION_MS / 1000;
+}
+
+/*
+ * Does this overheard copy count toward cancelling our pending forward?
+ * FWD_POLICY_GEO: not a copy from a node farther from dest than us - the
+ * flood has not moved on, and counting those stalls it on long chains.
+ */
+bool meshgrid_copy_suppresses(const struct meshgrid_packet_view *pkt)
+{
+    if (forward_policy != FWD_POLICY_GEO || !is_addressed(pkt)) {
+        return true;
+    }
+
+    int tx = meshgrid_transmitter_hash(pkt);
+    return tx < 0 || !geo_behind(pkt->payload[0], (uint8_t)tx, pkt->rx_time);
+}
+
 /*
  * Add our hash to the path (for flood routing)
  */
 int meshgrid_path_append(struct meshgrid_packet *pkt, uint8_t our_hash)
 {
-    if (pkt->path_len >= MESHGRID_MAX_PATH_SIZE) {
+    if (pkt->path_len >= MESHGRID_MAX_PATH_SIZE || MESHGRID_IS_PATHLESS(pkt->header)) {
         return -1;
     }
 
@@ -203,6 +570,51 @@ int meshgrid_path_append(struct meshgrid_packet *pkt, uint8_t our_hash)
     return 0;
 }
 
+/*
+ * Hash of the node that transmitted this copy, or -1 if unknown
+ *
+ * Floods carry their relays in order, so the last path entry is the
+ * neighbor we heard. A zero-hop packet was sent by its originator.
+ * Direct packets have already dropped the hops they passed.
+ */
+int meshgrid_transmitter_hash(const struct meshgrid_packet_view *pkt)
+{
+    if (pkt->version != PAYLOAD_VER_MESHCORE) {
+        return -1;
+    }
+
+    if (pkt->path_len > 0) {
+        return MESHGRID_IS_FLOOD(pkt->route_type) ? pkt->path[pkt->path_len - 1] : -1;
+    }
+
+    switch (pkt->payload_type) {
+        case PAYLOAD_ADVERT:
+            return pkt->payload_len >= MESHGRID_PUBKEY_SIZE ? meshgrid_hash_pubkey(pkt->payload) : -1;
+        case PAYLOAD_REQ:
+        case PAYLOAD_RESPONSE:
+        case PAYLOAD_TXT_MSG:
+        case PAYLOAD_PATH:
+            /* [dest_hash][src_hash]... */
+            return pkt->payload_len >= 2 ? pkt->payload[1] : -1;
+        default:
+            return -1;
+    }
+}
+
+/*
+ * Remove the first hop (ourselves) from a direct packet's path
+ */
+int meshgrid_path_pop(struct meshgrid_packet *pkt)
+{
+    if (pkt->path_len == 0) {
+        return -1;
+    }
+
+    pkt->path_len--;
+    memmove(pkt->path, pkt->path + 1, pkt->path_len);
+    return 0;
+}
+
 /*
  * Create advertisement packet (MeshCore compatible format)
  * Payload: pubkey(32) + timestamp(4) + signature(64) + app_data
@@ -272,7 +684,7 @@ int meshgrid_create_advert(struct meshgrid_packet *pkt, const uint8_t *pubkey,
  */
 int meshgrid_parse_advert(const struct meshgrid_packet *pkt,
                           uint8_t *pubkey, char *name, size_t name_max,
-                          uint32_t *timestamp)
+                          uint32_t *timestamp, struct meshgrid_position *pos)
 {
     if (pkt->payload_type != PAYLOAD_ADVERT) {
         return -1;
@@ -307,8 +719,23 @@ int meshgrid_parse_advert(const struct meshgrid_packet *pkt,
 
     uint8_t flags = pkt->payload[i++];
 
-    /* Skip optional lat/lon (8 bytes) */
+    if (pos) {
+        pos->valid = false;
+    }
+
+    /* Optional lat/lon (2 x int32, degrees x 1e6) */
     if (flags & 0x10) {  /* ADV_LATLON_MASK */
+        if (i + 8 > pkt->payload_len) {
+            return -1;
+        }
+        if (pos) {
+            const uint8_t *p = &pkt->payload[i];
+            pos->lat_e6 = (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+                                    ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+            pos->lon_e6 = (int32_t)((uint32_t)p[4] | ((uint32_t)p[5] << 8) |
+                                    ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24));
+            pos->valid = true;
+        }
         i += 8;
     }
 
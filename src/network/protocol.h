@@ -15,6 +15,9 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "link_quality.h"
+#include "packet_view.h"
+
 /*
  * MeshCore-compatible constants
  */
@@ -52,6 +55,14 @@
 #define MESHGRID_NEIGHBOR_TIMEOUT_MS (15 * 60 * 1000)
 #define MESHGRID_RETRANSMIT_BASE_MS 100
 #define MESHGRID_RETRANSMIT_MAX_MS 5000
+#define MESHGRID_RETRANSMIT_SNR_MIN (-20)     /* dB: weakest receivers, no extra delay */
+#define MESHGRID_RETRANSMIT_SNR_MAX 10        /* dB: strongest receivers, full extra delay */
+#define MESHGRID_RETRANSMIT_SNR_SPAN_MS 500   /* Extra delay at SNR_MAX */
+#define MESHGRID_DIRECT_JITTER_MS 50          /* Direct relays: only we were chosen, just jitter */
+#define MESHGRID_SUPPRESS_OFF 0xFF            /* Suppression threshold: never cancel */
+#define MESHGRID_DIRECTED_DEFER_MS 1500       /* Extra delay for a relay no neighbor filter asks for */
+#define MESHGRID_DIRECTED_SUPPRESS_K 2        /* ... cancelled by the first other relay overheard */
+#define MESHGRID_GEO_CONTENTION_MS 1500       /* Geographic: extra delay for a relay making no progress */
 #define MESHGRID_DUPLICATE_WINDOW_MS (60 * 1000)
 
 /*
@@ -113,6 +124,36 @@ enum meshgrid_device_mode {
     MODE_REPEATER = 1, /* Forward only */
 };
 
+/*
+ * Flood forwarding policy
+ */
+enum meshgrid_forward_policy {
+    FWD_POLICY_FLOOD = 0,    /* Relay every flood (MeshCore behavior) */
+    FWD_POLICY_BLOOM = 1,    /* Defer addressed floods neighbor Bloom filters say lead away from dest */
+    FWD_POLICY_STRICT = 2,   /* Drop them */
+    FWD_POLICY_MPR = 3,      /* Relay any flood only as a multipoint relay of the previous hop */
+    FWD_POLICY_GEO = 4,      /* Relay addressed floods only when closer to dest than the previous hop */
+};
+
+/*
+ * Forwarding decision (FWD_DROP is false, so it still reads as a bool)
+ */
+enum meshgrid_fwd_verdict {
+    FWD_DROP = 0,
+    FWD_RELAY = 1,
+    FWD_RELAY_LATE = 2, /* Relay only if no other relay is overheard first */
+};
+
+/*
+ * Early receive class, from the header, path and first payload bytes only
+ */
+enum meshgrid_rx_class {
+    RX_DROP = 0,                /* Neither ours nor ours to relay */
+    RX_FORWARD_ONLY = 1,        /* Relay without decrypting or parsing further */
+    RX_CONSUME = 2,             /* For us (or undecidable without decrypting), not relayed here */
+    RX_CONSUME_AND_FORWARD = 3, /* For us and relayed on */
+};
+
 /*
  * Helper macros
  */
@@ -128,6 +169,11 @@ enum meshgrid_device_mode {
 #define MESHGRID_IS_DIRECT(route) ((route) == ROUTE_DIRECT || (route) == ROUTE_TRANSPORT_DIRECT)
 #define MESHGRID_HAS_TRANSPORT(route) ((route) == ROUTE_TRANSPORT_FLOOD || (route) == ROUTE_TRANSPORT_DIRECT)
 
+/* meshgrid v1 messages are bare AEAD frames - [header][nonce][ciphertext][tag], no path */
+#define MESHGRID_IS_PATHLESS(hdr)                                                                                      \
+    (MESHGRID_GET_VERSION(hdr) == PAYLOAD_VER_MESHGRID &&                                                              \
+     (MESHGRID_GET_TYPE(hdr) == PAYLOAD_TXT_MSG || MESHGRID_GET_TYPE(hdr) == PAYLOAD_GRP_TXT))
+
 /*
  * Parsed packet structure
  */
@@ -155,6 +201,15 @@ struct meshgrid_packet {
     uint32_t rx_time;
 };
 
+/*
+ * Advert position (MeshCore ADV_LATLON: degrees x 1e6, little endian)
+ */
+struct meshgrid_position {
+    int32_t lat_e6;
+    int32_t lon_e6;
+    bool valid;
+};
+
 /*
  * Node types (inferred from advert data or name prefix)
  */
@@ -192,10 +247,14 @@ struct meshgrid_neighbor {
     uint8_t hops;                      /* Hop count when first seen */
     uint8_t shared_secret[32];         /* Cached ECDH shared secret */
     bool secret_valid;                 /* True if shared_secret is cached */
+    struct link_quality link;          /* Smoothed SNR/RSSI, delivery ratio, score */
 
     /* Protocol v1 state (for meshgrid-to-meshgrid communication) */
     uint32_t last_seq_rx; /* Last received sequence number */
     uint32_t next_seq_tx; /* Next sequence number to send */
+
+    uint32_t last_used; /* millis() of last lookup or advert - table eviction is LRU */
+    uint16_t dir_slot;  /* Node directory slot (core/node_dir.h), 0xFFFF if none */
 };
 
 /*
@@ -236,7 +295,7 @@ extern "C" {
 uint8_t meshgrid_hash_pubkey(const uint8_t* pubkey);
 
 /* Compute packet hash for deduplication */
-void meshgrid_packet_hash(const struct meshgrid_packet* pkt, uint8_t* hash);
+void meshgrid_packet_hash(const struct meshgrid_packet_view* pkt, uint8_t* hash);
 
 /* Encode packet to wire format */
 int meshgrid_packet_encode(const struct meshgrid_packet* pkt, uint8_t* buf, size_t buf_len);
@@ -244,21 +303,63 @@ int meshgrid_packet_encode(const struct meshgrid_packet* pkt, uint8_t* buf, size
 /* Parse packet from wire format */
 int meshgrid_packet_parse(const uint8_t* buf, size_t len, struct meshgrid_packet* pkt);
 
+/* Parse a received frame without copying it (RX metadata zeroed) */
+int meshgrid_view_parse(const uint8_t* buf, size_t len, struct meshgrid_packet_view* pkt);
+
+/* Encode a received frame with a new path - for relaying */
+int meshgrid_view_encode(const struct meshgrid_packet_view* pkt, const uint8_t* path, uint8_t path_len, uint8_t* buf,
+                         size_t buf_len);
+
 /* Should we forward this packet? */
-bool meshgrid_should_forward(const struct meshgrid_packet* pkt, uint8_t our_hash, enum meshgrid_device_mode mode);
+enum meshgrid_fwd_verdict meshgrid_should_forward(const struct meshgrid_packet_view* pkt, uint8_t our_hash,
+                                                  enum meshgrid_device_mode mode);
+
+/* Directed flooding policy (default FWD_POLICY_FLOOD) */
+void meshgrid_set_forward_policy(enum meshgrid_forward_policy policy);
+enum meshgrid_forward_policy meshgrid_get_forward_policy(void);
+const char* meshgrid_forward_policy_name(enum meshgrid_forward_policy policy);
+
+/* Policy from its name (FLOOD, BLOOM, STRICT, MPR, GEO), -1 if unknown */
+int meshgrid_forward_policy_parse(const char* name);
+
+/* Should we relay this direct packet (we are the next hop)? */
+bool meshgrid_should_forward_direct(const struct meshgrid_packet_view* pkt, uint8_t our_hash,
+                                    enum meshgrid_device_mode mode);
 
-/* Calculate retransmit delay based on path length */
-uint32_t meshgrid_retransmit_delay(const struct meshgrid_packet* pkt, uint32_t random_byte);
+/* Classify a frame from its header; have_channel says whether we hold a channel hash's key */
+enum meshgrid_rx_class meshgrid_classify(const struct meshgrid_packet_view* pkt, uint8_t our_hash,
+                                         enum meshgrid_device_mode mode, bool (*have_channel)(uint8_t hash));
+
+/* Calculate retransmit delay from the relayed copy's path length and our receive SNR */
+uint32_t meshgrid_retransmit_delay(uint8_t path_len, int8_t rx_snr, uint32_t random_byte);
+
+/* Path-independent packet identity (same for every relayed copy) */
+uint32_t meshgrid_packet_fingerprint(const struct meshgrid_packet_view* pkt);
+
+/* Overheard copies that cancel a pending forward, from direct neighbor count */
+uint8_t meshgrid_suppress_threshold(uint16_t direct_neighbors);
+
+/* Policy-specific extra delay for a flood we relay (call before appending ourselves) */
+uint32_t meshgrid_forward_defer(const struct meshgrid_packet_view* pkt);
+
+/* Does this overheard copy count toward cancelling our pending forward? */
+bool meshgrid_copy_suppresses(const struct meshgrid_packet_view* pkt);
 
 /* Add our hash to the path */
 int meshgrid_path_append(struct meshgrid_packet* pkt, uint8_t our_hash);
 
+/* Remove the first hop from the path */
+int meshgrid_path_pop(struct meshgrid_packet* pkt);
+
+/* Neighbor that transmitted this copy (-1 = unknown) */
+int meshgrid_transmitter_hash(const struct meshgrid_packet_view* pkt);
+
 /* Create advertisement packet */
 int meshgrid_create_advert(struct meshgrid_packet* pkt, const uint8_t* pubkey, const char* name, uint32_t timestamp);
 
-/* Parse advertisement payload */
+/* Parse advertisement payload (pos may be NULL) */
 int meshgrid_parse_advert(const struct meshgrid_packet* pkt, uint8_t* pubkey, char* name, size_t name_max,
-                          uint32_t* timestamp);
+                          uint32_t* timestamp, struct meshgrid_position* pos);
 
 #ifdef __cplusplus
 }
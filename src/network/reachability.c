@@ -0,0 +1,324 @@
+/**
+ * Reachability - attenuated Bloom filters carried in v1 adverts
+ *
+ * Pure C, no Arduino dependencies: time is passed in by the caller.
+ */
+
+#include "reachability.h"
+#include "utils/memory.h"
+#include <string.h>
+
+/* Odd multiplier: every 1-byte hash gets its own pair of bit positions
+ * (one hash maps both to the same bit) - searched exhaustively on the host */
+#define REACH_KEY_MULT 139u
+
+struct reach_peer {
+    uint8_t hash;
+    bool valid;
+    bool has_filter;
+    uint32_t heard_ms;  /* Last frame transmitted by this neighbor */
+    uint32_t filter_ms; /* Last filter received */
+    struct meshgrid_bloom_set filter;
+};
+
+static struct reach_peer peers[REACH_NEIGHBORS];
+static struct meshgrid_bloom_set view;
+static struct reach_stats stats;
+static uint8_t self_hash;
+static uint32_t rotated_ms;
+static uint32_t evicted_ms;  /* A fresh neighbor was dropped for lack of room */
+static bool evicted;
+
+static uint8_t *level_ptr(struct meshgrid_bloom_set *b, uint8_t level)
+{
+    switch (level) {
+    case 0: return b->level0;
+    case 1: return b->level1;
+    case 2: return b->level2;
+    default: return b->level3;
+    }
+}
+
+static bool peer_fresh(const struct reach_peer *p, uint32_t now)
+{
+    return p->valid && now - p->heard_ms <= REACH_PEER_TIMEOUT_MS;
+}
+
+static bool filter_fresh(const struct reach_peer *p, uint32_t now)
+{
+    return p->has_filter && now - p->filter_ms <= REACH_PEER_TIMEOUT_MS;
+}
+
+/* Neighbor's view is one hop further from us */
+static void merge_down(struct meshgrid_bloom_set *dst, const struct meshgrid_bloom_set *src)
+{
+    for (int i = 0; i < MESHGRID_BLOOM_LEVEL_BYTES; i++) {
+        dst->level1[i] |= src->level0[i];
+        dst->level2[i] |= src->level1[i];
+        dst->level3[i] |= src->level2[i] | src->level3[i];
+    }
+}
+
+/* Closest level of f claiming key, MESHGRID_BLOOM_LEVELS if none */
+static uint8_t claim_level(const struct meshgrid_bloom_set *f, uint16_t key)
+{
+    for (uint8_t level = 0; level < MESHGRID_BLOOM_LEVELS; level++) {
+        if (meshgrid_bloom_check_level(f, level, key)) {
+            return level;
+        }
+    }
+    return MESHGRID_BLOOM_LEVELS;
+}
+
+/* A level not already known to be saturated crossed the fill limit */
+static bool over_full(void)
+{
+    for (uint8_t level = 0; level < MESHGRID_BLOOM_LEVELS; level++) {
+        if (stats.saturated & (1u << level)) {
+            continue;
+        }
+        if (meshgrid_bloom_fill_level(&view, level) > REACH_FILL_MAX_BITS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void rebuild(uint32_t now)
+{
+    meshgrid_bloom_clear(&view);
+    meshgrid_bloom_add(&view, 0, reach_key(self_hash));
+
+    for (int i = 0; i < REACH_NEIGHBORS; i++) {
+        struct reach_peer *p = &peers[i];
+        if (!peer_fresh(p, now)) {
+            p->valid = false;
+            continue;
+        }
+        meshgrid_bloom_add(&view, 0, reach_key(p->hash));
+        if (filter_fresh(p, now)) {
+            merge_down(&view, &p->filter);
+        } else {
+            p->has_filter = false;
+        }
+    }
+
+    /* Still over the limit with only fresh state: too dense to prove anything */
+    stats.saturated = 0;
+    for (uint8_t level = 0; level < MESHGRID_BLOOM_LEVELS; level++) {
+        if (meshgrid_bloom_fill_level(&view, level) > REACH_FILL_MAX_BITS) {
+            memset(level_ptr(&view, level), 0xFF, MESHGRID_BLOOM_LEVEL_BYTES);
+            stats.saturated |= (uint8_t)(1u << level);
+        }
+    }
+
+    rotated_ms = now;
+    stats.rotations++;
+}
+
+static struct reach_peer *peer_slot(uint8_t hash, uint32_t now)
+{
+    struct reach_peer *slot = NULL;
+
+    for (int i = 0; i < REACH_NEIGHBORS; i++) {
+        if (peers[i].valid && peers[i].hash == hash) {
+            return &peers[i];
+        }
+    }
+
+    /* Free or stale slot, else the neighbor heard least recently */
+    for (int i = 0; i < REACH_NEIGHBORS; i++) {
+        if (!peer_fresh(&peers[i], now)) {
+            slot = &peers[i];
+            break;
+        }
+        if (!slot || now - peers[i].heard_ms > now - slot->heard_ms) {
+            slot = &peers[i];
+        }
+    }
+    if (peer_fresh(slot, now)) {
+        /* Its filter is gone but it may still be the only way somewhere */
+        evicted = true;
+        evicted_ms = now;
+    }
+
+    memset(slot, 0, sizeof(*slot));
+    slot->hash = hash;
+    slot->valid = true;
+    return slot;
+}
+
+/* Every fresh neighbor has sent a fresh filter (and none was evicted) */
+static bool coverage_complete(uint32_t now)
+{
+    bool any = false;
+
+    if (evicted && now - evicted_ms <= REACH_PEER_TIMEOUT_MS) {
+        return false;
+    }
+    evicted = false;
+
+    for (int i = 0; i < REACH_NEIGHBORS; i++) {
+        if (!peer_fresh(&peers[i], now)) {
+            continue;
+        }
+        if (!filter_fresh(&peers[i], now)) {
+            return false;
+        }
+        any = true;
+    }
+    return any;
+}
+
+uint16_t reach_key(uint8_t hash)
+{
+    return (uint16_t)((hash * REACH_KEY_MULT) & 0x0FFF);
+}
+
+void reach_init(uint8_t our_hash, uint32_t now)
+{
+    memset(peers, 0, sizeof(peers));
+    memset(&stats, 0, sizeof(stats));
+    self_hash = our_hash;
+    evicted = false;
+    rebuild(now);
+    stats.rotations = 0;
+}
+
+void reach_tick(uint32_t now)
+{
+    if (now - rotated_ms >= REACH_ROTATE_MS) {
+        rebuild(now);
+    }
+}
+
+void reach_note_neighbor(uint8_t hash, uint32_t now)
+{
+    if (hash == self_hash) {
+        return;
+    }
+
+    struct reach_peer *p = peer_slot(hash, now);
+    bool known = p->heard_ms != 0;
+    p->heard_ms = now ? now : 1;
+
+    if (!known) {
+        meshgrid_bloom_add(&view, 0, reach_key(hash));
+    }
+}
+
+void reach_merge(const uint8_t *payload, uint16_t len, uint32_t now)
+{
+    if (len < REACH_ADVERT_LEN || payload[0] == self_hash) {
+        return;
+    }
+
+    reach_note_neighbor(payload[0], now);
+    struct reach_peer *p = peer_slot(payload[0], now);
+    meshgrid_bloom_decode(&payload[1], &p->filter);
+    p->has_filter = true;
+    p->filter_ms = now;
+    stats.merges++;
+
+    merge_down(&view, &p->filter);
+
+    /* Incremental merges only add bits - start over once the view saturates */
+    if (over_full() && now - rotated_ms >= REACH_MIN_ROTATE_MS) {
+        stats.early++;
+        rebuild(now);
+    }
+}
+
+int reach_encode_advert(uint8_t our_hash, uint8_t *buf)
+{
+    buf[0] = our_hash;
+    return 1 + meshgrid_bloom_encode(&view, &buf[1]);
+}
+
+enum reach_result reach_within(uint8_t dest, uint8_t max_hops, uint32_t now)
+{
+    uint16_t key = reach_key(dest);
+    uint8_t levels = max_hops >= MESHGRID_BLOOM_LEVELS ? MESHGRID_BLOOM_LEVELS : max_hops;
+
+    for (uint8_t level = 0; level < levels; level++) {
+        if (meshgrid_bloom_check_level(&view, level, key)) {
+            return REACH_MAYBE;
+        }
+    }
+
+    /* Absence only proves something if every neighbor told us what it reaches */
+    if (!coverage_complete(now)) {
+        return REACH_UNKNOWN;
+    }
+    stats.unreachable++;
+    return REACH_NO;
+}
+
+enum reach_result reach_downstream(uint8_t dest, uint8_t upstream, uint32_t now)
+{
+    uint16_t key = reach_key(dest);
+    uint8_t ours = MESHGRID_BLOOM_LEVELS;   /* Our level for dest via other neighbors */
+    uint8_t theirs = MESHGRID_BLOOM_LEVELS; /* Upstream's trusted level for dest */
+
+    for (int i = 0; i < REACH_NEIGHBORS; i++) {
+        const struct reach_peer *p = &peers[i];
+        if (!peer_fresh(p, now)) {
+            continue;
+        }
+        if (p->hash == dest && dest != upstream) {
+            return REACH_MAYBE; /* Our direct neighbor */
+        }
+        if (!filter_fresh(p, now)) {
+            continue;
+        }
+
+        uint8_t level = claim_level(&p->filter, key);
+        if (level == MESHGRID_BLOOM_LEVELS) {
+            continue;
+        }
+        if (p->hash == upstream) {
+            if (meshgrid_bloom_fill_level(&p->filter, level) <= REACH_TRUST_BITS) {
+                theirs = level;
+            }
+        } else {
+            /* One hop further from us; level 3 is open-ended */
+            uint8_t via = level + 1 < MESHGRID_BLOOM_LEVELS ? level + 1 : MESHGRID_BLOOM_LEVELS - 1;
+            if (via < ours) {
+                ours = via;
+            }
+        }
+    }
+
+    /* A neighbor without a filter could be the way there */
+    if (!coverage_complete(now)) {
+        return REACH_UNKNOWN;
+    }
+    if (ours == MESHGRID_BLOOM_LEVELS || theirs < ours) {
+        stats.pruned++;
+        return REACH_NO;
+    }
+    return REACH_MAYBE;
+}
+
+void reach_note_suppressed(void)
+{
+    stats.suppressed++;
+}
+
+const struct reach_stats *reach_get_stats(uint32_t now)
+{
+    stats.neighbors = 0;
+    stats.filters = 0;
+    for (int i = 0; i < REACH_NEIGHBORS; i++) {
+        if (peer_fresh(&peers[i], now)) {
+            stats.neighbors++;
+            if (filter_fresh(&peers[i], now)) {
+                stats.filters++;
+            }
+        }
+    }
+    for (uint8_t level = 0; level < MESHGRID_BLOOM_LEVELS; level++) {
+        stats.fill[level] = meshgrid_bloom_fill_level(&view, level);
+    }
+    return &stats;
+}
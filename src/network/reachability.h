@@ -0,0 +1,105 @@
+/**
+ * Reachability - attenuated Bloom filters carried in v1 adverts
+ *
+ * Every node summarizes who it can reach in a 4-level Bloom filter:
+ *   level 0: ourselves and our direct neighbors (within 1 hop)
+ *   level 1: within 2 hops
+ *   level 2: within 3 hops
+ *   level 3: 4 hops or more
+ * The filter goes out with each local advert. A neighbor's filter is
+ * merged one level down (its level 0 is our level 1, ...; levels 2 and 3
+ * both land in our level 3), so knowledge spreads one hop per advert round.
+ *
+ * A Bloom filter can only prove absence. reach_within() answers REACH_NO
+ * only when every direct neighbor we hear has sent a fresh filter - a
+ * silent (or MeshCore-only) neighbor could be the way to the destination.
+ *
+ * Merging only ever sets bits, so departed nodes linger and the filter
+ * fills up. The view is rebuilt from the stored per-neighbor filters
+ * every REACH_ROTATE_MS, and early when a level's popcount passes
+ * REACH_FILL_MAX_BITS. A level still over the limit after a rebuild is
+ * saturated: it is advertised as all ones and never proves absence.
+ * Pure C - the caller owns the clock.
+ */
+
+#ifndef MESHGRID_REACHABILITY_H
+#define MESHGRID_REACHABILITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../../lib/meshgrid-v1/src/discovery/bloom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define REACH_ROTATE_MS 600000UL      /* Periodic rebuild from fresh neighbor state */
+#define REACH_MIN_ROTATE_MS 60000UL   /* Earliest rebuild after the previous one */
+#define REACH_PEER_TIMEOUT_MS 900000UL /* Neighbor / filter freshness (MESHGRID_NEIGHBOR_TIMEOUT_MS) */
+#define REACH_FILL_MAX_BITS 40        /* Of 64: ~39% false positives with 2 hashes */
+#define REACH_TRUST_BITS 12           /* Of 64: ~3.5% - a claim trusted enough to prune on */
+#define REACH_ANY_HOPS 0xFF           /* reach_within(): any distance */
+
+/* Wire format of the reachability advert payload: [src hash][filter] */
+#define REACH_ADVERT_LEN (1 + MESHGRID_BLOOM_TOTAL_BYTES)
+
+enum reach_result {
+    REACH_UNKNOWN = -1, /* Incomplete neighbor coverage - cannot tell */
+    REACH_NO = 0,       /* Certainly not within the requested hops */
+    REACH_MAYBE = 1,    /* Present (or a false positive) */
+};
+
+struct reach_stats {
+    uint32_t merges;      /* Neighbor filters received */
+    uint32_t rotations;   /* Rebuilds (periodic + early) */
+    uint32_t early;       /* Rebuilds forced by fill */
+    uint32_t unreachable; /* Lookups answered REACH_NO */
+    uint32_t pruned;      /* Floods no neighbor leads onward (reach_downstream NO) */
+    uint32_t suppressed;  /* Messages not flooded because dest was REACH_NO */
+    uint8_t saturated;    /* Bitmask of levels currently saturated */
+    uint8_t fill[MESHGRID_BLOOM_LEVELS]; /* Set bits per level */
+    uint8_t neighbors;    /* Direct neighbors tracked */
+    uint8_t filters;      /* ... of which sent a fresh filter */
+};
+
+void reach_init(uint8_t our_hash, uint32_t now);
+
+/* Rebuild the view when it is due; call periodically */
+void reach_tick(uint32_t now);
+
+/* Heard a frame transmitted directly by this node */
+void reach_note_neighbor(uint8_t hash, uint32_t now);
+
+/* Reachability advert payload from a direct neighbor */
+void reach_merge(const uint8_t *payload, uint16_t len, uint32_t now);
+
+/* Our filter, ready for an advert; returns REACH_ADVERT_LEN */
+int reach_encode_advert(uint8_t our_hash, uint8_t *buf);
+
+/* Is dest reachable within max_hops (1-4, or REACH_ANY_HOPS)? */
+enum reach_result reach_within(uint8_t dest, uint8_t max_hops, uint32_t now);
+
+/*
+ * Would relaying a flood for dest, heard from neighbor upstream, move it
+ * toward dest? REACH_NO when every neighbor has a fresh filter and either
+ *   - no neighbor but upstream claims dest at all, or
+ *   - upstream's own filter places dest strictly closer to upstream than
+ *     any other neighbor places it to us (a trusted, low-fill claim only)
+ * A false positive in our neighbors' filters only makes us relay more.
+ */
+enum reach_result reach_downstream(uint8_t dest, uint8_t upstream, uint32_t now);
+
+/* A send to a REACH_NO destination was dropped instead of flooded */
+void reach_note_suppressed(void);
+
+/* Bloom key for a 1-byte node hash */
+uint16_t reach_key(uint8_t hash);
+
+const struct reach_stats *reach_get_stats(uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_REACHABILITY_H */
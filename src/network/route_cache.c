@@ -0,0 +1,284 @@
+/**
+ * Route cache - learned direct paths per destination
+ *
+ * Pure C, no Arduino dependencies: time is passed in by the caller.
+ */
+
+#include "route_cache.h"
+#include "utils/memory.h"
+#include <string.h>
+
+struct route_path {
+    uint8_t hops[ROUTE_MAX_HOPS];
+    uint8_t len;
+    int8_t snr_x4;       /* Link quality when the path was learned */
+    uint8_t fails;       /* Direct sends on this path without an ACK */
+    uint32_t learned_ms;
+    bool valid;
+};
+
+struct route_entry {
+    uint8_t dest;
+    uint8_t fails;       /* Consecutive direct sends without an ACK */
+    uint32_t used_ms;    /* Last learn or lookup, for eviction */
+    struct route_path paths[ROUTE_CACHE_PATHS];
+    bool valid;
+};
+
+struct pending_ack {
+    uint32_t ack_crc;
+    uint32_t deadline_ms;
+    uint8_t dest;
+    int8_t path_len;     /* ROUTE_FLOOD for flood sends */
+    uint8_t path[ROUTE_MAX_HOPS];
+    bool valid;
+};
+
+static struct route_entry entries[ROUTE_CACHE_SIZE];
+static struct pending_ack pending[ROUTE_PENDING_ACKS];
+static struct route_cache_stats stats;
+
+static int32_t path_cost(const struct route_path *p)
+{
+    return (int32_t)p->len * ROUTE_HOP_COST - p->snr_x4 + (int32_t)p->fails * ROUTE_FAIL_COST;
+}
+
+static struct route_entry *find_entry(uint8_t dest)
+{
+    for (int i = 0; i < ROUTE_CACHE_SIZE; i++) {
+        if (entries[i].valid && entries[i].dest == dest) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+static struct route_path *find_path(struct route_entry *e, const uint8_t *path, uint8_t path_len)
+{
+    for (int i = 0; i < ROUTE_CACHE_PATHS; i++) {
+        struct route_path *p = &e->paths[i];
+        if (p->valid && p->len == path_len && memcmp(p->hops, path, path_len) == 0) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/* Drop stale candidates; returns the best remaining one */
+static struct route_path *best_path(struct route_entry *e, uint32_t now)
+{
+    struct route_path *best = NULL;
+
+    for (int i = 0; i < ROUTE_CACHE_PATHS; i++) {
+        struct route_path *p = &e->paths[i];
+        if (!p->valid) {
+            continue;
+        }
+        if (now - p->learned_ms > ROUTE_MAX_AGE_MS) {
+            p->valid = false;
+            continue;
+        }
+        if (!best || path_cost(p) < path_cost(best)) {
+            best = p;
+        }
+    }
+    return best;
+}
+
+void route_cache_init(void)
+{
+    memset(entries, 0, sizeof(entries));
+    memset(pending, 0, sizeof(pending));
+    memset(&stats, 0, sizeof(stats));
+}
+
+void route_cache_learn(uint8_t dest, const uint8_t *path, uint8_t path_len, int8_t snr_x4, uint32_t now)
+{
+    if (path_len > ROUTE_MAX_HOPS) {
+        return;
+    }
+
+    struct route_entry *e = find_entry(dest);
+    if (!e) {
+        /* Free slot, else evict the least recently used destination */
+        e = &entries[0];
+        for (int i = 0; i < ROUTE_CACHE_SIZE; i++) {
+            if (!entries[i].valid) {
+                e = &entries[i];
+                break;
+            }
+            if (now - entries[i].used_ms > now - e->used_ms) {
+                e = &entries[i];
+            }
+        }
+        memset(e, 0, sizeof(*e));
+        e->dest = dest;
+        e->valid = true;
+    }
+    e->used_ms = now;
+
+    struct route_path *p = find_path(e, path, path_len);
+    if (!p) {
+        struct route_path fresh;
+        memset(&fresh, 0, sizeof(fresh));
+        fresh.len = path_len;
+        fresh.snr_x4 = snr_x4;
+
+        /* Free candidate slot, else replace the worst if the new path ranks better */
+        struct route_path *worst = NULL;
+        for (int i = 0; i < ROUTE_CACHE_PATHS; i++) {
+            if (!e->paths[i].valid) {
+                p = &e->paths[i];
+                break;
+            }
+            if (!worst || path_cost(&e->paths[i]) > path_cost(worst)) {
+                worst = &e->paths[i];
+            }
+        }
+        if (!p) {
+            if (path_cost(&fresh) >= path_cost(worst)) {
+                return;
+            }
+            p = worst;
+        }
+        memcpy(p->hops, path, path_len);
+        p->len = path_len;
+        p->valid = true;
+    }
+
+    /* Re-learned path: fresh measurement, failures forgiven */
+    p->snr_x4 = snr_x4;
+    p->fails = 0;
+    p->learned_ms = now;
+    stats.learned++;
+}
+
+int route_cache_lookup(uint8_t dest, uint8_t *path, uint32_t now)
+{
+    struct route_entry *e = find_entry(dest);
+    struct route_path *p = e ? best_path(e, now) : NULL;
+
+    if (!p) {
+        stats.misses++;
+        return ROUTE_FLOOD;
+    }
+
+    if (e->fails >= ROUTE_MAX_DIRECT_FAILS) {
+        /* Paths keep failing - flood, and let the PATH return re-learn */
+        e->valid = false;
+        stats.fallbacks++;
+        return ROUTE_FLOOD;
+    }
+
+    e->used_ms = now;
+    memcpy(path, p->hops, p->len);
+    stats.hits++;
+    return p->len;
+}
+
+void route_cache_expect_ack(uint8_t dest, uint32_t ack_crc, const uint8_t *path, int path_len, uint32_t now)
+{
+    struct pending_ack *slot = &pending[0];
+
+    /* Free slot, else the one closest to its deadline */
+    for (int i = 0; i < ROUTE_PENDING_ACKS; i++) {
+        if (!pending[i].valid) {
+            slot = &pending[i];
+            break;
+        }
+        if ((int32_t)(pending[i].deadline_ms - slot->deadline_ms) < 0) {
+            slot = &pending[i];
+        }
+    }
+
+    slot->ack_crc = ack_crc;
+    slot->dest = dest;
+    if (path_len < 0 || path_len > ROUTE_MAX_HOPS) {
+        slot->path_len = ROUTE_FLOOD;
+        slot->deadline_ms = now + ROUTE_FLOOD_ACK_TIMEOUT_MS;
+    } else {
+        slot->path_len = (int8_t)path_len;
+        memcpy(slot->path, path, path_len);
+        slot->deadline_ms = now + ROUTE_ACK_TIMEOUT_MS + (uint32_t)path_len * ROUTE_ACK_HOP_MS;
+    }
+    slot->valid = true;
+}
+
+int route_cache_ack(uint32_t ack_crc, uint32_t now)
+{
+    (void)now;
+
+    for (int i = 0; i < ROUTE_PENDING_ACKS; i++) {
+        struct pending_ack *a = &pending[i];
+        if (!a->valid || a->ack_crc != ack_crc) {
+            continue;
+        }
+        a->valid = false;
+
+        if (a->path_len != ROUTE_FLOOD) {
+            struct route_entry *e = find_entry(a->dest);
+            if (e) {
+                struct route_path *p = find_path(e, a->path, (uint8_t)a->path_len);
+                if (p) {
+                    p->fails = 0;
+                }
+                e->fails = 0;
+            }
+            stats.acked++;
+        }
+        return a->dest;
+    }
+    return -1;
+}
+
+void route_cache_tick(uint32_t now)
+{
+    for (int i = 0; i < ROUTE_PENDING_ACKS; i++) {
+        struct pending_ack *a = &pending[i];
+        if (!a->valid || (int32_t)(now - a->deadline_ms) < 0) {
+            continue;
+        }
+        a->valid = false;
+
+        if (a->path_len == ROUTE_FLOOD) {
+            continue;
+        }
+
+        /* Penalize the path so the next lookup may pick another candidate */
+        stats.failed++;
+        struct route_entry *e = find_entry(a->dest);
+        if (e) {
+            struct route_path *p = find_path(e, a->path, (uint8_t)a->path_len);
+            if (p && p->fails < 0xFF) {
+                p->fails++;
+            }
+            if (e->fails < 0xFF) {
+                e->fails++;
+            }
+        }
+    }
+}
+
+void route_cache_forget(uint8_t dest)
+{
+    struct route_entry *e = find_entry(dest);
+    if (e) {
+        e->valid = false;
+    }
+}
+
+uint16_t route_cache_count(void)
+{
+    uint16_t n = 0;
+    for (int i = 0; i < ROUTE_CACHE_SIZE; i++) {
+        if (entries[i].valid) {
+            n++;
+        }
+    }
+    return n;
+}
+
+const struct route_cache_stats *route_cache_get_stats(void)
+{
+    return &stats;
+}
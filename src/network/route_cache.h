@@ -0,0 +1,85 @@
+/**
+ * Route cache - learned direct paths per destination
+ *
+ * A direct message sent by flood costs every repeater in range an
+ * airtime slot. Once a path to the destination is known it can be sent
+ * direct instead and only the repeaters on the path retransmit.
+ *
+ * Paths are learned from:
+ *   - PATH returns: the path our flood took to reach the destination
+ *   - received floods: the reversed path is a route back to the source
+ *
+ * Up to ROUTE_CACHE_PATHS candidates are kept per destination, ranked by
+ * hop count, link SNR and recent failures. Every direct send expects an
+ * ACK; a missing ACK counts against the path that was used, and after
+ * ROUTE_MAX_DIRECT_FAILS misses in a row the destination is reached by
+ * flood again (which re-learns a fresh path). Pure C - the caller owns
+ * the clock.
+ */
+
+#ifndef MESHGRID_ROUTE_CACHE_H
+#define MESHGRID_ROUTE_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ROUTE_MAX_HOPS 16             /* Longer paths are not cached */
+#define ROUTE_MAX_AGE_MS 21600000UL   /* Candidates older than 6 h are dropped */
+#define ROUTE_ACK_TIMEOUT_MS 6000     /* ACK wait for a zero-hop send */
+#define ROUTE_ACK_HOP_MS 2000         /* Extra ACK wait per hop (both ways) */
+#define ROUTE_FLOOD_ACK_TIMEOUT_MS 30000
+
+/* Ranking, in quarter-dB like snr_x4: one hop ~ 4 dB, one failure ~ 10 dB */
+#define ROUTE_HOP_COST 16
+#define ROUTE_FAIL_COST 40
+
+/* Direct attempts without an ACK before falling back to flood */
+#ifndef ROUTE_MAX_DIRECT_FAILS
+#    define ROUTE_MAX_DIRECT_FAILS 2
+#endif
+
+#define ROUTE_FLOOD (-1) /* route_cache_lookup(): no usable path */
+
+struct route_cache_stats {
+    uint32_t hits;      /* Lookups answered with a direct path */
+    uint32_t misses;    /* Lookups with no path known */
+    uint32_t fallbacks; /* Lookups sent back to flood after repeated failures */
+    uint32_t learned;   /* Paths added or refreshed */
+    uint32_t acked;     /* Direct sends confirmed by ACK */
+    uint32_t failed;    /* Direct sends that timed out */
+};
+
+void route_cache_init(void);
+
+/* Record a path to dest, in send order (first hop first) */
+void route_cache_learn(uint8_t dest, const uint8_t *path, uint8_t path_len, int8_t snr_x4, uint32_t now);
+
+/* Best path to dest: copies it to path (ROUTE_MAX_HOPS bytes) and returns its
+ * length (0 = zero hop), or ROUTE_FLOOD */
+int route_cache_lookup(uint8_t dest, uint8_t *path, uint32_t now);
+
+/* A message to dest went out on path (path_len ROUTE_FLOOD for a flood) */
+void route_cache_expect_ack(uint8_t dest, uint32_t ack_crc, const uint8_t *path, int path_len, uint32_t now);
+
+/* An ACK arrived: returns the destination it confirms, or -1 if unknown */
+int route_cache_ack(uint32_t ack_crc, uint32_t now);
+
+/* Expire overdue ACKs */
+void route_cache_tick(uint32_t now);
+
+void route_cache_forget(uint8_t dest);
+
+/* Destinations with at least one path */
+uint16_t route_cache_count(void);
+
+const struct route_cache_stats *route_cache_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_ROUTE_CACHE_H */
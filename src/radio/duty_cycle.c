@@ -0,0 +1,301 @@
+/**
+ * Regional duty-cycle regulator
+ *
+ * Pure C, no Arduino dependencies: time and frequency are passed in by the
+ * caller so the accounting can be exercised off-target.
+ */
+
+#include "duty_cycle.h"
+#include <string.h>
+
+struct duty_subband {
+    uint32_t lo_khz;
+    uint32_t hi_khz;
+    uint16_t permille; /* Limit in tenths of a percent */
+};
+
+struct duty_profile {
+    enum duty_region region;
+    const char *name;
+    uint32_t lo_khz; /* Band edges, used for AUTO */
+    uint32_t hi_khz;
+    uint16_t fallback_permille; /* Inside the band but outside any sub-band */
+    uint8_t subband_count;
+    struct duty_subband subbands[DUTY_MAX_SUBBANDS];
+};
+
+static const struct duty_profile profiles[] = {
+    {DUTY_REGION_EU868, "EU868", 863000, 870000, 1, 6,
+     {{863000, 865000, 1},
+      {865000, 868000, 10},
+      {868000, 868600, 10},
+      {868700, 869200, 1},
+      {869400, 869650, 100},
+      {869700, 870000, 10}}},
+    {DUTY_REGION_EU433, "EU433", 433050, 434790, 100, 1, {{433050, 434790, 100}}},
+};
+
+#define PROFILE_COUNT (sizeof(profiles) / sizeof(profiles[0]))
+
+/* One ledger per sub-band plus one for the in-band fallback */
+#define LEDGER_COUNT (DUTY_MAX_SUBBANDS + 1)
+
+struct duty_ledger {
+    uint32_t owner_khz; /* Lower edge of the sub-band this ledger tracks (0 = unused) */
+    uint32_t minute;    /* Minute index of the newest bucket */
+    uint16_t used_ms[DUTY_BUCKETS];
+};
+
+static enum duty_region configured_region = DUTY_REGION_AUTO;
+static struct duty_ledger ledgers[LEDGER_COUNT];
+static struct duty_cycle_stats stats;
+
+/* ========================================================================= */
+/* Region / sub-band lookup                                                  */
+/* ========================================================================= */
+
+static const struct duty_profile *profile_for(enum duty_region region)
+{
+    for (size_t i = 0; i < PROFILE_COUNT; i++) {
+        if (profiles[i].region == region) {
+            return &profiles[i];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t freq_to_khz(float freq_mhz)
+{
+    return (uint32_t)(freq_mhz * 1000.0f + 0.5f);
+}
+
+enum duty_region duty_cycle_effective_region(float freq_mhz)
+{
+    if (configured_region != DUTY_REGION_AUTO) {
+        return configured_region;
+    }
+
+    uint32_t khz = freq_to_khz(freq_mhz);
+    for (size_t i = 0; i < PROFILE_COUNT; i++) {
+        if (khz >= profiles[i].lo_khz && khz <= profiles[i].hi_khz) {
+            return profiles[i].region;
+        }
+    }
+    return DUTY_REGION_NONE;
+}
+
+/*
+ * Resolve the ledger and limit for a frequency
+ * Returns NULL if no duty-cycle limit applies.
+ */
+static struct duty_ledger *ledger_for(float freq_mhz, uint16_t *permille)
+{
+    const struct duty_profile *p = profile_for(duty_cycle_effective_region(freq_mhz));
+    if (p == NULL) {
+        return NULL;
+    }
+
+    uint32_t khz = freq_to_khz(freq_mhz);
+    int idx = DUTY_MAX_SUBBANDS;
+    uint32_t owner = p->lo_khz;
+    *permille = p->fallback_permille;
+
+    for (uint8_t i = 0; i < p->subband_count; i++) {
+        if (khz >= p->subbands[i].lo_khz && khz < p->subbands[i].hi_khz) {
+            idx = i;
+            owner = p->subbands[i].lo_khz;
+            *permille = p->subbands[i].permille;
+            break;
+        }
+    }
+
+    struct duty_ledger *l = &ledgers[idx];
+    if (l->owner_khz != owner) {
+        /* Region or band changed - this slot now tracks another sub-band */
+        memset(l, 0, sizeof(*l));
+        l->owner_khz = owner;
+    }
+    return l;
+}
+
+/* Age out buckets older than the window */
+static void ledger_advance(struct duty_ledger *l, uint32_t now_ms)
+{
+    uint32_t minute = now_ms / DUTY_BUCKET_MS;
+    uint32_t elapsed = minute - l->minute;
+
+    if ((int32_t)elapsed <= 0) {
+        return; /* Same minute, or a timestamp taken before the ledger last moved */
+    }
+    if (elapsed >= DUTY_BUCKETS) {
+        memset(l->used_ms, 0, sizeof(l->used_ms));
+    } else {
+        for (uint32_t m = 1; m <= elapsed; m++) {
+            l->used_ms[(l->minute + m) % DUTY_BUCKETS] = 0;
+        }
+    }
+    l->minute = minute;
+}
+
+static uint32_t ledger_used(const struct duty_ledger *l)
+{
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < DUTY_BUCKETS; i++) {
+        used += l->used_ms[i];
+    }
+    return used;
+}
+
+static uint32_t budget_for(uint16_t permille)
+{
+    return (uint32_t)((DUTY_WINDOW_MS / 1000) * permille);
+}
+
+/* ========================================================================= */
+/* Public API                                                                */
+/* ========================================================================= */
+
+void duty_cycle_set_region(enum duty_region region)
+{
+    configured_region = region;
+    memset(ledgers, 0, sizeof(ledgers));
+}
+
+enum duty_region duty_cycle_get_region(void)
+{
+    return configured_region;
+}
+
+const char *duty_cycle_region_name(enum duty_region region)
+{
+    if (region == DUTY_REGION_AUTO) {
+        return "AUTO";
+    }
+    const struct duty_profile *p = profile_for(region);
+    return p ? p->name : "NONE";
+}
+
+int duty_cycle_region_parse(const char *name)
+{
+    if (strcmp(name, "AUTO") == 0) {
+        return DUTY_REGION_AUTO;
+    }
+    if (strcmp(name, "NONE") == 0 || strcmp(name, "US915") == 0) {
+        return DUTY_REGION_NONE;
+    }
+    for (size_t i = 0; i < PROFILE_COUNT; i++) {
+        if (strcmp(name, profiles[i].name) == 0) {
+            return profiles[i].region;
+        }
+    }
+    return -1;
+}
+
+uint32_t duty_cycle_admit(float freq_mhz, uint32_t toa_ms, uint32_t now_ms)
+{
+    uint16_t permille;
+    struct duty_ledger *l = ledger_for(freq_mhz, &permille);
+    if (l == NULL) {
+        return 0;
+    }
+
+    uint32_t budget = budget_for(permille);
+    if (toa_ms > budget) {
+        return DUTY_NEVER;
+    }
+
+    ledger_advance(l, now_ms);
+    uint32_t used = ledger_used(l);
+    if (used + toa_ms <= budget) {
+        return 0;
+    }
+
+    /* Walk from the oldest bucket until enough airtime ages out */
+    uint32_t need = used + toa_ms - budget;
+    uint32_t freed = 0;
+    for (uint32_t age = DUTY_BUCKETS - 1; age > 0; age--) {
+        freed += l->used_ms[(l->minute + DUTY_BUCKETS - age) % DUTY_BUCKETS];
+        if (freed >= need) {
+            /* Bucket (minute - age) leaves the window at minute - age + DUTY_BUCKETS */
+            uint32_t expiry = (l->minute + DUTY_BUCKETS - age) * DUTY_BUCKET_MS;
+            return expiry - now_ms;
+        }
+    }
+
+    /* Only the current minute would free enough - wait a full window */
+    return (l->minute + DUTY_BUCKETS) * DUTY_BUCKET_MS - now_ms;
+}
+
+void duty_cycle_record(float freq_mhz, uint32_t toa_ms, uint32_t now_ms)
+{
+    uint16_t permille;
+    struct duty_ledger *l = ledger_for(freq_mhz, &permille);
+    if (l == NULL) {
+        return;
+    }
+
+    ledger_advance(l, now_ms);
+    uint16_t *bucket = &l->used_ms[l->minute % DUTY_BUCKETS];
+    uint32_t sum = *bucket + toa_ms;
+    *bucket = sum > 0xFFFF ? 0xFFFF : (uint16_t)sum;
+}
+
+uint32_t duty_cycle_budget_ms(float freq_mhz)
+{
+    uint16_t permille = duty_cycle_limit_permille(freq_mhz);
+    return permille ? budget_for(permille) : DUTY_UNLIMITED;
+}
+
+uint32_t duty_cycle_remaining_ms(float freq_mhz, uint32_t now_ms)
+{
+    uint16_t permille;
+    struct duty_ledger *l = ledger_for(freq_mhz, &permille);
+    if (l == NULL) {
+        return DUTY_UNLIMITED;
+    }
+
+    ledger_advance(l, now_ms);
+    uint32_t budget = budget_for(permille);
+    uint32_t used = ledger_used(l);
+    return used >= budget ? 0 : budget - used;
+}
+
+uint16_t duty_cycle_limit_permille(float freq_mhz)
+{
+    uint16_t permille;
+    return ledger_for(freq_mhz, &permille) ? permille : 0;
+}
+
+struct duty_cycle_stats *duty_cycle_get_stats(void)
+{
+    return &stats;
+}
+
+/* ========================================================================= */
+/* Time on air                                                               */
+/* ========================================================================= */
+
+uint32_t lora_time_on_air_us(float bandwidth_khz, uint8_t spreading_factor, uint8_t coding_rate,
+                             uint16_t preamble_len, bool crc, size_t payload_len)
+{
+    uint32_t bw_hz = (uint32_t)(bandwidth_khz * 1000.0f);
+    if (bw_hz == 0 || spreading_factor < 5 || spreading_factor > 12) {
+        return 0;
+    }
+
+    /* Symbol time in ns to keep precision at wide bandwidths */
+    uint64_t tsym_ns = ((uint64_t)1 << spreading_factor) * 1000000000ULL / bw_hz;
+
+    /* Low data rate optimisation above 16 ms symbols */
+    int de = tsym_ns > 16000000ULL ? 1 : 0;
+
+    int32_t num = 8 * (int32_t)payload_len - 4 * spreading_factor + 28 + (crc ? 16 : 0);
+    int32_t den = 4 * (spreading_factor - 2 * de);
+    int32_t blocks = num > 0 ? (num + den - 1) / den : 0;
+    uint32_t payload_symbols = 8 + (uint32_t)blocks * coding_rate;
+
+    /* Preamble is preamble_len + 4.25 symbols */
+    uint64_t preamble_ns = (((uint64_t)preamble_len * 4 + 17) * tsym_ns) / 4;
+
+    return (uint32_t)((preamble_ns + payload_symbols * tsym_ns) / 1000);
+}
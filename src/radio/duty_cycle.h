@@ -0,0 +1,94 @@
+/**
+ * Regional duty-cycle regulator
+ *
+ * Tracks transmit time per regulatory sub-band over a sliding one-hour
+ * window (60 one-minute buckets) and admits a frame only if its exact
+ * LoRa time-on-air still fits the sub-band budget. Otherwise it returns
+ * how long to wait until enough old airtime has aged out of the window.
+ *
+ * Profiles (limits per ETSI EN 300 220-2 for the EU bands):
+ *   EU868  863.0-865.0 0.1%, 865.0-868.0 1%, 868.0-868.6 1%,
+ *          868.7-869.2 0.1%, 869.4-869.65 10%, 869.7-870.0 1%,
+ *          anything else in the band 0.1%
+ *   EU433  433.05-434.79 10%
+ *   NONE   no duty-cycle limit (e.g. US915 - airtime budget only)
+ *   AUTO   EU868/EU433 when the frequency falls in those bands, else NONE
+ *
+ * Not thread-safe: with the radio task, every call goes under radio_lock().
+ */
+
+#ifndef MESHGRID_DUTY_CYCLE_H
+#define MESHGRID_DUTY_CYCLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum duty_region {
+    DUTY_REGION_NONE = 0,
+    DUTY_REGION_EU868 = 1,
+    DUTY_REGION_EU433 = 2,
+    DUTY_REGION_AUTO = 0xFF,
+};
+
+#define DUTY_WINDOW_MS 3600000UL  /* Regulatory accounting window (1 hour) */
+#define DUTY_BUCKET_MS 60000UL    /* Ledger granularity (1 minute) */
+#define DUTY_BUCKETS (DUTY_WINDOW_MS / DUTY_BUCKET_MS)
+#define DUTY_MAX_SUBBANDS 6
+#define DUTY_UNLIMITED 0xFFFFFFFFUL /* Budget of a sub-band without a limit */
+#define DUTY_NEVER 0xFFFFFFFFUL     /* Admission: frame can never fit */
+
+/* Regulator counters */
+struct duty_cycle_stats {
+    uint32_t admitted;
+    uint32_t deferred; /* Frames delayed until budget frees up */
+    uint32_t refused;  /* Frames rejected (direct sends or larger than budget) */
+};
+
+/* Configured region (may be DUTY_REGION_AUTO) */
+void duty_cycle_set_region(enum duty_region region);
+enum duty_region duty_cycle_get_region(void);
+
+/* Region actually applied at a given frequency (AUTO resolved) */
+enum duty_region duty_cycle_effective_region(float freq_mhz);
+
+const char *duty_cycle_region_name(enum duty_region region);
+
+/* Parse "EU868", "EU433", "NONE", "AUTO" - returns -1 if unknown */
+int duty_cycle_region_parse(const char *name);
+
+/*
+ * Predictive admission
+ * Returns 0 if a frame of toa_ms may go on air now, DUTY_NEVER if it
+ * exceeds the whole hourly budget, otherwise the wait in ms.
+ */
+uint32_t duty_cycle_admit(float freq_mhz, uint32_t toa_ms, uint32_t now_ms);
+
+/* Account a completed transmission */
+void duty_cycle_record(float freq_mhz, uint32_t toa_ms, uint32_t now_ms);
+
+/* Hourly budget and remaining budget at freq (DUTY_UNLIMITED if no limit) */
+uint32_t duty_cycle_budget_ms(float freq_mhz);
+uint32_t duty_cycle_remaining_ms(float freq_mhz, uint32_t now_ms);
+
+/* Limit at freq in tenths of a percent (0.1% = 1, 10% = 100, 0 = none) */
+uint16_t duty_cycle_limit_permille(float freq_mhz);
+
+struct duty_cycle_stats *duty_cycle_get_stats(void);
+
+/*
+ * Exact LoRa time-on-air (Semtech AN1200.13), explicit header
+ * coding_rate is 5-8 for 4/5..4/8
+ */
+uint32_t lora_time_on_air_us(float bandwidth_khz, uint8_t spreading_factor, uint8_t coding_rate,
+                             uint16_t preamble_len, bool crc, size_t payload_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_DUTY_CYCLE_H */
@@ -6,6 +6,9 @@
  */
 
 #include "radio_hal.h"
+#include "radio_lbt.h"
+#include "duty_cycle.h"
+#include "radio_task.h"
 #include <Arduino.h>
 #include "../network/protocol.h"
 
@@ -18,11 +21,34 @@ void debug_printf(int level, const char* fmt, ...) __attribute__((format(printf,
 }
 #endif
 
+/* Holds the radio lock for the scope of a setter (no-op without the radio task) */
+struct radio_lock_guard {
+    radio_lock_guard() {
+        radio_lock();
+    }
+    ~radio_lock_guard() {
+        radio_unlock();
+    }
+};
+
 /* External instances from main.cpp */
 extern struct radio_instance radio_inst;
 extern struct meshgrid_state mesh;
+extern const struct board_config* board;
+extern volatile bool radio_interrupt_flag;
+extern bool radio_in_rx_mode;
+extern struct radio_config_t {
+    float frequency;
+    float bandwidth;
+    uint8_t spreading_factor;
+    uint8_t coding_rate;
+    uint16_t preamble_len;
+    int8_t tx_power;
+    bool config_saved;
+} radio_config;
 
 int radio_set_frequency(float freq) {
+    radio_lock_guard guard;
     switch (radio_inst.type) {
         case RADIO_SX1262:
         case RADIO_SX1268:
@@ -36,6 +62,7 @@ int radio_set_frequency(float freq) {
 }
 
 int radio_set_bandwidth(float bw) {
+    radio_lock_guard guard;
     switch (radio_inst.type) {
         case RADIO_SX1262:
         case RADIO_SX1268:
@@ -49,6 +76,7 @@ int radio_set_bandwidth(float bw) {
 }
 
 int radio_set_spreading_factor(uint8_t sf) {
+    radio_lock_guard guard;
     switch (radio_inst.type) {
         case RADIO_SX1262:
         case RADIO_SX1268:
@@ -62,6 +90,7 @@ int radio_set_spreading_factor(uint8_t sf) {
 }
 
 int radio_set_coding_rate(uint8_t cr) {
+    radio_lock_guard guard;
     switch (radio_inst.type) {
         case RADIO_SX1262:
         case RADIO_SX1268:
@@ -75,6 +104,7 @@ int radio_set_coding_rate(uint8_t cr) {
 }
 
 int radio_set_output_power(int8_t power) {
+    radio_lock_guard guard;
     switch (radio_inst.type) {
         case RADIO_SX1262:
         case RADIO_SX1268:
@@ -88,6 +118,7 @@ int radio_set_output_power(int8_t power) {
 }
 
 int radio_set_preamble_length(uint16_t len) {
+    radio_lock_guard guard;
     switch (radio_inst.type) {
         case RADIO_SX1262:
         case RADIO_SX1268:
@@ -105,25 +136,174 @@ PhysicalLayer* get_radio() {
     return radio_inst.as_phy();
 }
 
+/*
+ * Exact time-on-air for a frame with the current radio settings
+ */
+uint32_t radio_airtime_ms(size_t len) {
+    uint32_t us = lora_time_on_air_us(radio_config.bandwidth, radio_config.spreading_factor, radio_config.coding_rate,
+                                      radio_config.preamble_len, board->lora_defaults.use_crc, len);
+    return (us + 999) / 1000;
+}
+
 /* External ISR from main.cpp */
 extern void radio_isr(void);
 
+/* HAL config from the saved radio settings and the board's LoRa defaults */
+void radio_build_config(struct radio_config* out) {
+    out->frequency = radio_config.frequency;
+    out->bandwidth = radio_config.bandwidth;
+    out->spreading_factor = radio_config.spreading_factor;
+    out->coding_rate = radio_config.coding_rate;
+    out->tx_power = radio_config.tx_power;
+    out->preamble_len = radio_config.preamble_len;
+    out->use_crc = board->lora_defaults.use_crc;
+    out->tcxo_voltage = board->lora_defaults.tcxo_voltage;
+    out->dio2_as_rf_switch = board->lora_defaults.dio2_as_rf_switch;
+    out->sync_word = board->lora_defaults.sync_word;
+}
+
+/*
+ * Chip status probe - read back registers we configured
+ * A chip that browned out, lost SPI or fell out of receive no longer
+ * matches. Returns false when the chip needs re-initializing.
+ */
+bool radio_probe_status(void) {
+    radio_lock_guard guard;
+    uint8_t sync = board->lora_defaults.sync_word;
+
+    switch (radio_inst.type) {
+        case RADIO_SX1262:
+        case RADIO_SX1268: {
+            /* LoRa sync word MSB: high nibble of the sync word + 0x4 control bits */
+            Module* mod = radio_inst.sx1262->getMod();
+            uint8_t expect = ((sync ? sync : RADIOLIB_SX126X_SYNC_WORD_PRIVATE) & 0xF0) | 0x04;
+            return mod->SPIgetRegValue(RADIOLIB_SX126X_REG_LORA_SYNC_WORD_MSB) == expect;
+        }
+        case RADIO_SX1276:
+        case RADIO_SX1278: {
+            Module* mod = radio_inst.sx1276->getMod();
+            if (mod->SPIgetRegValue(RADIOLIB_SX127X_REG_SYNC_WORD) != (sync ? sync : RADIOLIB_SX127X_SYNC_WORD)) {
+                return false;
+            }
+            /* While listening the op mode must be RX continuous */
+            if (radio_in_rx_mode && !radio_interrupt_flag) {
+                return mod->SPIgetRegValue(RADIOLIB_SX127X_REG_OP_MODE, 2, 0) == RADIOLIB_SX127X_RXCONTINUOUS;
+            }
+            return true;
+        }
+        default:
+            return true;
+    }
+}
+
+/*
+ * Re-initialize a stuck radio with the saved config and go back to RX
+ * Boards provide no radio_ops driver yet (NULL = auto-detect), so this
+ * goes through the HAL for the board's radio type.
+ */
+int radio_recover(void) {
+    radio_lock_guard guard;
+
+    struct radio_config hal_config;
+    radio_build_config(&hal_config);
+
+    radio_in_rx_mode = false;
+    if (radio_hal_reinit(&radio_inst, &hal_config) != 0) {
+        return -1;
+    }
+
+    get_radio()->setPacketReceivedAction(radio_isr);
+    radio_interrupt_flag = false;
+
+    int16_t state = get_radio()->startReceive();
+    radio_in_rx_mode = (state == RADIOLIB_ERR_NONE);
+    return radio_in_rx_mode ? 0 : -1;
+}
+
 /* C-style wrappers for protocol libraries to avoid vtable/struct layout issues */
 extern "C" {
-extern volatile bool radio_interrupt_flag;
 
-int16_t radio_transmit(uint8_t* data, size_t len) {
+static uint32_t tx_forwarded = 0;
+
+int16_t radio_transmit_now(uint8_t* data, size_t len, uint8_t flags) {
+    radio_lock_guard guard; /* Chip and duty-cycle ledger */
+
+    /* Regional duty cycle - last line of defence for every sender */
+    uint32_t toa = radio_airtime_ms(len);
+    uint32_t now = millis();
+    if (duty_cycle_admit(radio_config.frequency, toa, now) != 0) {
+        duty_cycle_get_stats()->refused++;
+        debug_printf(1, "WARN: duty cycle budget exhausted, %u ms frame refused", (unsigned)toa);
+        return RADIO_ERR_DUTY_CYCLE;
+    }
+
     /* Simple blocking transmit - RadioLib will handle polling */
     int16_t result = get_radio()->transmit(data, len);
     /* Debug: Log actual return value to diagnose board differences */
     if (result != 0) {
         debug_printf(0, "WARN: radio_transmit returned %d (expected 0)", result);
+    } else {
+        duty_cycle_get_stats()->admitted++;
+        duty_cycle_record(radio_config.frequency, toa, now);
+        mesh.packets_tx++;
+        if (flags & RADIO_TX_FORWARD) {
+            tx_forwarded++;
+        }
     }
     return result;
 }
 
+int16_t radio_transmit_flags(uint8_t* data, size_t len, uint8_t flags) {
+#ifdef ENABLE_RADIO_TASK
+    return radio_task_submit_tx(data, len, flags) ? RADIOLIB_ERR_NONE : RADIO_ERR_TX_QUEUE_FULL;
+#else
+    return radio_transmit_now(data, len, flags);
+#endif
+}
+
+int16_t radio_transmit(uint8_t* data, size_t len) {
+    return radio_transmit_flags(data, len, 0);
+}
+
+uint32_t radio_tx_forwarded(void) {
+    return tx_forwarded;
+}
+
 int16_t radio_start_receive(void) {
-    return get_radio()->startReceive();
+#ifdef ENABLE_RADIO_TASK
+    /* The radio task returns the chip to RX after every TX */
+    return RADIOLIB_ERR_NONE;
+#else
+    int16_t state = get_radio()->startReceive();
+    radio_in_rx_mode = (state == RADIOLIB_ERR_NONE);
+    return state;
+#endif
+}
+
+/*
+ * Channel Activity Detection for listen-before-talk
+ * scanChannel() blocks for a few symbol times and leaves the chip in
+ * standby, so RX is restarted afterwards. The CAD-done IRQ shares the DIO
+ * line with RX-done, so the flag it raises is cleared again.
+ */
+int radio_scan_channel(void) {
+    /* A received frame is still waiting to be read - treat as busy */
+    if (radio_interrupt_flag) {
+        return LBT_CHANNEL_BUSY;
+    }
+
+    int16_t state = get_radio()->scanChannel();
+    radio_interrupt_flag = false;
+    radio_in_rx_mode = (get_radio()->startReceive() == RADIOLIB_ERR_NONE);
+
+    if (state == RADIOLIB_LORA_DETECTED) {
+        return LBT_CHANNEL_BUSY;
+    }
+    if (state == RADIOLIB_CHANNEL_FREE) {
+        return LBT_CHANNEL_FREE;
+    }
+    debug_printf(1, "WARN: scanChannel returned %d", state);
+    return -1;
 }
 
 // mesh_increment_tx/rx moved to core/mesh_accessor.c
@@ -4,27 +4,23 @@
 
 #include "radio_hal.h"
 #include "utils/debug.h"
+#include "utils/arena.h"
 #include "hardware/board.h"
 #include <Arduino.h>
 
 extern const struct board_config* board;
 
-int radio_hal_init(struct radio_instance* radio_inst, const struct radio_pins* pins, SPIClass* spi,
-                   const struct radio_config* config, enum radio_type type) {
+/*
+ * Bring an already-created chip object up with the given config.
+ * begin() hardware-resets the chip, so this is also the recovery path.
+ */
+static int radio_hal_begin(struct radio_instance* radio_inst, const struct radio_config* config) {
     int state = RADIOLIB_ERR_UNKNOWN;
-    radio_inst->type = type;
-
-    /* Create Module with correct DIO pin mapping for radio type */
-    Module* mod;
 
-    /* Initialize based on radio chip type */
-    switch (type) {
+    switch (radio_inst->type) {
         case RADIO_SX1262:
         case RADIO_SX1268: {
-            /* SX126x: cs, dio1 (interrupt), reset, busy */
-            mod = new Module(pins->cs, pins->dio1, pins->reset, pins->busy, *spi);
-            SX1262* sx1262 = new SX1262(mod);
-            radio_inst->sx1262 = sx1262;
+            SX1262* sx1262 = radio_inst->sx1262;
 
             DEBUG_INFOF("SX1262 init (TCXO=%.1f, DIO2_RF_SW=%s, sync=0x%02X)...", config->tcxo_voltage,
                         config->dio2_as_rf_switch ? "true" : "false",
@@ -62,11 +58,7 @@ int radio_hal_init(struct radio_instance* radio_inst, const struct radio_pins* p
 
         case RADIO_SX1276:
         case RADIO_SX1278: {
-            /* SX127x: cs, dio0 (interrupt), reset, dio1 */
-            DEBUG_INFOF("SX1276 pins: CS=%d DIO0=%d RST=%d DIO1=%d", pins->cs, pins->dio0, pins->reset, pins->dio1);
-            mod = new Module(pins->cs, pins->dio0, pins->reset, pins->dio1, *spi);
-            SX1276* sx1276 = new SX1276(mod);
-            radio_inst->sx1276 = sx1276;
+            SX1276* sx1276 = radio_inst->sx1276;
 
             DEBUG_INFOF("SX1276 init (sync=0x%02X)...",
                         config->sync_word ? config->sync_word : RADIOLIB_SX127X_SYNC_WORD);
@@ -101,3 +93,41 @@ int radio_hal_init(struct radio_instance* radio_inst, const struct radio_pins* p
     DEBUG_INFO("Radio init OK");
     return 0;
 }
+
+int radio_hal_init(struct radio_instance* radio_inst, const struct radio_pins* pins, SPIClass* spi,
+                   const struct radio_config* config, enum radio_type type) {
+    radio_inst->type = type;
+
+    /* Create Module with correct DIO pin mapping for radio type */
+    Module* mod;
+
+    switch (type) {
+        case RADIO_SX1262:
+        case RADIO_SX1268:
+            /* SX126x: cs, dio1 (interrupt), reset, busy */
+            mod = arena_new<Module>(ARENA_HOT, "radio_module", pins->cs, pins->dio1, pins->reset, pins->busy, *spi);
+            radio_inst->sx1262 = arena_new<SX1262>(ARENA_HOT, "radio_sx126x", mod);
+            break;
+
+        case RADIO_SX1276:
+        case RADIO_SX1278:
+            /* SX127x: cs, dio0 (interrupt), reset, dio1 */
+            DEBUG_INFOF("SX1276 pins: CS=%d DIO0=%d RST=%d DIO1=%d", pins->cs, pins->dio0, pins->reset, pins->dio1);
+            mod = arena_new<Module>(ARENA_HOT, "radio_module", pins->cs, pins->dio0, pins->reset, pins->dio1, *spi);
+            radio_inst->sx1276 = arena_new<SX1276>(ARENA_HOT, "radio_sx127x", mod);
+            break;
+
+        default:
+            DEBUG_INFO("Unsupported radio type!");
+            return -1;
+    }
+
+    return radio_hal_begin(radio_inst, config);
+}
+
+int radio_hal_reinit(struct radio_instance* radio_inst, const struct radio_config* config) {
+    if (!radio_inst->as_phy()) {
+        return -1;
+    }
+    return radio_hal_begin(radio_inst, config);
+}
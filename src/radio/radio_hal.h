@@ -9,8 +9,45 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "hardware/board.h"
 
+/* radio_transmit() result when the regional duty-cycle budget is exhausted */
+#define RADIO_ERR_DUTY_CYCLE (-1000)
+
+/* radio_transmit() result when the radio task's TX ring is full */
+#define RADIO_ERR_TX_QUEUE_FULL (-1001)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* radio_transmit_flags() frame flags */
+#define RADIO_TX_FORWARD 0x01 /* Relayed for another node - counted as a forward once sent */
+
+/**
+ * Send a frame - the single TX entry point (duty cycle + accounting)
+ * With ENABLE_RADIO_TASK the frame is queued to the radio task and the
+ * call returns immediately; a 0 result then only means "queued".
+ * mesh.packets_tx is counted by radio_transmit_now() once the frame is
+ * actually on air, so callers must not count it themselves.
+ */
+int16_t radio_transmit(uint8_t* data, size_t len);
+int16_t radio_transmit_flags(uint8_t* data, size_t len, uint8_t flags);
+
+/* Blocking transmit on the caller's thread (radio task / non-task builds) */
+int16_t radio_transmit_now(uint8_t* data, size_t len, uint8_t flags);
+
+/* RADIO_TX_FORWARD frames that made it on air */
+uint32_t radio_tx_forwarded(void);
+
+/* Return the radio to receive after TX (no-op when the radio task owns it) */
+int16_t radio_start_receive(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #ifdef __cplusplus
 
 #    include <RadioLib.h>
@@ -72,11 +109,21 @@ struct radio_instance {
 int radio_hal_init(struct radio_instance* radio, const struct radio_pins* pins, SPIClass* spi,
                    const struct radio_config* config, enum radio_type type);
 
+/**
+ * Re-run begin() on the existing chip object (hardware reset + full config)
+ * Returns: 0 on success, -1 on failure
+ */
+int radio_hal_reinit(struct radio_instance* radio, const struct radio_config* config);
+
 /**
  * Radio parameter setters - chip-agnostic wrappers
  * Implemented in radio_api.cpp
  */
 PhysicalLayer* get_radio();
+uint32_t radio_airtime_ms(size_t len);
+void radio_build_config(struct radio_config* out);
+bool radio_probe_status(void);
+int radio_recover(void);
 int radio_set_frequency(float freq);
 int radio_set_bandwidth(float bw);
 int radio_set_spreading_factor(uint8_t sf);
@@ -0,0 +1,157 @@
+/**
+ * Radio health monitor - stuck-receiver detection
+ *
+ * Pure C, no Arduino dependencies: time is passed in by the caller.
+ */
+
+#include "radio_health.h"
+
+static uint32_t last_rx_ms = 0;   /* Last RX interrupt (or init / recovery) */
+static uint32_t rx_count = 0;     /* RX interrupts since init */
+static uint32_t gap_avg_ms = 0;   /* EWMA of the gap between RX interrupts */
+static uint8_t rx_fail_streak = 0;
+static bool probe_failed = false;
+static uint32_t last_probe_ms = 0;
+static uint32_t retry_until_ms = 0;
+static bool retry_wait = false;
+static uint8_t pending_reason = RADIO_HEALTH_REASON_NONE;
+static struct radio_health_stats stats;
+
+void radio_health_init(uint32_t now)
+{
+    last_rx_ms = now;
+    last_probe_ms = now;
+    rx_count = 0;
+    gap_avg_ms = 0;
+    rx_fail_streak = 0;
+    probe_failed = false;
+    retry_wait = false;
+    pending_reason = RADIO_HEALTH_REASON_NONE;
+}
+
+void radio_health_note_rx(uint32_t now)
+{
+    uint32_t gap = now - last_rx_ms;
+
+    if (rx_count > 0) {
+        /* First gap seeds the average, then EWMA with alpha = 1/8 */
+        if (gap_avg_ms == 0) {
+            gap_avg_ms = gap ? gap : 1;
+        } else {
+            gap_avg_ms = (uint32_t)((int32_t)gap_avg_ms + ((int32_t)gap - (int32_t)gap_avg_ms) / 8);
+        }
+    }
+
+    rx_count++;
+    last_rx_ms = now;
+}
+
+void radio_health_note_rx_start(bool ok)
+{
+    if (ok) {
+        rx_fail_streak = 0;
+    } else if (rx_fail_streak < 0xFF) {
+        rx_fail_streak++;
+    }
+}
+
+uint32_t radio_health_silence_limit_ms(void)
+{
+    /* No history yet - only the hard limit applies */
+    if (rx_count < 2 || gap_avg_ms == 0) {
+        return RADIO_HEALTH_MAX_SILENCE_MS;
+    }
+
+    uint32_t limit = RADIO_HEALTH_MAX_SILENCE_MS;
+    if (gap_avg_ms < RADIO_HEALTH_MAX_SILENCE_MS / RADIO_HEALTH_SILENCE_FACTOR) {
+        limit = gap_avg_ms * RADIO_HEALTH_SILENCE_FACTOR;
+    }
+    if (limit < RADIO_HEALTH_MIN_SILENCE_MS) {
+        limit = RADIO_HEALTH_MIN_SILENCE_MS;
+    }
+    return limit;
+}
+
+uint32_t radio_health_silence_ms(uint32_t now)
+{
+    return now - last_rx_ms;
+}
+
+enum radio_health_action radio_health_poll(uint32_t now)
+{
+    if (retry_wait) {
+        if ((int32_t)(now - retry_until_ms) < 0) {
+            return RADIO_HEALTH_OK;
+        }
+        retry_wait = false;
+    }
+
+    if (rx_fail_streak >= RADIO_HEALTH_RX_FAIL_LIMIT) {
+        pending_reason = RADIO_HEALTH_REASON_RX_START;
+        return RADIO_HEALTH_RECOVER;
+    }
+
+    if (probe_failed) {
+        pending_reason = RADIO_HEALTH_REASON_CHIP_STATUS;
+        return RADIO_HEALTH_RECOVER;
+    }
+
+    if (radio_health_silence_ms(now) > radio_health_silence_limit_ms()) {
+        pending_reason = RADIO_HEALTH_REASON_SILENCE;
+        return RADIO_HEALTH_RECOVER;
+    }
+
+    if (now - last_probe_ms >= RADIO_HEALTH_PROBE_MS) {
+        last_probe_ms = now;
+        return RADIO_HEALTH_PROBE;
+    }
+
+    return RADIO_HEALTH_OK;
+}
+
+void radio_health_probe_result(bool ok)
+{
+    stats.probes++;
+    if (!ok) {
+        stats.probe_failures++;
+        probe_failed = true;
+    }
+}
+
+void radio_health_recovered(bool ok, uint32_t now)
+{
+    if (ok) {
+        stats.recoveries++;
+    } else {
+        stats.recovery_failures++;
+        retry_until_ms = now + RADIO_HEALTH_RETRY_MS;
+        retry_wait = true;
+    }
+    stats.last_reason = pending_reason;
+
+    /* Restart every clock - the channel history (gap average) is kept */
+    last_rx_ms = now;
+    last_probe_ms = now;
+    rx_fail_streak = 0;
+    probe_failed = false;
+    pending_reason = RADIO_HEALTH_REASON_NONE;
+}
+
+const char *radio_health_reason_name(uint8_t reason)
+{
+    switch (reason) {
+        case RADIO_HEALTH_REASON_SILENCE:
+            return "silence";
+        case RADIO_HEALTH_REASON_RX_START:
+            return "rx_start";
+        case RADIO_HEALTH_REASON_CHIP_STATUS:
+            return "chip_status";
+        default:
+            return "none";
+    }
+}
+
+const struct radio_health_stats *radio_health_get_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,81 @@
+/**
+ * Radio health monitor - stuck-receiver detection
+ *
+ * A radio that stops raising RX interrupts looks perfectly healthy from
+ * the outside: TX still works and the firmware keeps running. Three
+ * signals are tracked here:
+ *   - silence: time since the last RX interrupt against the channel's
+ *     own history (mean gap between frames, EWMA)
+ *   - startReceive() failures in a row
+ *   - a periodic chip status probe (registers read back over SPI)
+ * Any of them asks the caller to re-initialize the chip with the saved
+ * config. Pure decision logic - the caller owns the radio and the clock.
+ */
+
+#ifndef MESHGRID_RADIO_HEALTH_H
+#define MESHGRID_RADIO_HEALTH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RADIO_HEALTH_PROBE_MS 30000          /* Chip status probe interval */
+#define RADIO_HEALTH_MIN_SILENCE_MS 600000   /* Never declare deaf sooner than 10 min */
+#define RADIO_HEALTH_MAX_SILENCE_MS 3600000  /* Recover after 1 h of silence regardless */
+#define RADIO_HEALTH_SILENCE_FACTOR 8        /* Silence limit = factor x mean RX gap */
+#define RADIO_HEALTH_RX_FAIL_LIMIT 5         /* Consecutive startReceive() failures */
+#define RADIO_HEALTH_RETRY_MS 60000          /* Wait after a failed recovery */
+
+enum radio_health_action {
+    RADIO_HEALTH_OK = 0,
+    RADIO_HEALTH_PROBE,   /* Read the chip status, report with radio_health_probe_result() */
+    RADIO_HEALTH_RECOVER, /* Re-initialize, report with radio_health_recovered() */
+};
+
+enum radio_health_reason {
+    RADIO_HEALTH_REASON_NONE = 0,
+    RADIO_HEALTH_REASON_SILENCE,
+    RADIO_HEALTH_REASON_RX_START,
+    RADIO_HEALTH_REASON_CHIP_STATUS,
+};
+
+struct radio_health_stats {
+    uint32_t recoveries;        /* Successful re-initializations */
+    uint32_t recovery_failures; /* Re-initializations that failed */
+    uint32_t probes;
+    uint32_t probe_failures;
+    uint8_t last_reason;        /* enum radio_health_reason of the last recovery */
+};
+
+void radio_health_init(uint32_t now);
+
+/* An RX interrupt was serviced */
+void radio_health_note_rx(uint32_t now);
+
+/* Result of a startReceive() call */
+void radio_health_note_rx_start(bool ok);
+
+/* What the caller should do now */
+enum radio_health_action radio_health_poll(uint32_t now);
+
+void radio_health_probe_result(bool ok);
+void radio_health_recovered(bool ok, uint32_t now);
+
+/* Current silence limit derived from the channel history (ms) */
+uint32_t radio_health_silence_limit_ms(void);
+
+/* Time since the last RX interrupt (ms) */
+uint32_t radio_health_silence_ms(uint32_t now);
+
+const char *radio_health_reason_name(uint8_t reason);
+
+const struct radio_health_stats *radio_health_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_RADIO_HEALTH_H */
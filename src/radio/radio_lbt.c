@@ -0,0 +1,101 @@
+/**
+ * Listen-before-talk - CAD gating for every transmission
+ *
+ * Pure C, no Arduino dependencies: time is passed in by the caller and the
+ * channel sense is a hook.
+ */
+
+#include "radio_lbt.h"
+#include <stddef.h>
+
+static lbt_cad_fn lbt_cad = NULL;
+static uint32_t lbt_rng = 0x2545F491;
+static struct lbt_stats stats;
+
+/* xorshift32 - cheap, deterministic for a given seed */
+static uint32_t lbt_random(void)
+{
+    uint32_t x = lbt_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    lbt_rng = x;
+    return x;
+}
+
+void lbt_init(lbt_cad_fn cad, uint32_t seed)
+{
+    lbt_cad = cad;
+    if (seed != 0) {
+        lbt_rng = seed;
+    }
+}
+
+void lbt_session_reset(struct lbt_session *s)
+{
+    s->start_ms = 0;
+    s->attempts = 0;
+    s->active = false;
+}
+
+uint32_t lbt_backoff_ms(uint8_t attempt)
+{
+    uint8_t be = attempt < LBT_MAX_BE ? attempt : LBT_MAX_BE;
+    uint32_t window = (uint32_t)LBT_SLOT_MS << be;
+
+    /* At least one slot so the busy transmission has a chance to end */
+    return LBT_SLOT_MS + (lbt_random() % window);
+}
+
+static void lbt_record_access(struct lbt_session *s, uint32_t now_ms)
+{
+    stats.access_count++;
+    stats.access_delay_ms += now_ms - s->start_ms;
+    s->active = false;
+}
+
+uint32_t lbt_acquire(struct lbt_session *s, uint32_t now_ms)
+{
+    if (!s->active) {
+        s->start_ms = now_ms;
+        s->attempts = 0;
+        s->active = true;
+    }
+
+    if (lbt_cad == NULL) {
+        lbt_record_access(s, now_ms);
+        return 0;
+    }
+
+    int state = lbt_cad();
+
+    if (state == LBT_CHANNEL_BUSY) {
+        stats.cad_busy++;
+        s->attempts++;
+        if (s->attempts <= LBT_MAX_RETRIES) {
+            return lbt_backoff_ms(s->attempts);
+        }
+        /* Bounded: give up waiting and transmit */
+        stats.forced++;
+    } else if (state < 0) {
+        stats.cad_error++;
+    } else {
+        stats.cad_free++;
+    }
+
+    lbt_record_access(s, now_ms);
+    return 0;
+}
+
+const struct lbt_stats *lbt_get_stats(void)
+{
+    return &stats;
+}
+
+uint32_t lbt_mean_access_delay_ms(void)
+{
+    if (stats.access_count == 0) {
+        return 0;
+    }
+    return stats.access_delay_ms / stats.access_count;
+}
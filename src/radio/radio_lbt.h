@@ -0,0 +1,85 @@
+/**
+ * Listen-before-talk - CAD gating for every transmission
+ *
+ * Before a frame goes on air the channel is sensed with Channel Activity
+ * Detection. A busy channel defers the frame by a randomized exponential
+ * backoff (slot << attempt, uniformly drawn), up to LBT_MAX_RETRIES busy
+ * results; after that the frame is sent anyway so a stuck CAD cannot
+ * block the node forever.
+ *
+ * The channel sense is a hook so the same backoff logic can run against
+ * real hardware (radio_scan_channel) or a modelled channel on a host.
+ */
+
+#ifndef MESHGRID_RADIO_LBT_H
+#define MESHGRID_RADIO_LBT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LBT_SLOT_MS 20     /* Backoff slot, roughly one CAD + turnaround */
+#define LBT_MAX_BE 6       /* Cap on backoff exponent (window <= 1.28 s) */
+#define LBT_MAX_RETRIES 5  /* Busy results tolerated before forcing TX */
+
+/* Channel sense result */
+#define LBT_CHANNEL_FREE 0
+#define LBT_CHANNEL_BUSY 1
+
+/*
+ * Channel sense hook
+ * Returns LBT_CHANNEL_FREE, LBT_CHANNEL_BUSY or a negative error
+ * (errors count separately and are treated as free).
+ */
+typedef int (*lbt_cad_fn)(void);
+
+/* Per-frame access attempt */
+struct lbt_session {
+    uint32_t start_ms; /* First time the frame was ready to send */
+    uint8_t attempts;  /* Busy results so far */
+    bool active;
+};
+
+/* Counters (reported via /stats) */
+struct lbt_stats {
+    uint32_t cad_free;
+    uint32_t cad_busy;
+    uint32_t cad_error;
+    uint32_t forced;           /* Sent after LBT_MAX_RETRIES busy results */
+    uint32_t access_count;     /* Frames that got channel access */
+    uint32_t access_delay_ms;  /* Sum of ready -> access delays */
+};
+
+/*
+ * Install the channel sense hook and seed the backoff PRNG
+ * A NULL hook disables LBT (every access is immediate).
+ */
+void lbt_init(lbt_cad_fn cad, uint32_t seed);
+
+/* Reset a session (e.g. when a queue slot is reused) */
+void lbt_session_reset(struct lbt_session *s);
+
+/*
+ * Try to acquire the channel for one frame
+ * Returns 0 if the caller may transmit now, otherwise the backoff in ms
+ * after which the caller should call again with the same session.
+ */
+uint32_t lbt_acquire(struct lbt_session *s, uint32_t now_ms);
+
+/* Randomized exponential backoff for the given busy attempt (1-based) */
+uint32_t lbt_backoff_ms(uint8_t attempt);
+
+const struct lbt_stats *lbt_get_stats(void);
+uint32_t lbt_mean_access_delay_ms(void);
+
+/* Hardware CAD via RadioLib scanChannel() - implemented in radio_api.cpp */
+int radio_scan_channel(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_RADIO_LBT_H */
@@ -12,25 +12,29 @@ extern "C" {
 }
 
 #include "radio/radio_hal.h"
+#include "radio/rx_fifo.h"
+#include "radio/radio_health.h"
 #include "core/messaging.h"
 
 /* External state from main.cpp */
 extern bool radio_ok;
 extern volatile bool radio_interrupt_flag;
 extern volatile uint32_t isr_trigger_count;
+extern volatile uint32_t radio_isr_time_us;
 extern bool radio_in_rx_mode;
 
-void radio_loop_process(void) {
+void radio_rx_service_chip(void) {
     if (!radio_ok) {
         return;
     }
 
-    /* Handle received packet if interrupt fired */
+    /* Move a received frame out of the chip if interrupt fired */
     if (radio_interrupt_flag) {
+        uint32_t rx_time_us = radio_isr_time_us;
         radio_interrupt_flag = false; /* Reset flag */
         radio_in_rx_mode = false;     /* No longer in RX after interrupt */
+        radio_health_note_rx(millis());
 
-        uint8_t rx_buf[MESHGRID_MAX_PACKET_SIZE];
         int len = get_radio()->getPacketLength();
 
         if (len > 0 && len <= MESHGRID_MAX_PACKET_SIZE) {
@@ -39,11 +43,18 @@ void radio_loop_process(void) {
                 len = 1 + 4 + 1 + MESHGRID_MAX_PATH_SIZE + MESHGRID_MAX_PAYLOAD_SIZE;
             }
 
-            int state = get_radio()->readData(rx_buf, len);
-            if (state == RADIOLIB_ERR_NONE) {
-                int16_t rssi = get_radio()->getRSSI();
-                int8_t snr = get_radio()->getSNR();
-                process_packet(rx_buf, len, rssi, snr);
+            /* FIFO full: still read the frame so the chip can go back to RX */
+            static uint8_t discard_buf[MESHGRID_MAX_PACKET_SIZE];
+            struct rx_frame* frame = rx_fifo_reserve();
+            uint8_t* dest = frame ? frame->buf : discard_buf;
+
+            int state = get_radio()->readData(dest, len);
+            if (state == RADIOLIB_ERR_NONE && frame) {
+                frame->len = len;
+                frame->rssi = get_radio()->getRSSI();
+                frame->snr = get_radio()->getSNR();
+                frame->rx_time_us = rx_time_us;
+                rx_fifo_commit();
             }
         }
     }
@@ -51,6 +62,7 @@ void radio_loop_process(void) {
     /* Ensure radio is in RX mode - only call if not already in RX (MeshCore pattern) */
     if (!radio_in_rx_mode) {
         int state = get_radio()->startReceive();
+        radio_health_note_rx_start(state == RADIOLIB_ERR_NONE);
         if (state == RADIOLIB_ERR_NONE) {
             radio_in_rx_mode = true;
             static uint32_t last_ok_log = 0;
@@ -67,3 +79,68 @@ void radio_loop_process(void) {
         }
     }
 }
+
+void radio_rx_service(void) {
+#ifndef ENABLE_RADIO_TASK
+    radio_rx_service_chip();
+#endif
+}
+
+void radio_health_service(void) {
+    uint32_t now = millis();
+
+    switch (radio_health_poll(now)) {
+        case RADIO_HEALTH_PROBE:
+            if (!radio_probe_status()) {
+                DEBUG_WARN("[RX] Chip status probe failed");
+                radio_health_probe_result(false);
+            } else {
+                radio_health_probe_result(true);
+            }
+            break;
+
+        case RADIO_HEALTH_RECOVER: {
+            DEBUG_WARNF("[RX] Radio unhealthy (silent %lu s, limit %lu s) - reinitializing",
+                        (unsigned long)(radio_health_silence_ms(now) / 1000),
+                        (unsigned long)(radio_health_silence_limit_ms() / 1000));
+            bool ok = (radio_recover() == 0);
+            radio_health_recovered(ok, millis());
+            const struct radio_health_stats* health = radio_health_get_stats();
+            if (ok) {
+                DEBUG_INFOF("[RX] Radio recovered (%s), recoveries=%lu", radio_health_reason_name(health->last_reason),
+                            (unsigned long)health->recoveries);
+            } else {
+                DEBUG_ERRORF("[RX] Radio recovery failed (%s), retry in %d s",
+                             radio_health_reason_name(health->last_reason), RADIO_HEALTH_RETRY_MS / 1000);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void radio_loop_process(void) {
+    if (!radio_ok) {
+        return;
+    }
+
+    radio_rx_service();
+#ifndef ENABLE_RADIO_TASK
+    radio_health_service();
+#endif
+
+    /* Drain what is queued now; frames arriving meanwhile wait for the next pass */
+    for (uint8_t n = rx_fifo_count(); n > 0; n--) {
+        struct rx_frame* frame = rx_fifo_peek();
+        if (!frame) {
+            break;
+        }
+        process_packet(frame->buf, frame->len, frame->rssi, frame->snr, frame->rx_time_us);
+        rx_fifo_release();
+
+        /* Processing can block (TX of a reply) - keep the chip serviced */
+        radio_rx_service();
+    }
+}
@@ -5,14 +5,37 @@
 #ifndef MESHGRID_RADIO_LOOP_H
 #define MESHGRID_RADIO_LOOP_H
 
+/**
+ * Service the radio chip: move a received frame into the RX FIFO
+ * and ensure the radio is back in receive mode
+ *
+ * Cheap - call it from anywhere the main loop may stall
+ * (before/after TX, display flushes, serial handling).
+ * No-op when the radio task owns the chip (ENABLE_RADIO_TASK).
+ */
+void radio_rx_service(void);
+
+/**
+ * Unconditional chip servicing - used by the radio task
+ */
+void radio_rx_service_chip(void);
+
+/**
+ * Stuck-receiver watchdog - probe the chip and re-initialize it when it
+ * went deaf (radio_health.h). Called from radio_loop_process(), or from
+ * the radio task when it owns the chip.
+ */
+void radio_health_service(void);
+
 /**
  * Process radio RX and ensure radio is in receive mode
  * Should be called every loop iteration
  *
  * Implements MeshCore's RX pattern:
  * - Check for interrupt flag
- * - Read packet if available
+ * - Read packet if available (into the RX FIFO)
  * - Ensure radio returns to RX mode
+ * - Drain the RX FIFO through process_packet()
  */
 void radio_loop_process(void);
 
@@ -0,0 +1,200 @@
+/**
+ * Radio task - dedicated FreeRTOS task that owns the radio (optional)
+ */
+
+#ifdef ENABLE_RADIO_TASK
+
+#    include "radio_task.h"
+#    include "radio_hal.h"
+#    include "radio_loop.h"
+#    include "utils/debug.h"
+#    include <Arduino.h>
+#    include <freertos/FreeRTOS.h>
+#    include <freertos/task.h>
+#    include <freertos/semphr.h>
+
+extern "C" {
+#    include "network/protocol.h"
+#    include "radio/radio_lbt.h"
+#    include "radio/rx_fifo.h"
+#    include "utils/spsc.h"
+}
+
+/* External state from main.cpp */
+extern volatile uint32_t radio_isr_time_us;
+extern bool radio_in_rx_mode;
+
+#    if (RADIO_TX_RING_SIZE & (RADIO_TX_RING_SIZE - 1)) != 0
+#        error "RADIO_TX_RING_SIZE must be a power of 2"
+#    endif
+
+struct tx_slot {
+    uint8_t buf[MESHGRID_MAX_PACKET_SIZE];
+    uint16_t len;
+    uint8_t flags; /* RADIO_TX_* */
+};
+
+static struct tx_slot tx_ring[RADIO_TX_RING_SIZE];
+static struct spsc_index tx_queue; /* Producer: loop(), consumer: radio task */
+static struct lbt_session tx_lbt;
+static uint32_t tx_next_try = 0;
+
+static TaskHandle_t radio_task_handle = nullptr;
+static SemaphoreHandle_t radio_mutex = nullptr;
+static struct radio_task_stats stats;
+
+/* ========================================================================= */
+/* Locking                                                                   */
+/* ========================================================================= */
+
+void radio_lock(void) {
+    if (radio_mutex) {
+        xSemaphoreTakeRecursive(radio_mutex, portMAX_DELAY);
+    }
+}
+
+void radio_unlock(void) {
+    if (radio_mutex) {
+        xSemaphoreGiveRecursive(radio_mutex);
+    }
+}
+
+/* ========================================================================= */
+/* Application side                                                          */
+/* ========================================================================= */
+
+bool radio_task_submit_tx(const uint8_t* data, size_t len, uint8_t flags) {
+    if (len == 0 || len > MESHGRID_MAX_PACKET_SIZE) {
+        return false;
+    }
+
+    int32_t slot = spsc_reserve(&tx_queue, RADIO_TX_RING_SIZE);
+    if (slot < 0) {
+        stats.tx_ring_full++;
+        return false;
+    }
+
+    memcpy(tx_ring[slot].buf, data, len);
+    tx_ring[slot].len = len;
+    tx_ring[slot].flags = flags;
+    spsc_publish(&tx_queue);
+    stats.tx_submitted++;
+
+    if (radio_task_handle) {
+        xTaskNotifyGive(radio_task_handle);
+    }
+    return true;
+}
+
+uint32_t radio_task_queued_airtime_ms(void) {
+    uint32_t total = 0;
+    uint32_t tail = tx_queue.tail;
+    uint32_t count = spsc_count(&tx_queue);
+    for (uint32_t i = 0; i < count; i++) {
+        total += radio_airtime_ms(tx_ring[(tail + i) & (RADIO_TX_RING_SIZE - 1)].len);
+    }
+    return total;
+}
+
+void IRAM_ATTR radio_task_notify_from_isr(void) {
+    if (radio_task_handle) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(radio_task_handle, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+const struct radio_task_stats* radio_task_get_stats(void) {
+    return &stats;
+}
+
+/* ========================================================================= */
+/* Radio task                                                                */
+/* ========================================================================= */
+
+/* Move a received frame into the RX FIFO and track IRQ -> FIFO latency */
+static void service_rx(void) {
+    uint32_t frames_before = rx_fifo_get_stats()->frames;
+    uint32_t irq_time = radio_isr_time_us;
+
+    radio_rx_service_chip();
+
+    if (rx_fifo_get_stats()->frames != frames_before) {
+        uint32_t turnaround = micros() - irq_time;
+        if (turnaround > stats.max_turnaround_us) {
+            stats.max_turnaround_us = turnaround;
+        }
+    }
+}
+
+/* Transmit the oldest queued frame once the channel is clear */
+static void service_tx(void) {
+    int32_t slot = spsc_peek(&tx_queue, RADIO_TX_RING_SIZE);
+    if (slot < 0) {
+        return;
+    }
+
+    uint32_t now = millis();
+    if ((int32_t)(now - tx_next_try) < 0) {
+        return; /* Still backing off */
+    }
+
+    uint32_t backoff = lbt_acquire(&tx_lbt, now);
+    if (backoff > 0) {
+        tx_next_try = now + backoff;
+        return;
+    }
+
+    /* Counts mesh.packets_tx itself once the frame is on air */
+    int16_t result = radio_transmit_now(tx_ring[slot].buf, tx_ring[slot].len, tx_ring[slot].flags);
+    radio_in_rx_mode = (get_radio()->startReceive() == RADIOLIB_ERR_NONE);
+
+    if (result == RADIOLIB_ERR_NONE) {
+        stats.tx_done++;
+    } else if (result == RADIO_ERR_DUTY_CYCLE) {
+        stats.tx_refused++;
+    } else {
+        stats.tx_failed++;
+    }
+    spsc_consume(&tx_queue);
+}
+
+static void radio_task(void* arg) {
+    (void)arg;
+
+    for (;;) {
+        /* Sleep until the ISR or a TX submission wakes us (or poll timeout) */
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RADIO_TASK_IDLE_MS));
+        stats.wakeups++;
+
+        radio_lock();
+        service_rx();
+        service_tx();
+        radio_health_service();
+        radio_unlock();
+    }
+}
+
+int radio_task_start(void) {
+    radio_mutex = xSemaphoreCreateRecursiveMutex();
+    if (!radio_mutex) {
+        DEBUG_ERROR("Radio task: mutex allocation failed");
+        return -1;
+    }
+
+    lbt_session_reset(&tx_lbt);
+
+    BaseType_t ok = xTaskCreatePinnedToCore(radio_task, "radio", RADIO_TASK_STACK, nullptr, RADIO_TASK_PRIORITY,
+                                            &radio_task_handle, RADIO_TASK_CORE);
+    if (ok != pdPASS) {
+        DEBUG_ERROR("Radio task: create failed");
+        return -1;
+    }
+
+    DEBUG_INFOF("Radio task started on core %d", RADIO_TASK_CORE);
+    return 0;
+}
+
+#endif /* ENABLE_RADIO_TASK */
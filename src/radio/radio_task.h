@@ -0,0 +1,79 @@
+/**
+ * Radio task - dedicated FreeRTOS task that owns the radio (optional)
+ *
+ * Build with -DENABLE_RADIO_TASK (ESP32 family only). The task is pinned
+ * to RADIO_TASK_CORE, away from loop(), and is the only code that talks to
+ * the chip after boot:
+ *   - RX: woken by the radio ISR, moves frames into the RX FIFO
+ *   - TX: drains the TX ring, runs listen-before-talk and the duty-cycle
+ *     check, transmits and returns the chip to receive
+ * loop() only pushes frames into the TX ring and drains the RX FIFO, so
+ * radio turnaround no longer depends on display, NVS or JSON work.
+ *
+ * Both rings are SPSC (utils/spsc.h). Radio parameter changes from the
+ * command handlers take radio_lock() so they never race the task on SPI.
+ */
+
+#ifndef MESHGRID_RADIO_TASK_H
+#define MESHGRID_RADIO_TASK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ENABLE_RADIO_TASK
+
+#    if !(defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6))
+#        error "ENABLE_RADIO_TASK requires an ESP32 family target"
+#    endif
+
+#    define RADIO_TASK_CORE 0        /* Arduino loop() runs on core 1 */
+#    define RADIO_TASK_PRIORITY 5    /* Above loop() (1) and BLE host */
+#    define RADIO_TASK_STACK 4096
+#    define RADIO_TASK_IDLE_MS 5     /* Poll interval when no IRQ arrives */
+#    define RADIO_TX_RING_SIZE 8     /* Power of 2 */
+
+struct radio_task_stats {
+    uint32_t tx_submitted;
+    uint32_t tx_ring_full; /* Frames rejected because the TX ring was full */
+    uint32_t tx_done;
+    uint32_t tx_refused; /* Dropped by the duty-cycle budget */
+    uint32_t tx_failed;  /* Chip reported a TX error */
+    uint32_t wakeups;
+    uint32_t max_turnaround_us; /* Longest IRQ -> frame-in-FIFO latency */
+};
+
+/* Start the task (after radio init). Returns 0 on success. */
+int radio_task_start(void);
+
+/* Queue a frame (RADIO_TX_* flags) for transmission. Returns false if the TX ring is full. */
+bool radio_task_submit_tx(const uint8_t* data, size_t len, uint8_t flags);
+
+/* Time on air of the frames queued but not yet transmitted - call under radio_lock() */
+uint32_t radio_task_queued_airtime_ms(void);
+
+/* Wake the task from the radio ISR */
+void radio_task_notify_from_isr(void);
+
+/* Serialize SPI access against the task (recursive) */
+void radio_lock(void);
+void radio_unlock(void);
+
+const struct radio_task_stats* radio_task_get_stats(void);
+
+#else
+
+static inline void radio_lock(void) {}
+static inline void radio_unlock(void) {}
+
+#endif /* ENABLE_RADIO_TASK */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_RADIO_TASK_H */
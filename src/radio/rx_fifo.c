@@ -0,0 +1,54 @@
+/**
+ * RX FIFO - received frames waiting to be processed
+ */
+
+#include "rx_fifo.h"
+#include "utils/spsc.h"
+
+static struct rx_frame frames[RX_FIFO_SIZE];
+static struct spsc_index fifo;
+static struct rx_fifo_stats stats;
+
+uint8_t rx_fifo_count(void)
+{
+    return (uint8_t)spsc_count(&fifo);
+}
+
+struct rx_frame *rx_fifo_reserve(void)
+{
+    int32_t slot = spsc_reserve(&fifo, RX_FIFO_SIZE);
+    if (slot < 0) {
+        stats.overruns++;
+        return NULL;
+    }
+    return &frames[slot];
+}
+
+void rx_fifo_commit(void)
+{
+    spsc_publish(&fifo);
+    stats.frames++;
+
+    uint8_t level = rx_fifo_count();
+    if (level > stats.high_water) {
+        stats.high_water = level;
+    }
+}
+
+struct rx_frame *rx_fifo_peek(void)
+{
+    int32_t slot = spsc_peek(&fifo, RX_FIFO_SIZE);
+    return slot < 0 ? NULL : &frames[slot];
+}
+
+void rx_fifo_release(void)
+{
+    if (spsc_peek(&fifo, RX_FIFO_SIZE) >= 0) {
+        spsc_consume(&fifo);
+    }
+}
+
+const struct rx_fifo_stats *rx_fifo_get_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,62 @@
+/**
+ * RX FIFO - received frames waiting to be processed
+ *
+ * The radio-servicing path (radio_rx_service) copies each frame out of the
+ * chip together with RSSI, SNR and the interrupt timestamp, and restarts
+ * receive immediately. process_packet() drains the FIFO later, so slow
+ * work in the main loop no longer costs frames.
+ *
+ * Single producer / single consumer: the producer only moves head, the
+ * consumer only moves tail.
+ */
+
+#ifndef MESHGRID_RX_FIFO_H
+#define MESHGRID_RX_FIFO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "network/protocol.h"
+#include "utils/memory.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (RX_FIFO_SIZE & (RX_FIFO_SIZE - 1)) != 0
+#    error "RX_FIFO_SIZE must be a power of 2"
+#endif
+
+struct rx_frame {
+    uint8_t buf[MESHGRID_MAX_PACKET_SIZE];
+    uint16_t len;
+    int16_t rssi;
+    int8_t snr;
+    uint32_t rx_time_us; /* micros() captured in the radio ISR */
+};
+
+struct rx_fifo_stats {
+    uint32_t frames;       /* Frames queued */
+    uint32_t overruns;     /* Frames dropped because the FIFO was full */
+    uint8_t high_water;    /* Deepest FIFO level seen */
+};
+
+/*
+ * Producer: slot for the next frame, or NULL if the FIFO is full
+ * (the overrun is counted). Fill it, then call rx_fifo_commit().
+ */
+struct rx_frame *rx_fifo_reserve(void);
+void rx_fifo_commit(void);
+
+/* Consumer: oldest frame or NULL, released with rx_fifo_release() */
+struct rx_frame *rx_fifo_peek(void);
+void rx_fifo_release(void);
+
+uint8_t rx_fifo_count(void);
+
+const struct rx_fifo_stats *rx_fifo_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHGRID_RX_FIFO_H */
@@ -3,16 +3,21 @@
  */
 
 #include "screens.h"
-#include "utils/debug.h"
-#include "utils/ui_lib.h"
-#include "utils/types.h"
-#include "hardware/board.h"
-#include "utils/constants.h"
-#include "core/neighbors.h"
-#include "core/messaging.h"
-#include "core/security.h"
-#include "hardware/telemetry/telemetry.h"
-#include "version.h"
+#include "utils/role.h"
+
+#if MESHGRID_ROLE_UI
+
+#    include "utils/debug.h"
+#    include "utils/ui_lib.h"
+#    include "utils/types.h"
+#    include "hardware/board.h"
+#    include "utils/constants.h"
+#    include "core/neighbors.h"
+#    include "core/messaging.h"
+#    include "core/security.h"
+#    include "core/messaging/inbox.h"
+#    include "hardware/telemetry/telemetry.h"
+#    include "version.h"
 
 /* External references to global state (defined in main.cpp) */
 extern struct meshgrid_state mesh;
@@ -44,12 +49,6 @@ extern uint32_t stat_rooms;
 extern struct meshgrid_neighbor neighbors[];
 extern uint16_t neighbor_count;
 
-/* External references to message buffers */
-extern struct message_entry public_messages[];
-extern int public_msg_count;
-extern struct message_entry direct_messages[];
-extern int direct_msg_count;
-
 /* External functions */
 extern uint32_t get_uptime_secs(void);
 
@@ -237,7 +236,9 @@ void draw_screen_messages(Adafruit_SSD1306* display, struct display_state* state
     char line[32];
 
     /* Count total unread/recent messages */
-    int total_messages = public_msg_count + direct_msg_count;
+    int public_count = inbox_count(INBOX_PUBLIC);
+    int direct_count = inbox_count(INBOX_DIRECT);
+    int total_messages = public_count + direct_count;
     snprintf(line, sizeof(line), "MESSAGES (%d)", total_messages);
     draw_header(display, line);
 
@@ -251,23 +252,21 @@ void draw_screen_messages(Adafruit_SSD1306* display, struct display_state* state
         int displayed = 0;
         int y = UI_CONTENT_TOP;
 
-        /* Display public messages first, then direct messages */
-        for (int i = public_msg_count - 1; i >= 0 && displayed < max_visible; i--) {
+        /* Display public messages first, then direct messages - newest first */
+        for (int i = public_count - 1; i >= 0 && displayed < max_visible; i--) {
             if (displayed < start) {
                 displayed++;
                 continue;
             }
 
-            struct message_entry* msg = &public_messages[i];
-            if (!msg->valid)
-                continue;
+            const struct inbox_msg* msg = inbox_get(INBOX_PUBLIC, i);
 
             /* Line format: [Sender] Message preview... */
             char sender_short[10];
-            ui_truncate_text(sender_short, msg->sender_name, 8);
+            ui_truncate_text(sender_short, inbox_sender(msg), 8);
 
             char text_preview[16];
-            ui_truncate_text(text_preview, msg->text, 15);
+            ui_truncate_text(text_preview, inbox_text(msg), 15);
 
             snprintf(line, sizeof(line), "%s: %s", sender_short, text_preview);
             display->setCursor(0, y);
@@ -286,21 +285,19 @@ void draw_screen_messages(Adafruit_SSD1306* display, struct display_state* state
         }
 
         /* Then direct messages */
-        for (int i = direct_msg_count - 1; i >= 0 && displayed < max_visible; i--) {
+        for (int i = direct_count - 1; i >= 0 && displayed < max_visible; i--) {
             if (displayed < start) {
                 displayed++;
                 continue;
             }
 
-            struct message_entry* msg = &direct_messages[i];
-            if (!msg->valid)
-                continue;
+            const struct inbox_msg* msg = inbox_get(INBOX_DIRECT, i);
 
             char sender_short[10];
-            ui_truncate_text(sender_short, msg->sender_name, 8);
+            ui_truncate_text(sender_short, inbox_sender(msg), 8);
 
             char text_preview[14];
-            ui_truncate_text(text_preview, msg->text, 13);
+            ui_truncate_text(text_preview, inbox_text(msg), 13);
 
             snprintf(line, sizeof(line), "[%s] %s", sender_short, text_preview);
             display->setCursor(0, y);
@@ -534,7 +531,7 @@ void display_scroll_up(struct display_state* state) {
         state->neighbor_scroll--;
         state->dirty = true;
     } else if (state->current_screen == SCREEN_MESSAGES) {
-        int total = public_msg_count + direct_msg_count;
+        int total = inbox_count(INBOX_PUBLIC) + inbox_count(INBOX_DIRECT);
         if (total > 4 && state->message_scroll > 0) {
             state->message_scroll--;
             state->dirty = true;
@@ -552,7 +549,7 @@ void display_scroll_down(struct display_state* state) {
             display_next_screen(state);
         }
     } else if (state->current_screen == SCREEN_MESSAGES) {
-        int total = public_msg_count + direct_msg_count;
+        int total = inbox_count(INBOX_PUBLIC) + inbox_count(INBOX_DIRECT);
         if (total > 4 && state->message_scroll < total - 4) {
             state->message_scroll++;
             state->dirty = true;
@@ -565,3 +562,5 @@ void display_scroll_down(struct display_state* state) {
         display_next_screen(state);
     }
 }
+
+#endif /* MESHGRID_ROLE_UI */
@@ -0,0 +1,121 @@
+/**
+ * Boot arena - bump allocation from two fixed regions
+ *
+ * The SRAM region is a static array; the PSRAM region is claimed from the
+ * SPIRAM heap once in arena_init(). A request that does not fit falls
+ * back to malloc() while booting (counted as spilled) so a region sized
+ * too small costs heap, not a crash - the report shows it.
+ */
+
+#include "arena.h"
+#include "memory.h"
+#include "debug.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
+#    include <esp_heap_caps.h>
+#    include <esp_system.h>
+#    define ARENA_ESP32 1
+#endif
+
+#define ARENA_ALIGN 8
+#define ARENA_TAGS 24 /* Allocations listed in the boot report */
+
+enum arena_place { PLACE_SRAM, PLACE_PSRAM, PLACE_HEAP };
+
+struct arena_region {
+    uint8_t *base;
+    uint32_t size;
+    uint32_t used;
+};
+
+struct arena_tag {
+    const char *tag;
+    uint32_t size;
+    uint8_t place;
+};
+
+static uint8_t sram_buf[ARENA_SRAM_SIZE] __attribute__((aligned(ARENA_ALIGN)));
+static struct arena_region sram = {sram_buf, ARENA_SRAM_SIZE, 0};
+static struct arena_region psram;
+static struct arena_tag tags[ARENA_TAGS];
+static uint8_t tag_count;
+static bool sealed;
+static struct arena_stats stats;
+
+static const char *place_names[] = {"sram", "psram", "heap"};
+
+static void *region_take(struct arena_region *region, size_t size) {
+    uint32_t aligned = (uint32_t)((size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1));
+    if (!region->base || region->size - region->used < aligned) {
+        return NULL;
+    }
+    void *p = region->base + region->used;
+    region->used += aligned;
+    return p;
+}
+
+void arena_init(void) {
+#if defined(ARENA_ESP32)
+    /* NULL without PSRAM - cold requests then share the SRAM region */
+    psram.base = (uint8_t *)heap_caps_malloc(ARENA_COLD_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    psram.size = psram.base ? ARENA_COLD_SIZE : 0;
+#endif
+    psram.used = 0;
+}
+
+void *arena_alloc(enum arena_kind kind, size_t size, const char *tag) {
+    if (sealed) {
+        stats.late++;
+        DEBUG_ERRORF("Arena: %s (%u B) requested after boot", tag, (unsigned)size);
+        return NULL;
+    }
+
+    uint8_t place = PLACE_PSRAM;
+    void *p = kind == ARENA_COLD ? region_take(&psram, size) : NULL;
+    if (!p) {
+        place = PLACE_SRAM;
+        p = region_take(&sram, size);
+    }
+    if (!p) {
+        place = PLACE_HEAP;
+        p = malloc(size);
+        stats.spilled += size;
+        DEBUG_WARNF("Arena: %s (%u B) spilled to heap", tag, (unsigned)size);
+    }
+    if (p) {
+        memset(p, 0, size);
+    }
+
+    if (tag_count < ARENA_TAGS) {
+        tags[tag_count].tag = tag;
+        tags[tag_count].size = (uint32_t)size;
+        tags[tag_count].place = place;
+        tag_count++;
+    }
+    return p;
+}
+
+void arena_seal(void) {
+    sealed = true;
+#if defined(ARENA_ESP32)
+    stats.heap_free_boot = esp_get_free_heap_size();
+#endif
+
+    const struct arena_stats *s = arena_get_stats();
+    DEBUG_INFOF("Arena: sram %lu/%lu B, psram %lu/%lu B, spilled %lu B", (unsigned long)s->sram_used,
+                (unsigned long)s->sram_size, (unsigned long)s->psram_used, (unsigned long)s->psram_size,
+                (unsigned long)s->spilled);
+    for (uint8_t i = 0; i < tag_count; i++) {
+        DEBUG_INFOF("Arena:   %-16s %6lu B  %s", tags[i].tag, (unsigned long)tags[i].size, place_names[tags[i].place]);
+    }
+}
+
+const struct arena_stats *arena_get_stats(void) {
+    stats.sram_used = sram.used;
+    stats.sram_size = sram.size;
+    stats.psram_used = psram.used;
+    stats.psram_size = psram.size;
+    return &stats;
+}
@@ -0,0 +1,66 @@
+/**
+ * Boot arena - long-lived buffers and objects carved from fixed regions
+ *
+ * Everything whose size is known at boot - MeshCore objects, the radio
+ * driver, the message inbox - is allocated here instead of the heap, so
+ * a node that has been up for weeks has the same heap layout as after
+ * boot. Hot data goes to the internal SRAM region; cold bulk data goes
+ * to PSRAM when the board has it. Region sizes are in utils/memory.h.
+ *
+ * Nothing is ever freed. arena_seal() at the end of boot (after the
+ * deferred steps loop() runs) prints the placement report and makes any
+ * later request fail loudly.
+ */
+
+#ifndef MESHGRID_ARENA_H
+#define MESHGRID_ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum arena_kind {
+    ARENA_HOT,  /* Touched per packet - internal SRAM */
+    ARENA_COLD, /* Bulk, touched per message or query - PSRAM if present */
+};
+
+struct arena_stats {
+    uint32_t sram_used;
+    uint32_t sram_size;
+    uint32_t psram_used;
+    uint32_t psram_size;      /* 0 if the board has no PSRAM */
+    uint32_t spilled;         /* Bytes that did not fit and came from the heap at boot */
+    uint32_t late;            /* Requests refused after arena_seal() */
+    uint32_t heap_free_boot;  /* Free heap when sealed (ESP32 only) */
+};
+
+/* Claim the PSRAM region - first thing in setup() */
+void arena_init(void);
+
+/* Zeroed, 8-byte aligned block that lives forever; NULL only after arena_seal() */
+void *arena_alloc(enum arena_kind kind, size_t size, const char *tag);
+
+/* End of boot: report the placement, refuse further requests */
+void arena_seal(void);
+
+const struct arena_stats *arena_get_stats(void);
+
+#ifdef __cplusplus
+}
+
+#    include <new>
+#    include <utility>
+
+/* Construct a T in the arena (never destroyed) */
+template <typename T, typename... Args>
+T *arena_new(enum arena_kind kind, const char *tag, Args &&...args) {
+    void *mem = arena_alloc(kind, sizeof(T), tag);
+    return mem ? new (mem) T(std::forward<Args>(args)...) : nullptr;
+}
+#endif
+
+#endif /* MESHGRID_ARENA_H */
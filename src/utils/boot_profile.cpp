@@ -0,0 +1,25 @@
+/**
+ * Boot profile - when each phase of boot finished
+ */
+
+#include "boot_profile.h"
+#include "debug.h"
+#include <Arduino.h>
+
+static struct boot_phase phases[BOOT_PROFILE_MAX];
+static uint8_t phase_count = 0;
+
+void boot_mark(const char* name) {
+    uint32_t now = millis();
+    if (phase_count < BOOT_PROFILE_MAX) {
+        phases[phase_count].name = name;
+        phases[phase_count].end_ms = now;
+        phase_count++;
+    }
+    DEBUG_INFOF("[Boot] %s done at %lu ms", name, (unsigned long)now);
+}
+
+const struct boot_phase* boot_profile_get(uint8_t* count) {
+    *count = phase_count;
+    return phases;
+}
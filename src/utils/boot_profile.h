@@ -0,0 +1,28 @@
+/**
+ * Boot profile - when each phase of boot finished
+ *
+ * setup() marks the end of each phase, and so do the deferred steps
+ * loop() runs once the radio is listening. INFO reports the list: a slow
+ * boot shows which phase to blame, and the "radio" mark is how long the
+ * node was deaf after reset.
+ */
+
+#ifndef MESHGRID_BOOT_PROFILE_H
+#define MESHGRID_BOOT_PROFILE_H
+
+#include <stdint.h>
+
+#define BOOT_PROFILE_MAX 16
+
+struct boot_phase {
+    const char* name; /* String literal */
+    uint32_t end_ms;  /* millis() when the phase finished */
+};
+
+/* A boot phase just finished (name must be a string literal) */
+void boot_mark(const char* name);
+
+/* Phases marked so far, oldest first; *count set to how many */
+const struct boot_phase* boot_profile_get(uint8_t* count);
+
+#endif /* MESHGRID_BOOT_PROFILE_H */
@@ -20,12 +20,34 @@
 
 #define DISPLAY_REFRESH_INTERVAL_MS 1000
 
+/* ========================================================================= */
+/* Boot Timing                                                               */
+/* ========================================================================= */
+
+#define BOOT_USB_WAIT_MS 1500  /* Native USB: longest wait for the host to open the port */
+#define BOOT_I2C_SETTLE_MS 100 /* OLED power settle time before display init */
+#define BOOT_SPLASH_MS 1500    /* Splash screen held before the first status screen */
+
 /* ========================================================================= */
 /* Telemetry Configuration                                                   */
 /* ========================================================================= */
 
 #define TELEMETRY_READ_INTERVAL_MS 5000
 
+/* ========================================================================= */
+/* Neighbor Persistence                                                      */
+/* ========================================================================= */
+
+#define NEIGHBOR_SAVE_DELAY_MS 30000     /* Quiet time after a change before saving */
+#define NEIGHBOR_SAVE_INTERVAL_MS 300000 /* At most one NVS commit per 5 minutes */
+
+/* ========================================================================= */
+/* Config Persistence                                                        */
+/* ========================================================================= */
+
+#define CONFIG_COMMIT_DELAY_MS 5000      /* Quiet time after a change before committing */
+#define CONFIG_COMMIT_MAX_DELAY_MS 60000 /* Commit anyway once a change is this old */
+
 /* ========================================================================= */
 /* Radio Airtime Management                                                  */
 /* ========================================================================= */
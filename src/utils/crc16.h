@@ -0,0 +1,28 @@
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ * Guards records on flash against torn writes
+ */
+
+#ifndef MESHGRID_CRC16_H
+#define MESHGRID_CRC16_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * CRC of a buffer
+ * @param data Input buffer
+ * @param len Input length
+ * @return CRC-16/CCITT of the buffer
+ */
+uint16_t crc16_ccitt(const uint8_t* data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -17,62 +17,103 @@
      * Boards: T-Beam, T-LoRa V2.1, Nano G1, Station G1, RAK11200, etc. */
 #    define MAX_NEIGHBORS 50
 #    define MAX_CUSTOM_CHANNELS 10
-#    define PUBLIC_MESSAGE_BUFFER_SIZE 50
-#    define CHANNEL_MESSAGE_BUFFER_SIZE 3
-#    define DIRECT_MESSAGE_BUFFER_SIZE 25
+#    define MESSAGE_ARENA_SIZE 12288
+#    define PUBLIC_MESSAGE_BUFFER_SIZE 120
+#    define CHANNEL_MESSAGE_BUFFER_SIZE 10
+#    define DIRECT_MESSAGE_BUFFER_SIZE 60
 
 #elif defined(ARCH_ESP32S3)
 /* ESP32-S3 - More DRAM (~320KB usable)
      * Boards: T3S3, Heltec V3/V4, T-Beam Supreme, T-Deck, Station G2, etc. */
 #    define MAX_NEIGHBORS 512
 #    define MAX_CUSTOM_CHANNELS 50
-#    define PUBLIC_MESSAGE_BUFFER_SIZE 100
-#    define CHANNEL_MESSAGE_BUFFER_SIZE 5
-#    define DIRECT_MESSAGE_BUFFER_SIZE 50
+#    define MESSAGE_ARENA_SIZE 49152
+#    define PUBLIC_MESSAGE_BUFFER_SIZE 400
+#    define CHANNEL_MESSAGE_BUFFER_SIZE 16
+#    define DIRECT_MESSAGE_BUFFER_SIZE 200
 
 #elif defined(ARCH_ESP32C3)
 /* ESP32-C3 - Limited DRAM (~256KB usable)
      * Boards: Heltec HT62 */
 #    define MAX_NEIGHBORS 128
 #    define MAX_CUSTOM_CHANNELS 20
-#    define PUBLIC_MESSAGE_BUFFER_SIZE 75
-#    define CHANNEL_MESSAGE_BUFFER_SIZE 4
-#    define DIRECT_MESSAGE_BUFFER_SIZE 35
+#    define MESSAGE_ARENA_SIZE 24576
+#    define PUBLIC_MESSAGE_BUFFER_SIZE 200
+#    define CHANNEL_MESSAGE_BUFFER_SIZE 10
+#    define DIRECT_MESSAGE_BUFFER_SIZE 100
 
 #elif defined(ARCH_ESP32C6)
 /* ESP32-C6 - Similar to C3 (~256KB usable)
      * Boards: M5Stack Unit C6L */
 #    define MAX_NEIGHBORS 128
 #    define MAX_CUSTOM_CHANNELS 20
-#    define PUBLIC_MESSAGE_BUFFER_SIZE 75
-#    define CHANNEL_MESSAGE_BUFFER_SIZE 4
-#    define DIRECT_MESSAGE_BUFFER_SIZE 35
+#    define MESSAGE_ARENA_SIZE 24576
+#    define PUBLIC_MESSAGE_BUFFER_SIZE 200
+#    define CHANNEL_MESSAGE_BUFFER_SIZE 10
+#    define DIRECT_MESSAGE_BUFFER_SIZE 100
 
 #elif defined(ARCH_NRF52840)
 /* nRF52840 - Good DRAM (~256KB)
      * Boards: RAK4631, T-Echo, T1000E, Mesh Node T114, etc. */
 #    define MAX_NEIGHBORS 256
 #    define MAX_CUSTOM_CHANNELS 30
-#    define PUBLIC_MESSAGE_BUFFER_SIZE 80
-#    define CHANNEL_MESSAGE_BUFFER_SIZE 4
-#    define DIRECT_MESSAGE_BUFFER_SIZE 40
+#    define MESSAGE_ARENA_SIZE 32768
+#    define PUBLIC_MESSAGE_BUFFER_SIZE 250
+#    define CHANNEL_MESSAGE_BUFFER_SIZE 12
+#    define DIRECT_MESSAGE_BUFFER_SIZE 120
 
 #elif defined(ARCH_RP2040)
 /* RP2040 - Good DRAM (~264KB)
      * Boards: RAK11310, Pico, Pico W */
 #    define MAX_NEIGHBORS 256
 #    define MAX_CUSTOM_CHANNELS 30
-#    define PUBLIC_MESSAGE_BUFFER_SIZE 80
-#    define CHANNEL_MESSAGE_BUFFER_SIZE 4
-#    define DIRECT_MESSAGE_BUFFER_SIZE 40
+#    define MESSAGE_ARENA_SIZE 32768
+#    define PUBLIC_MESSAGE_BUFFER_SIZE 250
+#    define CHANNEL_MESSAGE_BUFFER_SIZE 12
+#    define DIRECT_MESSAGE_BUFFER_SIZE 120
 
 #else
 /* Conservative defaults for unknown platforms */
 #    define MAX_NEIGHBORS 50
 #    define MAX_CUSTOM_CHANNELS 10
-#    define PUBLIC_MESSAGE_BUFFER_SIZE 50
-#    define CHANNEL_MESSAGE_BUFFER_SIZE 3
-#    define DIRECT_MESSAGE_BUFFER_SIZE 25
+#    define MESSAGE_ARENA_SIZE 12288
+#    define PUBLIC_MESSAGE_BUFFER_SIZE 120
+#    define CHANNEL_MESSAGE_BUFFER_SIZE 10
+#    define DIRECT_MESSAGE_BUFFER_SIZE 60
+#endif
+
+/* ========================================================================= */
+/* Role Overrides (utils/role.h)                                            */
+/* ========================================================================= */
+
+#if defined(ROLE_REPEATER) || defined(ROLE_ROOM_SERVER)
+/* No channel chat: public and custom channel inboxes shrink to one ref,
+ * the channel table to one entry (arrays cannot be empty) */
+#    undef MAX_CUSTOM_CHANNELS
+#    undef PUBLIC_MESSAGE_BUFFER_SIZE
+#    undef CHANNEL_MESSAGE_BUFFER_SIZE
+#    define MAX_CUSTOM_CHANNELS 1
+#    define PUBLIC_MESSAGE_BUFFER_SIZE 1
+#    define CHANNEL_MESSAGE_BUFFER_SIZE 1
+#endif
+
+#if defined(ROLE_REPEATER)
+/* Nothing is addressed to a repeater that needs keeping */
+#    undef MESSAGE_ARENA_SIZE
+#    undef DIRECT_MESSAGE_BUFFER_SIZE
+#    define MESSAGE_ARENA_SIZE 512
+#    define DIRECT_MESSAGE_BUFFER_SIZE 1
+#elif defined(ROLE_ROOM_SERVER)
+/* The channel inbox budget goes to stored direct messages */
+#    undef MESSAGE_ARENA_SIZE
+#    undef DIRECT_MESSAGE_BUFFER_SIZE
+#    if defined(ARCH_ESP32)
+#        define MESSAGE_ARENA_SIZE 16384
+#        define DIRECT_MESSAGE_BUFFER_SIZE 300
+#    else
+#        define MESSAGE_ARENA_SIZE 40960
+#        define DIRECT_MESSAGE_BUFFER_SIZE 750
+#    endif
 #endif
 
 /* ========================================================================= */
@@ -88,6 +129,87 @@
 /* TX queue size */
 #define TX_QUEUE_SIZE 16
 
+/* RX FIFO depth (frames buffered between radio servicing and processing, power of 2) */
+#define RX_FIFO_SIZE 8
+
+/* Route cache: destinations, candidate paths each, outstanding ACKs */
+#define ROUTE_CACHE_SIZE 32
+#define ROUTE_CACHE_PATHS 3
+#define ROUTE_PENDING_ACKS 8
+
+/* Reachability: direct neighbors whose Bloom filters are kept */
+#define REACH_NEIGHBORS 16
+
+/* Multipoint relays: direct neighbors whose neighbor lists are kept */
+#define MPR_NEIGHBORS 16
+
+/* Geographic forwarding: node positions learned from adverts (one per known node) */
+#define GEO_NODES MAX_NEIGHBORS
+
+/* Flash message log (core/messaging/msg_log.h): segment files on the
+ * filesystem partition, a RAM write batch, and 4 index bytes per message */
+#if (defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)) && \
+    !defined(ROLE_REPEATER)
+#    define MSG_LOG_ENABLED 1
+#else
+#    define MSG_LOG_ENABLED 0
+#endif
+#define MSG_LOG_SEGMENT_SIZE 16384
+#define MSG_LOG_SEGMENTS 8
+#define MSG_LOG_BATCH_SIZE 2048
+#define MSG_LOG_FLUSH_MS 10000
+#if defined(ARCH_ESP32S3)
+#    define MSG_LOG_INDEX_SIZE 4096
+#else
+#    define MSG_LOG_INDEX_SIZE 2048
+#endif
+
+/* Neighbor snapshot: the most recently used neighbors saved to NVS as one
+ * 60-byte-per-entry blob (the 20 KB NVS partition is shared with config) */
+#if MAX_NEIGHBORS < 64
+#    define NEIGHBOR_SNAPSHOT_MAX MAX_NEIGHBORS
+#else
+#    define NEIGHBOR_SNAPSHOT_MAX 64
+#endif
+
+/* Node directory (core/node_dir.h): every node ever heard, 64 bytes each in
+ * one file on the filesystem partition; RAM keeps 5 bytes per slot. The
+ * neighbor table is the hot set paged in from it */
+#if defined(ARCH_ESP32) || defined(ARCH_ESP32S3) || defined(ARCH_ESP32C3) || defined(ARCH_ESP32C6)
+#    define NODE_DIR_ENABLED 1
+#else
+#    define NODE_DIR_ENABLED 0
+#endif
+#if defined(ARCH_ESP32S3)
+#    define NODE_DIR_CAPACITY 4096
+#elif defined(ARCH_ESP32)
+#    define NODE_DIR_CAPACITY 1024
+#else
+#    define NODE_DIR_CAPACITY 2048
+#endif
+#define NODE_DIR_PENDING 8 /* Record writes queued for the main loop */
+
+/* ========================================================================= */
+/* Boot Arena (utils/arena.h)                                               */
+/* ========================================================================= */
+
+/* Everything sized at boot is carved from two fixed regions, never freed:
+ *   hot  - internal SRAM: MeshCore objects, radio driver, per-packet tables
+ *   cold - bulk data read per message or query: inbox arena, message log
+ *          index, node directory index, neighbor snapshot buffer
+ * Cold data goes to PSRAM on boards built with BOARD_HAS_PSRAM; without it
+ * the SRAM region holds both. */
+#define ARENA_HOT_SIZE 12288
+#define ARENA_COLD_SIZE                                                                                     \
+    (MESSAGE_ARENA_SIZE + MSG_LOG_ENABLED * MSG_LOG_INDEX_SIZE * 4 + NODE_DIR_ENABLED * NODE_DIR_CAPACITY * 5 + \
+     8 + NEIGHBOR_SNAPSHOT_MAX * 60)
+
+#if defined(BOARD_HAS_PSRAM)
+#    define ARENA_SRAM_SIZE ARENA_HOT_SIZE
+#else
+#    define ARENA_SRAM_SIZE (ARENA_HOT_SIZE + ARENA_COLD_SIZE)
+#endif
+
 /* ========================================================================= */
 /* Compile-Time Memory Usage Estimation                                     */
 /* ========================================================================= */
@@ -95,19 +217,35 @@
 /*
  * Neighbor table: MAX_NEIGHBORS × ~100 bytes
  * Channel table: MAX_CUSTOM_CHANNELS × ~50 bytes
- * Message buffers:
- *   - Public: PUBLIC_MESSAGE_BUFFER_SIZE × ~100 bytes
- *   - Direct: DIRECT_MESSAGE_BUFFER_SIZE × ~100 bytes
- *   - Channels: MAX_CUSTOM_CHANNELS × CHANNEL_MESSAGE_BUFFER_SIZE × ~100 bytes
+ * Message inbox (core/messaging/inbox.h):
+ *   - Arena: MESSAGE_ARENA_SIZE, 16 bytes + sender + text per message
+ *   - Refs: 4 bytes per PUBLIC/DIRECT/CHANNEL_MESSAGE_BUFFER_SIZE entry
+ *     (the most messages one conversation keeps)
  * Log buffer: LOG_BUFFER_SIZE × ~50 bytes
  * Seen table: SEEN_TABLE_SIZE × 36 bytes
+ * RX FIFO: RX_FIFO_SIZE × ~264 bytes
+ * Route cache: ROUTE_CACHE_SIZE × ROUTE_CACHE_PATHS × ~24 bytes
+ * Reachability: REACH_NEIGHBORS × ~44 bytes
+ * Multipoint relays: MPR_NEIGHBORS × ~32 bytes
+ * Node positions: GEO_NODES × 20 bytes
+ * Message log: MSG_LOG_BATCH_SIZE + MSG_LOG_INDEX_SIZE × 4 bytes (index in the cold arena)
+ * Node directory: NODE_DIR_PENDING × 68 bytes + NODE_DIR_CAPACITY × 5 bytes (index in the cold arena)
+ * Neighbor snapshot: 8 + NEIGHBOR_SNAPSHOT_MAX × 60 bytes (cold arena)
+ * Config store: ~180 bytes + 2 × MAX_CUSTOM_CHANNELS × 50 bytes (image and channel staging)
+ * Boot arena: ARENA_SRAM_SIZE (message arena and both indexes included unless PSRAM)
  *
  * Estimated static RAM usage by platform:
- *   ESP32:     ~15 KB (fits in 160KB DRAM)
- *   ESP32-S3:  ~103 KB (fits in 320KB DRAM)
- *   ESP32-C3:  ~38 KB (fits in 256KB DRAM)
- *   nRF52840:  ~52 KB (fits in 256KB DRAM)
- *   RP2040:    ~52 KB (fits in 264KB DRAM)
+ *   ESP32:     ~47 KB (fits in 160KB DRAM)
+ *   ESP32-S3:  ~166 KB (fits in 320KB DRAM; ~77 KB with PSRAM)
+ *   ESP32-C3:  ~77 KB (fits in 256KB DRAM)
+ *   nRF52840:  ~71 KB (fits in 256KB DRAM)
+ *   RP2040:    ~71 KB (fits in 264KB DRAM)
+ *
+ * Message inbox and channel table by role (68-byte records: 40-char text):
+ *   Full/companion: ESP32 ~14 KB (~180 msgs), ESP32-S3 ~57 KB (~720 msgs),
+ *                   ESP32-C3/C6 ~28 KB (~360), nRF52840/RP2040 ~37 KB (~480)
+ *   Repeater:       < 1 KB on every platform
+ *   Room server:    ESP32 ~18 KB (~240 msgs), others ~44 KB (~600 msgs)
  */
 
 #endif /* MESHGRID_MEMORY_H */
@@ -0,0 +1,41 @@
+/**
+ * meshgrid-firmware Role Profiles
+ *
+ * Build-time node roles, selected per env in platformio.ini:
+ *   -DROLE_REPEATER     Relays only: headless, no chat decryption or inbox
+ *   -DROLE_COMPANION    Phone/CLI client: display, chat, full inbox
+ *   -DROLE_ROOM_SERVER  Headless store for direct messages, no channel chat
+ *
+ * No role flag builds everything (runtime CLIENT/REPEATER switch).
+ * Table sizes for each role are in memory.h.
+ */
+
+#ifndef MESHGRID_ROLE_H
+#define MESHGRID_ROLE_H
+
+#if defined(ROLE_REPEATER)
+#    define MESHGRID_ROLE_NAME "repeater"
+#    define MESHGRID_ROLE_MODE MODE_REPEATER /* Fixed - CLIENT mode would do nothing */
+#    define MESHGRID_ROLE_UI 0               /* Display screens and scroll buttons */
+#    define MESHGRID_ROLE_CHAT 0             /* Decrypt and keep channel traffic */
+
+#elif defined(ROLE_COMPANION)
+#    define MESHGRID_ROLE_NAME "companion"
+#    define MESHGRID_ROLE_MODE MODE_CLIENT
+#    define MESHGRID_ROLE_UI 1
+#    define MESHGRID_ROLE_CHAT 1
+
+#elif defined(ROLE_ROOM_SERVER)
+#    define MESHGRID_ROLE_NAME "room_server"
+#    define MESHGRID_ROLE_MODE MODE_CLIENT
+#    define MESHGRID_ROLE_UI 0
+#    define MESHGRID_ROLE_CHAT 0
+
+#else
+#    define MESHGRID_ROLE_NAME "full"
+#    define MESHGRID_ROLE_MODE MODE_CLIENT
+#    define MESHGRID_ROLE_UI 1
+#    define MESHGRID_ROLE_CHAT 1
+#endif
+
+#endif /* MESHGRID_ROLE_H */
@@ -0,0 +1,63 @@
+/**
+ * Single-producer / single-consumer ring indices
+ *
+ * Lock-free index pair for rings shared between exactly one producer and
+ * one consumer, which may run on different cores (radio task vs. loop()).
+ * The producer only writes head, the consumer only writes tail; acquire/
+ * release ordering makes the slot contents visible before the index moves.
+ *
+ * Storage is owned by the caller: slot = index & (size - 1), size must be
+ * a power of 2. Pure C with GCC atomics, so it also runs under pthreads.
+ */
+
+#ifndef MESHGRID_SPSC_H
+#define MESHGRID_SPSC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct spsc_index {
+    uint32_t head; /* Next slot to fill (producer) */
+    uint32_t tail; /* Next slot to drain (consumer) */
+};
+
+static inline uint32_t spsc_count(const struct spsc_index *q)
+{
+    return __atomic_load_n(&q->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+}
+
+/* Producer: slot index to fill, or -1 if full */
+static inline int32_t spsc_reserve(const struct spsc_index *q, uint32_t size)
+{
+    uint32_t head = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= size) {
+        return -1;
+    }
+    return (int32_t)(head & (size - 1));
+}
+
+/* Producer: publish the reserved slot */
+static inline void spsc_publish(struct spsc_index *q)
+{
+    __atomic_store_n(&q->head, __atomic_load_n(&q->head, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
+
+/* Consumer: slot index to read, or -1 if empty */
+static inline int32_t spsc_peek(const struct spsc_index *q, uint32_t size)
+{
+    uint32_t tail = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        return -1;
+    }
+    return (int32_t)(tail & (size - 1));
+}
+
+/* Consumer: release the slot returned by spsc_peek() */
+static inline void spsc_consume(struct spsc_index *q)
+{
+    __atomic_store_n(&q->tail, __atomic_load_n(&q->tail, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
+
+#endif /* MESHGRID_SPSC_H */
@@ -26,20 +26,6 @@ struct channel_entry {
     uint8_t secret[32];
 };
 
-/**
- * Message entry - inbox message storage
- */
-struct message_entry {
-    bool valid;
-    bool decrypted;
-    uint8_t sender_hash;
-    char sender_name[17];
-    uint8_t channel_hash;     /* 0 for direct message */
-    uint8_t protocol_version; /* 0=v0 (MeshCore), 1=v1 (meshgrid enhanced) */
-    uint32_t timestamp;
-    char text[128];
-};
-
 /**
  * Seen entry - packet deduplication table
  */